@@ -46,6 +46,25 @@ namespace GraderApplication
           std::string &inputFile, std::string &name);
 
 
+      /* NOTE: Documentation
+       * Pull a long option and its value out of argv
+       * before parseArguments sees it, eg: --what-if file.
+       * Both entries are removed and argc is shrunk so the
+       * positional -s / filename handling is untouched.
+       * returns true if the flag was found, a flag without
+       * a value prints usage and exits
+       * */
+      bool extractOption(int &argc, char **argv,
+          const char *flag, std::string &value);
+
+
+      /* NOTE: Documentation
+       * Same as extractOption, for a long option that
+       * takes no value, eg: --fixed-point
+       * */
+      bool extractFlag(int &argc, char **argv, const char *flag);
+
+
       /* NOTE: Documentation
        * Get userinput for file
        * */
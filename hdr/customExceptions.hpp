@@ -98,6 +98,26 @@ namespace GraderApplication
   };
 
 
+  class PolicyCategoryNotFound : public std::exception
+  {
+    public:
+      const char *what() const throw()
+      {
+        return "*** Policy names a category that is not in the CATEGORY line ***";
+      }
+  };
+
+
+  class PolicyOutOfBounds : public std::exception
+  {
+    public:
+      const char *what() const throw()
+      {
+        return "*** Policy must keep at least one and at most every mark in its category ***";
+      }
+  };
+
+
   class StudentIDEmpty : public std::exception
   {
     public:
@@ -106,6 +126,79 @@ namespace GraderApplication
         return "*** Student id field empty ***";
       }
   };
+
+
+  class HeaderIncomplete : public std::exception
+  {
+    public:
+      const char *what() const throw()
+      {
+        return "*** The header needs TITLE, CATEGORY, MAXMARK and WEIGHT lines ***";
+      }
+  };
+
+
+  class PolicyCrossesFiles : public std::exception
+  {
+    public:
+      const char *what() const throw()
+      {
+        return "*** A joined policy names a category another joined file also has ***";
+      }
+  };
+
+
+  /* NOTE: Documentation
+   * A header line the gradebook can not be graded with,
+   * thrown by EvaluationData::errorPrint once the message
+   * is written and caught by loadEvaluationData. Carries
+   * the message and the line it was on
+   */
+  class HeaderError : public std::exception
+  {
+    private:
+      std::string message;
+      int line;
+
+    public:
+      HeaderError(const std::string &_message, int _line)
+        : message(_message)
+          , line(_line)
+      { }
+
+      const char *what() const throw()
+      {
+        return message.c_str();
+      }
+
+      int lineNumber(void) const { return line; }
+  };
+
+
+  /* NOTE: Documentation
+   * A --where expression that can not be compiled,
+   * thrown by its parser and caught by RowFilter::compile.
+   * Carries the message and the character it was at
+   */
+  class FilterError : public std::exception
+  {
+    private:
+      std::string message;
+      std::size_t position;
+
+    public:
+      FilterError(const std::string &_message, std::size_t _position)
+        : message(_message)
+          , position(_position)
+      { }
+
+      const char *what() const throw()
+      {
+        return message.c_str();
+      }
+
+      std::size_t characterPosition(void) const { return position; }
+  };
 };
 
 #endif
@@ -0,0 +1,63 @@
+#ifndef DIFF_HPP
+#define DIFF_HPP
+
+#include "grader.hpp"
+
+
+/* NOTE: Documentation
+ * How a student differs between two gradebooks
+ * */
+enum DiffChange
+{
+  DIFF_ADDED,
+  DIFF_REMOVED,
+  DIFF_CHANGED
+};
+
+
+/* NOTE: Documentation
+ * One student in a diff, before is nullptr for an
+ * added student and after for a removed one
+ * */
+struct DiffRow
+{
+  DiffChange change;
+  const StudentData *before;
+  ContainerSection beforeSection;
+  const StudentData *after;
+  ContainerSection afterSection;
+};
+
+
+/* NOTE: Documentation
+ * Hash join the two graded Containers on student id.
+ * An id is matched by the row searchStudent would find,
+ * graded before withdrawn before error, the last of a
+ * section. A student is changed if its section, letter
+ * or any of the five scores differs, to the bit, or for
+ * an error row if its line or its error does.
+ *
+ * Changed and added students come in the new order,
+ * then removed students in the old order. The number of
+ * students that did not change is returned
+ * */
+long diffContainers(const Container &before, const Container &after, std::vector<DiffRow> &rows);
+
+
+/* NOTE: Documentation
+ * --diff: load and grade both gradebooks, each on a
+ * thread of its own, then write every added, removed and
+ * changed student. A changed graded student shows how
+ * much each score moved, with its sign, and its letter
+ * before -> after, any other row the scores it has now.
+ * A count of each kind ends the report.
+ *
+ * false if either gradebook could not be graded, its
+ * diagnostics are written to std::cerr either way, the
+ * old gradebook's first
+ * */
+bool diffGradebooks(const std::string &oldFile, const std::string &newFile, bool fixedPoint,
+    int threads, std::ostream &out);
+
+
+#endif
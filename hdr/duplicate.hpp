@@ -0,0 +1,86 @@
+#ifndef DUPLICATE_HPP
+#define DUPLICATE_HPP
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace GraderApplication
+{
+  /* Slots per cuckoo bucket, four 64 bit slots fill half a cache line */
+#define DUPLICATE_BUCKET 4
+
+  /* Evictions tried before an entry goes to the stash */
+#define DUPLICATE_MAX_KICKS 500
+
+  /* Low bits of a slot hold the byte offset of the line, 1 TB of file */
+#define DUPLICATE_OFFSET_BITS 40
+
+
+  /* NOTE: Documentation
+   * Duplicate student line detection in about 9 bytes a
+   * student. Each line is hashed to 64 bits, which picks two
+   * candidate buckets of a cuckoo table and a 24 bit
+   * fingerprint. A slot is one 64 bit word, the fingerprint
+   * above the byte offset of the line in the file, so the
+   * table never holds any text.
+   *
+   * A fingerprint match is only a suspect, it is confirmed
+   * by reading the earlier line back from its offset and
+   * comparing the comment stripped lines in full, so the
+   * first occurrence always wins and a false positive can
+   * never drop a student.
+   *
+   * The table is sized once for the expected number of
+   * lines, anything that cannot be placed goes to a small
+   * stash that is searched linearly
+   * */
+  class DuplicateFilter
+  {
+    private:
+      struct alignas(32) Bucket
+      {
+        std::uint64_t slot[DUPLICATE_BUCKET];
+      };
+
+      /* an entry that found no slot, with one of its buckets */
+      struct StashEntry
+      {
+        std::uint32_t fp;
+        std::size_t bucket;
+        std::uint64_t offset;
+      };
+
+      std::vector<Bucket> buckets;
+      std::vector<StashEntry> stash;
+      std::unique_ptr<std::istream> confirm;
+      std::uint32_t victim;
+
+      std::size_t altBucket(std::size_t, std::uint32_t) const;
+      bool confirmLine(std::uint64_t, const std::string &);
+      bool place(std::size_t, std::uint64_t);
+
+    public:
+      /* NOTE: Documentation
+       * input is re-read to confirm suspects, expected is
+       * the number of lines that will be tested
+       * */
+      DuplicateFilter(std::unique_ptr<std::istream>, int);
+
+      DuplicateFilter(const DuplicateFilter &) = delete;
+      DuplicateFilter& operator=(const DuplicateFilter &) = delete;
+
+
+      /* NOTE: Documentation
+       * true if an identical stripped line was seen before,
+       * otherwise the line is recorded at offset and false
+       * is returned
+       * */
+      bool testAndInsert(const std::string &stripped, std::streamoff offset);
+  };
+};
+
+#endif
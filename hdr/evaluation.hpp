@@ -2,12 +2,27 @@
 #define EVALUATION_HPP
 
 #include <fstream>
+#include <memory>
 #include <vector>
+#include "input.hpp"
 #include "utillity.hpp"
 
 
 namespace GraderApplication
 {
+  /* NOTE: Documentation
+   * What loading a gradebook came to. Nothing that goes
+   * wrong with one gradebook ends the process, the caller
+   * decides from the status
+   * */
+  enum LoadStatus
+  {
+    LOAD_OK,
+    LOAD_NOT_FOUND,
+    LOAD_BAD_HEADER
+  };
+
+
   /* NOTE: Documentation
    * EvaluationData is responsible for all prelim data
    * it also houses alot of base functionality for 
@@ -24,6 +39,7 @@ namespace GraderApplication
   {
     private:
       std::string dataFile;
+      std::shared_ptr<const MappedInput> decompressed;
       int totalHeaderCount;
       int dataLineLength;
       int totalLineCount;
@@ -36,6 +52,19 @@ namespace GraderApplication
       std::vector <float> maxMarkContainer;
       std::string weight;
       std::vector <float> weightContainer;
+      std::vector <std::int64_t> fixedMaxMarkContainer;
+      std::vector <std::int64_t> fixedWeightContainer;
+      bool fixedPoint;
+      int threads;
+      std::vector <std::string> policyCategoryContainer;
+      std::vector <int> policyDropContainer;
+      std::vector <int> columnPolicyContainer;
+      std::vector <std::string> categoryNameContainer;
+      std::vector <int> columnCategoryContainer;
+      std::ostream *diagnostics;
+      LoadStatus status;
+      std::string loadError;
+      std::string currentLine;
 
     public:
       /* NOTE: Documentation
@@ -45,6 +74,12 @@ namespace GraderApplication
        * */
       EvaluationData(const std::string &);
 
+      /* NOTE: Documentation
+       * A gradebook already in memory, the name is only
+       * used in messages. Nothing is read from disk
+       * */
+      EvaluationData(const std::string &, std::shared_ptr<const MappedInput>);
+
       /* NOTE: Documentation
          Deconstructor will be responsible
          for santizing our temp file.. hopefully
@@ -57,6 +92,24 @@ namespace GraderApplication
        * */
       std::string evaluationFile(void) const;
 
+
+      /* NOTE: Documentation
+       * A fresh stream at the start of the gradebook. A gzip
+       * or zstd file is decompressed once, by the first call,
+       * and every stream after reads the same decompressed
+       * copy. The stream is failed if the file can not be
+       * opened or decompressed
+       * */
+      std::unique_ptr<std::istream> openInput(void);
+
+
+      /* NOTE: Documentation
+       * Accessor: true if every stream reads the plain
+       * file itself, false for a compressed gradebook or
+       * one handed over in memory
+       * */
+      bool evaluationOnDisk(void) const;
+
       /* NOTE: Documentation
        * Return the total header count
        * This will be used to compare against
@@ -92,7 +145,7 @@ namespace GraderApplication
        * methods without have to read from the beginning of the file
        * */
       std::streampos currentFilePosition(void) const;
-      void setCurrentFilePosition(std::ifstream &);
+      void setCurrentFilePosition(std::istream &);
 
 
       /* NOTE: Documentation
@@ -117,7 +170,9 @@ namespace GraderApplication
 
 
       /* NOTE: Documentation
-       * Accessor: getter and setter for category container
+       * Accessor: getter and setter for category container,
+       * the column getters throw std::out_of_range past the
+       * last column
        * */
       std::string evaluationCategoryContainer(int);
       void setEvaluationCategoryContainer(const std::string &);
@@ -137,6 +192,39 @@ namespace GraderApplication
       void setEvaluationMaxMarkContainer(std::string &);
 
 
+      /* NOTE: Documentation
+       * Accessor: every max mark at once, in column
+       * order, for checking a whole row in one pass
+       * */
+      const std::vector<float> &evaluationMaxMarks(void) const;
+
+
+      /* NOTE: Documentation
+       * Accessor: max marks and weights in thousandths,
+       * parsed straight from the header text for --fixed-point
+       * */
+      const std::vector<std::int64_t> &evaluationFixedMaxMarks(void) const;
+      const std::vector<std::int64_t> &evaluationFixedWeights(void) const;
+
+
+      /* NOTE: Documentation
+       * Accessor: getter and setter for --fixed-point,
+       * set before loading students so their marks are
+       * kept in thousandths as well
+       * */
+      bool evaluationFixedPoint(void) const;
+      void setEvaluationFixedPoint(bool);
+
+
+      /* NOTE: Documentation
+       * Accessor: getter and setter for --threads, how
+       * many threads grade the students and reduce the
+       * class wide sums, 1 unless asked for
+       * */
+      int evaluationThreads(void) const;
+      void setEvaluationThreads(int);
+
+
       /* NOTE: Documentation
        * Accessor: getter and setter for weight
        * */
@@ -151,17 +239,85 @@ namespace GraderApplication
       void setEvaluationWeightContainer(std::string &);
 
 
+      /* NOTE: Documentation
+       * Accessor: getter and setter for the DROP / BEST
+       * category policies. The setter takes the keyword,
+       * the category and the count as read from the line,
+       * and stores how many of the lowest marks in the
+       * category are dropped, so BEST 3 of 4 is stored as
+       * a drop of 1. The CATEGORY line must come first
+       * */
+      int evaluationPolicyCount(void) const;
+      std::string evaluationPolicyCategory(int) const;
+      int evaluationPolicyDrop(int) const;
+      void setEvaluationPolicy(const std::string &, const std::string &, std::string &);
+
+
+      /* NOTE: Documentation
+       * Accessor: the index of the policy that governs
+       * evaluation column itr, or -1 if its category is
+       * summed straight through
+       * */
+      int evaluationColumnPolicy(int) const;
+
+
+      /* NOTE: Documentation
+       * Accessor: the index of evaluation column itr's
+       * category among the distinct CATEGORY names, in the
+       * order they first appear, and how many there are.
+       * Weights are renormalized within these groups
+       * */
+      int evaluationColumnCategory(int) const;
+      int evaluationCategoryCount(void) const;
+
+
+      /* NOTE: Documentation
+       * Where warnings and header errors are written while
+       * the gradebook is loaded, std::cerr unless the
+       * caller hands over a stream of its own
+       * */
+      std::ostream &evaluationDiagnostics(void) const;
+      void setEvaluationDiagnostics(std::ostream &);
+
+
+      /* NOTE: Documentation
+       * The header line being read, for error reporting.
+       * An empty line leaves the previous one in place
+       * */
+      const std::string &currentLineContent(void) const;
+      void setCurrentLineContent(const std::string &);
+
+
       /* NOTE: Documentation
        * Load only preliminary data from file:
        * reads data based on first character matches
        * from a predefined enumerator in settings.h
+       *
+       * DROP and BEST lines directly after the header are
+       * consumed as part of it, so the file position handed
+       * to the student loader is past the last policy.
+       *
+       * A missing file or a rejected header line is written
+       * to the diagnostics stream and returned, the students
+       * of a gradebook that is not LOAD_OK are never read
+       * */
+      LoadStatus loadEvaluationData(void);
+
+
+      /* NOTE: Documentation
+       * Accessor: the status of the last load, and what
+       * was wrong with the gradebook with its line number,
+       * empty for LOAD_OK
        * */
-      void loadEvaluationData(void);
+      LoadStatus evaluationStatus(void) const;
+      const std::string &evaluationError(void) const;
 
 
       /* NOTE: Documentation
        * error print will in all output from
-       * exceptions for BaseData class only
+       * exceptions for BaseData class only, then
+       * throws HeaderError, which loadEvaluationData
+       * turns into LOAD_BAD_HEADER
        * */
       void errorPrint(const char *);
   };
@@ -0,0 +1,151 @@
+#ifndef FILTER_HPP
+#define FILTER_HPP
+
+#include <cstdint>
+#include "grader.hpp"
+
+
+/* Rows a filter program runs over at once, a multiple of 64
+ * so every batch fills whole words of a selection bitmap
+ * */
+#define FILTER_BATCH 256
+#define FILTER_WORDS (FILTER_BATCH / 64)
+
+
+/* NOTE: Documentation
+ * One instruction of a compiled --where expression. The
+ * program is postfix: number ops push a batch of floats,
+ * test ops push a batch of bits, and every op pops what
+ * it reads. arg is a TITLE column for FILTER_MARK, a
+ * FilterScore for FILTER_SCORE and a mask of LetterGrade
+ * bits for FILTER_LETTER_IN. value is a FILTER_CONST
+ * */
+enum FilterOpCode
+{
+  FILTER_MARK,
+  FILTER_SCORE,
+  FILTER_CONST,
+  FILTER_ADD,
+  FILTER_SUB,
+  FILTER_MUL,
+  FILTER_DIV,
+  FILTER_NEG,
+  FILTER_LT,
+  FILTER_LE,
+  FILTER_GT,
+  FILTER_GE,
+  FILTER_EQ,
+  FILTER_NE,
+  FILTER_LETTER_IN,
+  FILTER_WDR,
+  FILTER_ERROR,
+  FILTER_AND,
+  FILTER_OR,
+  FILTER_NOT
+};
+
+
+/* The report columns a FILTER_SCORE reads */
+enum FilterScore
+{
+  FILTER_LAB,
+  FILTER_ASSIGN,
+  FILTER_MIDTERM,
+  FILTER_FINAL,
+  FILTER_TOTAL
+};
+
+
+struct FilterOp
+{
+  FilterOpCode code;
+  std::uint32_t arg;
+  float value;
+};
+
+
+/* NOTE: Documentation
+ * Which rows of each Container section were selected,
+ * bit i of word i / 64 for row i
+ * */
+struct FilterSelection
+{
+  std::vector<std::uint64_t> graded;
+  std::vector<std::uint64_t> wdr;
+  std::vector<std::uint64_t> error;
+
+  static bool selected(const std::vector<std::uint64_t> &bits, std::size_t i)
+  {
+    return (bits[i / 64] >> (i % 64)) & 1;
+  }
+};
+
+
+/* NOTE: Documentation
+ * --where: a row selection over the graded Container.
+ *
+ *   names    a TITLE column is that mark as read, lab,
+ *            assign, midterm, final and total are the report
+ *            columns, so is a CATEGORY name (Lab, Assign,
+ *            Midterm, Final) that is not also a TITLE
+ *   numbers  + - * / and unary -, compared with
+ *            < <= > >= == !=
+ *   letters  letter == B+, letter != F, letter in (D, F)
+ *   flags    wdr and error, true for those rows
+ *   logic    && || ! and parentheses
+ *
+ * A TITLE that is not a plain name, Lab-1 say, is
+ * written in backquotes: `Lab-1` > 5.
+ * Lower case names are looked up first. Values are
+ * compared unrounded, as the letter grade is. A withdrawn
+ * or error row has no numbers, every comparison on it is
+ * false and its letter is WITHDRAWN or none.
+ *
+ * The expression is parsed once into a postfix program,
+ * with its types checked, and the program then runs over
+ * FILTER_BATCH rows at a time: each number op fills a
+ * column of floats, each test a run of bitmap words, so
+ * every op is a plain loop over one batch
+ * */
+class RowFilter
+{
+  private:
+    std::vector<FilterOp> program;
+    int numberDepth;
+    int bitsDepth;
+    std::string compileError;
+
+    /* run the program over rows [begin, end) of one section, at most
+     * one batch, into out. numbers and tests are the two stacks
+     * */
+    void selectRows(const StudentVector &, ContainerSection, std::size_t begin,
+        std::size_t end, float *numbers, std::uint64_t *tests, std::uint64_t *out) const;
+
+  public:
+    RowFilter(void);
+
+
+    /* NOTE: Documentation
+     * Parse and check the expression against the header
+     * of e. On a mistake false is returned and error says
+     * what and where
+     * */
+    bool compile(const std::string &expression, EvaluationData &e);
+    const std::string &error(void) const;
+
+
+    /* NOTE: Documentation
+     * Every row of every section, on threads threads
+     * */
+    void select(const Container &, int threads, FilterSelection &) const;
+};
+
+
+/* NOTE: Documentation
+ * Write only the selected rows through the writer,
+ * graded, then withdrawn, then errors
+ * */
+void outputSelected(const Container &, const FilterSelection &, OutputWriter &);
+
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef FIXEDPOINT_HPP
+#define FIXEDPOINT_HPP
+
+#include "grader.hpp"
+
+
+/* Weighted marks are summed in units of 10^-12 of a
+ * percentage point, a full 100 is 10^14 units
+ * */
+#define FIXED_UNIT 1000000000000LL
+
+/* Units in one hundredth of a point, what a total rounds to */
+#define FIXED_HUNDREDTH (FIXED_UNIT / 100)
+
+
+/* NOTE: Documentation
+ * --fixed-point: makeGrades on integers. Every mark,
+ * max mark and weight is an exact count of thousandths
+ * (FIXED_SCALE), and each column has one integer factor,
+ * units per thousandth of a mark, rounded once:
+ *
+ *   factor = weight * FIXED_UNIT / (FIXED_SCALE * maxmark)
+ *
+ * so a row is an integer multiply per mark and integer
+ * sums, which the compiler can vectorize and which come
+ * out the same in any order. The rounding of a factor is
+ * at most half a unit per thousandth of a mark, far below
+ * a hundredth of a point. Category scores and the total are
+ * rounded half up to hundredths before assignLetterGrade,
+ * so the letter always agrees with the printed total.
+ *
+ * DROP / BEST rescale a kept mark by category weight over
+ * kept weight, also in integers, rounded per column
+ * */
+void makeFixedGrades(EvaluationData &, Container &, OutputWriter *);
+
+
+#endif
@@ -1,8 +1,12 @@
 #ifndef GRADER_HPP
 #define GRADER_HPP
 
+#include <iostream>
 #include <iterator>
+#include <memory>
 #include "../hdr/evaluation.hpp"
+#include "../hdr/lineindex.hpp"
+#include "../hdr/reduce.hpp"
 #include "../hdr/student.hpp"
 
 using namespace GraderApplication;
@@ -10,6 +14,20 @@ using namespace GraderApplication;
 /* Change template mess, for readabillity */
 using StudentVector = std::vector<StudentData>;
 
+class OutputWriter;
+
+
+/* NOTE: Documentation
+ * Which of the three Container vectors a
+ * student ended up in
+ * */
+enum ContainerSection
+{
+  GRADED_SECTION,
+  WDR_SECTION,
+  ERROR_SECTION
+};
+
 
 /* NOTE: Documentation
  * Since Most of the code in grader.cc
@@ -43,6 +61,13 @@ struct Container
     StudentVector error;
     StudentVector wdr;
 
+    /* NOTE: Documentation
+     * One flag per mark of every graded student, row major,
+     * 0 when a category policy dropped the mark. Filled in
+     * by makeGrades through selectKeptMarks
+     * */
+    std::vector<unsigned char> markMask;
+
 
     /* NOTE: Documentation
      * Explicit Constructor
@@ -80,39 +105,66 @@ struct Container
  * the evaluation data first, so it can accurately
  * jump to only the student data. thus resulting
  * in an accurate ammount of students
+ *
+ * With a fresh index the count is read from it
+ * and the student lines are not read at all
+ * */
+int countStudentLines(EvaluationData &);
+
+
+/* NOTE: Documentation
+ * load our vector of student objects. A gradebook that
+ * can not be read is written to the evaluation
+ * diagnostics and comes back as LOAD_NOT_FOUND, the
+ * caller decides whether that ends the run
  * */
-int countStudentLines(const EvaluationData &);
+LoadStatus loadStudentContainers(EvaluationData &, Container &);
 
 
 /* NOTE: Documentation
- * load our vector of student objects
+ * -s with a fresh index: load only the rows the index
+ * finds for the id, so searchStudent over the Container
+ * finds the same student as over the whole gradebook.
+ * Every repeat of a line shares its id, so repeated
+ * lines are still dropped
  * */
-void loadStudentContainers(EvaluationData &, Container &);
+LoadStatus loadIndexedStudent(EvaluationData &, const LineIndex &, const std::string &, Container &);
 
 
 /* NOTE: Documentation
- * Search for student by specified name
+ * Search for student by specified name. The last
+ * match among the graded wins, then the withdrawn,
+ * then the errors. nullptr if there is no such student
  * */
-StudentData searchStudent(const Container &, const std::string &);
+const StudentData *searchStudent(const Container &, const std::string &);
+
+
+/* NOTE: Documentation
+ * The student not found message, for a search
+ * that came back empty
+ * */
+void outputNotFound(const std::string &);
 
 
 /* NOTE: Documentation
  * the meat of this class, 2 C style for loops.
- * depends on a few helper functions
- * to properly perform computations on the grade data
+ * Any DROP / BEST policies are applied first, the
+ * dropped marks count as 0 and the kept marks in that
+ * category are scaled up to the full category weight.
+ * If a writer is given each student is written out
+ * as soon as it is graded. A row is graded by the
+ * rowKernel for the column count, see kernel.hpp
  * */
-void makeGrades(EvaluationData &e, Container &c);
+void makeGrades(EvaluationData &e, Container &c, OutputWriter *writer = nullptr);
 
 
 /* NOTE: Documentation
- * Helper method of makeGrades, takes in standard i, j
- * C style for loop integers, so it can calculate all grades
- * for each student, against the weight and maxmark
- *
- * Called from within makeGrades inner for loop since it needs
- * to calculate an array being stored in a vector
+ * The KernelCategory of every column, from its header
+ * category, worked out once per gradebook. Shared by
+ * makeGrades and makeFixedGrades so the report columns
+ * can not drift apart
  * */
-float subGradeComputation(EvaluationData &, Container &, int , int );
+std::vector<int> reportCategories(EvaluationData &);
 
 
 /* NOTE: Documentation
@@ -121,39 +173,57 @@ float subGradeComputation(EvaluationData &, Container &, int , int );
  * a lettergrade representation held in the Echelon
  * struct also defined in settings.h
  *
- * called from makeGrades outer forloop
+ * called from makeGrades outer forloop. assignLetter
+ * gives the LetterGrade a student record keeps,
+ * assignLetterGrade its text
  * */
+LetterGrade assignLetter(float);
 std::string assignLetterGrade(float);
 
 
+/* NOTE: Documentation
+ * Column titles and a single student row of the
+ * fixed width table, shared by every table output
+ * */
+void outputHeader(std::ostream &);
+void outputRow(const StudentData &, std::ostream &);
+
+
 /* NOTE: Documentation
  * Final output method after all grades, are computed,
  * rounded, and stored in StudentContainer Vector
  *
  * Overloaded to output single student
  * */
-void outputStudent(const Container &);
+void outputStudent(const Container &, std::ostream &out = std::cout);
 void outputStudent(const StudentData &);
 
 
 /* NOTE: Documentation
  * Output all students who are withdrawn
  * */
-void outputWDR(const Container &);
+void outputWDR(const Container &, std::ostream &out = std::cout);
 
 
 /* NOTE: Documentation
  * Output all the student error lines that were
  * perserved allong the way
+ *
+ * outputErrorEntry prints a single one
  * */
+void outputErrorEntry(const StudentData &, std::ostream &);
 void outputError(const Container &);
 
 
 /* NOTE: Documentation
- * Clean up the temp file
- * we have been operating on
- */
-void sanitize(void);
+ * --stats and the server STATS answer: section counts,
+ * mean, min and max of the totals and how many got each
+ * letter. The mean is a deterministicSum over the given
+ * number of threads, printed with every digit it has so
+ * it can be compared bit for bit
+ * */
+void outputStats(const Container &, int threads, std::ostream &);
+
 
 
 #endif
@@ -0,0 +1,112 @@
+#ifndef INPUT_HPP
+#define INPUT_HPP
+
+#include <cstdio>
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <string>
+
+
+namespace GraderApplication
+{
+  /* Size of a decompressed gzip block handed down the pipeline */
+#define INPUT_BLOCK (1 << 20)
+
+  /* Decompressed blocks allowed in flight per worker */
+#define INPUT_QUEUE_DEPTH 4
+
+
+  /* NOTE: Documentation
+   * Compression is recognised by the leading magic
+   * bytes of the file, never by its extension
+   * */
+  enum InputCompression
+  {
+    PLAIN_INPUT,
+    GZIP_INPUT,
+    ZSTD_INPUT
+  };
+
+  InputCompression inputCompression(const std::string &);
+
+
+  /* NOTE: Documentation
+   * A compressed gradebook decompressed once into an
+   * unlinked temporary file, and mapped read only. Every
+   * reader of the gradebook seeks around by byte offset,
+   * so they all read this one mapping as if it were the
+   * plain file, and the kernel can page it back out.
+   *
+   * Decompression is a pipeline, the decompressing threads
+   * hand finished blocks to the calling thread in order,
+   * which writes them out. gzip has one decompressing
+   * thread and INPUT_BLOCK sized blocks, a zstd file is
+   * split at its frame boundaries and the frames are
+   * decompressed in parallel, a whole frame at a time.
+   *
+   * A gradebook handed over in memory is copied as it is
+   * if it is plain text, or decompressed the same way. A
+   * temporary file some other step wrote the gradebook to
+   * is adopted, closed with the MappedInput, and mapped
+   * */
+  class MappedInput
+  {
+    private:
+      std::FILE *spool;
+      const char *mapped;
+      std::size_t length;
+      std::string problem;
+      std::string copy;
+
+      void decompressGzip(const unsigned char *, std::size_t);
+      void decompressZstd(const unsigned char *, std::size_t);
+      void mapSpool(void);
+
+    public:
+      MappedInput(const std::string &, InputCompression);
+      MappedInput(const char *, std::size_t);
+      explicit MappedInput(std::FILE *);
+      ~MappedInput(void);
+
+      MappedInput(const MappedInput &) = delete;
+      MappedInput& operator=(const MappedInput &) = delete;
+
+      const char *data(void) const { return mapped; }
+      std::size_t size(void) const { return length; }
+
+      /* empty unless decompression failed */
+      const std::string &error(void) const { return problem; }
+  };
+
+
+  /* NOTE: Documentation
+   * Read only, seekable stream buffer over memory
+   * */
+  class MemoryStreamBuf : public std::streambuf
+  {
+    protected:
+      pos_type seekoff(off_type, std::ios_base::seekdir, std::ios_base::openmode) override;
+      pos_type seekpos(pos_type, std::ios_base::openmode) override;
+
+    public:
+      MemoryStreamBuf(const char *, std::size_t);
+  };
+
+
+  /* NOTE: Documentation
+   * An istream over a MappedInput, holding on to it
+   * so the mapping outlives every reader
+   * */
+  class MemoryStream : public std::istream
+  {
+    private:
+      std::shared_ptr<const MappedInput> input;
+      MemoryStreamBuf buffer;
+
+    public:
+      explicit MemoryStream(std::shared_ptr<const MappedInput>);
+  };
+};
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef JOIN_HPP
+#define JOIN_HPP
+
+#include <cstdio>
+#include "grader.hpp"
+
+
+/* Input bytes a join partition is sized for, one partition is held at once */
+#define JOIN_PARTITION_BYTES (8 << 20)
+
+/* Most partitions a join spreads its rows over */
+#define JOIN_MAX_PARTITIONS 256
+
+
+/* NOTE: Documentation
+ * --join: several gradebooks for the same class, each
+ * with its own header, merged into one gradebook keyed by
+ * student id. The TITLE, CATEGORY, MAXMARK and WEIGHT
+ * lines are concatenated in file order, with each file's
+ * DROP / BEST lines after them, and a student's row is
+ * its id and then its marks from every file in the same
+ * order. The joined header is checked as a whole, so the
+ * WEIGHT lines together must add up to 100.
+ *
+ * A policy applies to every column of its category in the
+ * joined header, so a file's DROP / BEST line is only
+ * joined if no other file has a column in that category,
+ * it then reaches that file's columns alone. Otherwise,
+ * two files that each drop a Lab included, the join is
+ * refused naming both files, as is a policy on a category
+ * its own file does not have.
+ *
+ * Students come out in the order they first appear, the
+ * first file's order, then ids only a later file has. An
+ * id some files lack is reported for each of them and
+ * its row is joined without those marks, which makes it
+ * an error row in the report. A repeated id in one file
+ * keeps its first row.
+ *
+ * The join is a partitioned hash join, linear in the
+ * input. Every row is written to one of up to
+ * JOIN_MAX_PARTITIONS temporary files by a hash of its
+ * id, so each id lands in one partition. A partition at
+ * a time is read back and joined through a hash table,
+ * its rows come out in first appearance order into a run
+ * file, and the runs are merged by that order. Only one
+ * partition, about JOIN_PARTITION_BYTES of input, is in
+ * memory at once, the joined gradebook itself is written
+ * to a temporary file and mapped
+ * */
+class GradebookJoin
+{
+  private:
+    const std::vector<std::string> &files;
+    std::ostream &diagnostics;
+    std::vector<std::FILE *> partitions;
+    std::vector<std::FILE *> runs;
+
+    /* a DROP / BEST line and the file it came from */
+    struct FilePolicy
+    {
+      std::uint32_t file;
+      std::string category;
+      std::string line;
+    };
+
+    /* the CATEGORY line of every file */
+    std::vector<std::vector<std::string>> categories;
+
+    /* each file's header into the joined one, its rows into the partitions */
+    bool partitionFile(std::uint32_t f, std::string header[], std::vector<FilePolicy> &policies);
+
+    /* every policy reaches its own file's columns alone */
+    bool checkPolicies(const std::vector<FilePolicy> &policies);
+
+    /* one partition joined into its run */
+    bool joinPartition(std::size_t p);
+
+    /* the runs merged into the joined gradebook */
+    bool mergeRuns(std::FILE *out);
+
+  public:
+    GradebookJoin(const std::vector<std::string> &, std::ostream &);
+    ~GradebookJoin(void);
+
+    GradebookJoin(const GradebookJoin &) = delete;
+    GradebookJoin& operator=(const GradebookJoin &) = delete;
+
+
+    /* NOTE: Documentation
+     * The joined gradebook, for an EvaluationData. nullptr,
+     * with the reason in diagnostics, if a file could not
+     * be read or its header is incomplete
+     * */
+    std::shared_ptr<const MappedInput> join(void);
+};
+
+
+#endif
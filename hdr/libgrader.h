@@ -0,0 +1,150 @@
+#ifndef LIBGRADER_H
+#define LIBGRADER_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* NOTE: Documentation
+ * libgrader: the grader as a library, for programs that
+ * would otherwise run bin/grader and read its output.
+ * Build with make lib, link lib/libgrader.a or
+ * lib/libgrader.so (the static library also needs -lz
+ * -pthread, and -lzstd when built with ZSTD=1).
+ *
+ * A book is one gradebook, loaded from a path or from
+ * memory, graded, then read back row by row or looked
+ * up by student id. Nothing here calls exit, writes to
+ * stdout or stderr, or touches the working directory,
+ * every problem comes back as a grader_status.
+ *
+ * Only plain C types cross the boundary, so the API is
+ * the same from C and C++. New calls may be added, the
+ * ones here keep their meaning, see GRADER_API_VERSION
+ * */
+#define GRADER_API_VERSION 1
+
+#if defined(__GNUC__)
+#define GRADER_API __attribute__((visibility("default")))
+#else
+#define GRADER_API
+#endif
+
+
+/* NOTE: Documentation
+ * Returned by every call that can fail
+ * */
+typedef enum grader_status
+{
+  GRADER_OK = 0,
+  GRADER_NOT_FOUND,       /* no file, or it could not be read or decompressed */
+  GRADER_BAD_HEADER,      /* the header was rejected, see grader_error */
+  GRADER_NOT_GRADED,      /* results asked for before grader_grade */
+  GRADER_NO_STUDENT,      /* grader_find found no such id */
+  GRADER_BAD_ARGUMENT,    /* a null pointer, or an index past the end */
+  GRADER_FAILED           /* out of memory, or anything else unexpected */
+} grader_status;
+
+
+/* NOTE: Documentation
+ * Options for the grader_open calls, or'd together
+ * */
+#define GRADER_FIXED_POINT 1u   /* grade as --fixed-point does */
+
+
+/* NOTE: Documentation
+ * Which part of the report a row belongs to, rows come
+ * graded first, then withdrawn, then errors
+ * */
+typedef enum grader_section
+{
+  GRADER_GRADED = 0,
+  GRADER_WITHDRAWN,
+  GRADER_ERROR
+} grader_section;
+
+
+/* NOTE: Documentation
+ * One row of the report. The strings belong to the
+ * book and stay valid until grader_close. letter is
+ * "WITHDRAWN" for a withdrawn student and empty for an
+ * error, error is only set for an error row. Scores are
+ * not rounded, the report prints them to the hundredth
+ * */
+typedef struct grader_result
+{
+  const char *id;
+  grader_section section;
+  int line;
+  float lab;
+  float assign;
+  float midterm;
+  float final_exam;
+  float total;
+  const char *letter;
+  const char *error;
+} grader_result;
+
+
+typedef struct grader_book grader_book;
+
+
+/* NOTE: Documentation
+ * GRADER_API_VERSION of the library actually loaded
+ * */
+GRADER_API int grader_api_version(void);
+
+
+/* NOTE: Documentation
+ * Load a gradebook, header and students, from a file
+ * (plain, gzip or zstd) or from size bytes of memory,
+ * which are copied. *book is set whenever the call
+ * returns anything but GRADER_BAD_ARGUMENT, so the
+ * reason can be read with grader_error, and must be
+ * given back to grader_close
+ * */
+GRADER_API grader_status grader_open_file(const char *path, unsigned options, grader_book **book);
+GRADER_API grader_status grader_open_buffer(const char *data, size_t size, unsigned options,
+    grader_book **book);
+
+
+/* NOTE: Documentation
+ * Grade every student on threads threads (1 to 64),
+ * the results do not depend on the count
+ * */
+GRADER_API grader_status grader_grade(grader_book *book, int threads);
+
+
+/* NOTE: Documentation
+ * Number of rows, and row index of the report
+ * */
+GRADER_API size_t grader_count(const grader_book *book);
+GRADER_API grader_status grader_result_at(const grader_book *book, size_t index,
+    grader_result *result);
+
+
+/* NOTE: Documentation
+ * The row of a student id. An id on more than one row
+ * is found graded first, then withdrawn, then error, and
+ * the last of its rows in that section, as -s finds it
+ * */
+GRADER_API grader_status grader_find(const grader_book *book, const char *id,
+    grader_result *result);
+
+
+/* NOTE: Documentation
+ * What went wrong loading the book, with the line
+ * number, empty if nothing did
+ * */
+GRADER_API const char *grader_error(const grader_book *book);
+
+
+GRADER_API void grader_close(grader_book *book);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
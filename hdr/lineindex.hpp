@@ -0,0 +1,134 @@
+#ifndef LINEINDEX_HPP
+#define LINEINDEX_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "evaluation.hpp"
+
+
+namespace GraderApplication
+{
+  /* The index of file.txt is file.txt.gidx */
+#define INDEX_SUFFIX ".gidx"
+
+  /* Bumped whenever the layout of the index changes */
+#define INDEX_VERSION 1
+
+
+  /* NOTE: Documentation
+   * Whether a gradebook's index can be used
+   * */
+  enum IndexStatus
+  {
+    INDEX_MISSING,
+    INDEX_STALE,
+    INDEX_FRESH
+  };
+
+
+  /* NOTE: Documentation
+   * The .gidx sidecar of a plain gradebook, written by
+   * --index and mapped read only by everything after it.
+   * In the machine's byte order it holds
+   *
+   *   a fixed header: magic, version, the size, modified
+   *   time and content hash of the gradebook, the byte
+   *   offset and line count where its header ends, the
+   *   number of student lines and of hash table slots
+   *   the byte offset of every non empty student line
+   *   an open addressing table over the student ids, each
+   *   slot the upper half of the id's hash over the line
+   *   number in the table plus one, 0 for an empty slot
+   *   the file line number of every student line
+   *
+   * so a student is found by hashing its id and probing a
+   * few slots, and only the lines whose ids hash alike are
+   * ever read. Every row of a repeated id is in the table.
+   *
+   * The index is fresh if the gradebook still has the
+   * size and modified time it was indexed at, or the same
+   * content hash if only the time moved, and its header
+   * still ends where it did
+   * */
+  class LineIndex
+  {
+    private:
+      struct Header
+      {
+        char magic[4];
+        std::uint32_t version;
+        std::uint64_t sourceSize;
+        std::int64_t sourceModified;
+        std::uint64_t sourceHash;
+        std::uint64_t headerEnd;
+        std::uint32_t headerLines;
+        std::uint32_t numLines;
+        std::uint64_t tableSize;
+      };
+
+      const char *mapped;
+      std::size_t length;
+      const Header *header;
+      const std::uint64_t *offsets;
+      const std::uint64_t *table;
+      const std::uint32_t *lines;
+
+      void unmap(void);
+
+      friend long writeLineIndex(EvaluationData &);
+
+    public:
+      LineIndex(void);
+      ~LineIndex(void);
+
+      LineIndex(const LineIndex &) = delete;
+      LineIndex& operator=(const LineIndex &) = delete;
+
+
+      /* NOTE: Documentation
+       * Map the index of a gradebook whose header is
+       * loaded. A gradebook read from memory or a
+       * compressed file never has one. Only a fresh index
+       * stays mapped
+       * */
+      IndexStatus open(EvaluationData &);
+
+
+      /* NOTE: Documentation
+       * Every student line, empty lines are left out, with
+       * its byte offset and its line number in the file
+       * */
+      std::size_t size(void) const { return header->numLines; }
+      std::streamoff headerEnd(void) const { return header->headerEnd; }
+      std::streamoff lineOffset(std::size_t row) const { return offsets[row]; }
+      int lineNumber(std::size_t row) const { return lines[row]; }
+
+
+      /* NOTE: Documentation
+       * The rows whose id hashes like id, in file order.
+       * Every row of id is among them, a row of another id
+       * only if its 32 bit hash collides, so the caller
+       * compares the ids of the lines it reads
+       * */
+      void find(const std::string &, std::vector<std::size_t> &) const;
+  };
+
+
+  /* NOTE: Documentation
+   * Path of the index of a gradebook
+   * */
+  std::string indexPath(const std::string &);
+
+
+  /* NOTE: Documentation
+   * --index: scan the student lines of a gradebook whose
+   * header is loaded and write its index beside it, by way
+   * of a temporary file so a reader never maps half an
+   * index. The number of student lines, or -1 with what
+   * went wrong written to the evaluation diagnostics
+   * */
+  long writeLineIndex(EvaluationData &);
+};
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef PERFCOUNT_HPP
+#define PERFCOUNT_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+namespace GraderApplication
+{
+  /* NOTE: Documentation
+   * The hardware events counted, in report order
+   * */
+  enum PerfEvent
+  {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_CACHE_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_EVENTS
+  };
+
+
+  /* NOTE: Documentation
+   * --perf-counters: cycles, instructions, cache misses and
+   * branch misses of the process, user space only, counted
+   * by perf_event_open over each phase of a run.
+   *
+   * The counters are inherited, so the --threads workers
+   * count too, their counts reach the process when they are
+   * joined, which is always before a phase ends. A counter
+   * the kernel had to multiplex is scaled by the time it
+   * ran, and marked with a * in the report.
+   *
+   * Where the counters can not be opened, no PMU in a
+   * virtual machine or perf_event_paranoid in a container,
+   * every phase is still timed and the report says why the
+   * counts are missing
+   * */
+  class PerfCounters
+  {
+    private:
+      struct Reading
+      {
+        std::uint64_t value;
+        std::uint64_t enabled;
+        std::uint64_t running;
+      };
+
+      struct Phase
+      {
+        const char *name;
+        double seconds;
+        double counts[PERF_EVENTS];
+        bool scaled[PERF_EVENTS];
+      };
+
+      int fds[PERF_EVENTS];
+      std::string problem;
+      std::vector<Phase> phases;
+      const char *current;
+      std::chrono::steady_clock::time_point started;
+      Reading start[PERF_EVENTS];
+
+      void read(Reading *) const;
+
+    public:
+      PerfCounters(void);
+      ~PerfCounters(void);
+
+      PerfCounters(const PerfCounters &) = delete;
+      PerfCounters& operator=(const PerfCounters &) = delete;
+
+
+      /* NOTE: Documentation
+       * true if every counter opened, otherwise error()
+       * says which one did not and why
+       * */
+      bool available(void) const { return problem.empty(); }
+      const std::string &error(void) const { return problem; }
+
+
+      /* NOTE: Documentation
+       * End the phase running, if any, and start the named
+       * one, the name must outlive the counters. stop ends
+       * the last phase
+       * */
+      void lap(const char *);
+      void stop(void);
+
+
+      /* NOTE: Documentation
+       * One line per phase and a total: the time, every
+       * count, instructions per cycle, and cache and branch
+       * misses per student line
+       * */
+      void report(long students, std::ostream &) const;
+  };
+};
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef PIPELINE_HPP
+#define PIPELINE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "grader.hpp"
+#include "writer.hpp"
+
+
+/* Bytes the reader hands on at once, cut back to a line end */
+#define PIPELINE_BLOCK (256 << 10)
+
+/* Students parsed into one batch before it moves on */
+#define PIPELINE_RECORDS 1024
+
+/* Batches each queue holds before its producer waits, a power of 2 */
+#define PIPELINE_DEPTH 8
+
+
+/* NOTE: Documentation
+ * Bounded, lock free, single producer single consumer
+ * queue. head is only written by the consumer and tail by
+ * the producer, each on a cache line of its own, a slot
+ * is handed over by the release store of tail and handed
+ * back by the release store of head.
+ *
+ * A push onto a full queue waits, yielding, until the
+ * consumer makes room, which is the backpressure that
+ * keeps a fast stage from running ahead. A pop from an
+ * empty queue waits the same way. Both sides count how
+ * often and how long they waited and how full they found
+ * the queue, read once both threads are done
+ * */
+template <typename T>
+class SpscRing
+{
+  private:
+    std::vector<T> slots;
+    std::size_t mask;
+    alignas(64) std::atomic<std::size_t> head;
+    alignas(64) std::atomic<std::size_t> tail;
+
+    /* producer side */
+    alignas(64) std::uint64_t pushCount;
+    std::uint64_t fullCount;
+    std::uint64_t fillSum;
+    std::chrono::steady_clock::duration blocked;
+
+    /* consumer side */
+    alignas(64) std::uint64_t emptyCount;
+    std::chrono::steady_clock::duration starved;
+
+  public:
+    explicit SpscRing(std::size_t capacity)
+      : slots(capacity)
+        , mask(capacity - 1)
+        , head(0)
+        , tail(0)
+        , pushCount(0)
+        , fullCount(0)
+        , fillSum(0)
+        , blocked(0)
+        , emptyCount(0)
+        , starved(0)
+    { }
+
+    SpscRing(const SpscRing &) = delete;
+    SpscRing& operator=(const SpscRing &) = delete;
+
+    void push(T item)
+    {
+      std::size_t t = tail.load(std::memory_order_relaxed);
+      if (t - head.load(std::memory_order_acquire) == slots.size())
+      {
+        fullCount++;
+        auto from = std::chrono::steady_clock::now();
+        while (t - head.load(std::memory_order_acquire) == slots.size()) { std::this_thread::yield(); }
+        blocked += std::chrono::steady_clock::now() - from;
+      }
+      fillSum += t - head.load(std::memory_order_relaxed);
+      pushCount++;
+      slots[t & mask] = std::move(item);
+      tail.store(t + 1, std::memory_order_release);
+    }
+
+    T pop(void)
+    {
+      std::size_t h = head.load(std::memory_order_relaxed);
+      if (tail.load(std::memory_order_acquire) == h)
+      {
+        emptyCount++;
+        auto from = std::chrono::steady_clock::now();
+        while (tail.load(std::memory_order_acquire) == h) { std::this_thread::yield(); }
+        starved += std::chrono::steady_clock::now() - from;
+      }
+      T item = std::move(slots[h & mask]);
+      head.store(h + 1, std::memory_order_release);
+      return item;
+    }
+
+    std::size_t capacity(void) const { return slots.size(); }
+    std::uint64_t pushes(void) const { return pushCount; }
+    std::uint64_t fullWaits(void) const { return fullCount; }
+    std::uint64_t emptyWaits(void) const { return emptyCount; }
+    double meanFill(void) const { return pushCount > 0 ? static_cast<double>(fillSum) / pushCount : 0; }
+    std::chrono::steady_clock::duration blockedTime(void) const { return blocked; }
+    std::chrono::steady_clock::duration starvedTime(void) const { return starved; }
+};
+
+
+/* NOTE: Documentation
+ * --pipeline: the full report with reading, parsing,
+ * grading and writing each on a thread of its own, so the
+ * disk, the cpus and the output are busy at once.
+ *
+ *   read   raw blocks of PIPELINE_BLOCK bytes, whole lines
+ *   parse  scans each block and loads its students into
+ *          Containers of PIPELINE_RECORDS rows
+ *   grade  runs makeGrades on each Container, on --threads
+ *   write  hands graded rows to the writer as they come,
+ *          and spools withdrawn and error rows until the end
+ *
+ * over SpscRings of PIPELINE_DEPTH batches, so at most a
+ * few batches per stage are in memory. The report is the
+ * same as the normal full report. The time each stage
+ * worked and waited, and how full each queue ran, is then
+ * written to diagnostics.
+ *
+ * false, with the reason in the evaluation diagnostics, if
+ * the gradebook or a spool file could not be opened
+ * */
+bool pipelineGrades(EvaluationData &, OutputWriter &, std::ostream &diagnostics);
+
+
+#endif
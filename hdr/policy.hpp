@@ -0,0 +1,45 @@
+#ifndef POLICY_HPP
+#define POLICY_HPP
+
+#include "grader.hpp"
+
+
+/* NOTE: Documentation
+ * Apply the DROP / BEST category policies from the header.
+ * Marks are ranked by mark / maxmark inside their category
+ * and the lowest ones are switched off in c.markMask, which
+ * is laid out row major next to c.student,
+ * markMask[i * evaluationDataLength + j]
+ *
+ * Dropping a single mark is done in blocks of students with
+ * a running minimum per column, so the compiler can vectorize
+ * across students. Dropping more uses a partial selection per
+ * row (nth_element), the row is never fully sorted.
+ *
+ * An exempt mark is never dropped, and a student always
+ * keeps at least one mark they are not exempt from
+ * */
+void selectKeptMarks(EvaluationData &, Container &);
+
+
+/* NOTE: Documentation
+ * Scale factor per evaluation column for one student:
+ * 0 for a dropped or exempt mark, (category weight / kept
+ * weight) for a kept mark so every category is still worth
+ * its full weight, which is 1 where nothing was taken out.
+ * A category the student is exempt from entirely spreads
+ * its weight over the others, (total / (total - lost)).
+ *
+ * The kept marks are worked out from the mask and the
+ * exemption bitmask as 0 / 1 per column without a branch,
+ * the caller multiplies its row by scale.
+ *
+ * mask is the students row of c.markMask and exempt is
+ * studentExemptBits, either can be nullptr. weights is
+ * the WEIGHT vector to renormalize against
+ * */
+void policyColumnScale(EvaluationData &, const unsigned char *mask,
+    const std::uint64_t *exempt, const float *weights, float *scale);
+
+
+#endif
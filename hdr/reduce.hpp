@@ -0,0 +1,101 @@
+#ifndef REDUCE_HPP
+#define REDUCE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+
+namespace GraderApplication
+{
+  /* Values summed left to right before a partial sum is
+   * combined with any other, the fixed shape every sum has
+   * */
+#define REDUCE_BLOCK 1024
+
+  /* Upper bound on --threads */
+#define MAX_THREADS 64
+
+
+  /* NOTE: Documentation
+   * Run fn(begin, end) over [0, n) split into contiguous
+   * ranges, one per thread. The calling thread takes the
+   * first range, so one thread starts nothing
+   * */
+  template <typename Fn>
+  void parallelFor(std::size_t n, int threads, Fn fn)
+  {
+    std::size_t parts = std::max(1, std::min(threads, MAX_THREADS));
+    parts = std::min(parts, std::max<std::size_t>(n, 1));
+    std::size_t chunk = (n + parts - 1) / parts;
+
+    std::vector<std::thread> pool;
+    for (std::size_t p = 1; p < parts; p++)
+    {
+      std::size_t begin = std::min(n, p * chunk);
+      std::size_t end = std::min(n, begin + chunk);
+      pool.emplace_back(fn, begin, end);
+    }
+    fn(static_cast<std::size_t>(0), std::min(n, chunk));
+    for (auto &t: pool) { t.join(); }
+  }
+
+
+  /* NOTE: Documentation
+   * One REDUCE_BLOCK, plainly left to right
+   * */
+  template <typename T>
+  T blockSum(const T *v, std::size_t n)
+  {
+    T sum = 0;
+    for (std::size_t i = 0; i < n; i++) { sum += v[i]; }
+    return sum;
+  }
+
+
+  /* NOTE: Documentation
+   * Pairwise sum of per block sums, the tree is split at
+   * half the blocks so it only depends on how many there are
+   * */
+  template <typename T>
+  T combineBlocks(const T *blocks, std::size_t numBlocks)
+  {
+    if (numBlocks == 1) { return blocks[0]; }
+    std::size_t half = numBlocks / 2;
+    return combineBlocks(blocks, half) + combineBlocks(blocks + half, numBlocks - half);
+  }
+
+
+  /* NOTE: Documentation
+   * Deterministic reduction: v is cut into REDUCE_BLOCK
+   * sized blocks, each summed left to right, and the block
+   * sums are added pairwise in a tree fixed by n alone.
+   * The threads only decide who sums which blocks, never
+   * the order of any addition, so the result is bit for
+   * bit the same for any thread count. Error grows with
+   * log(n) rather than n.
+   *
+   * Up to REDUCE_BLOCK values it is exactly a left to
+   * right std::accumulate
+   * */
+  template <typename T>
+  T deterministicSum(const T *v, std::size_t n, int threads = 1)
+  {
+    if (n <= REDUCE_BLOCK) { return blockSum(v, n); }
+
+    std::size_t numBlocks = (n + REDUCE_BLOCK - 1) / REDUCE_BLOCK;
+    std::vector<T> blocks(numBlocks);
+    parallelFor(numBlocks, threads, [&](std::size_t begin, std::size_t end)
+    {
+      for (std::size_t b = begin; b < end; b++)
+      {
+        std::size_t from = b * REDUCE_BLOCK;
+        blocks[b] = blockSum(v + from, std::min<std::size_t>(REDUCE_BLOCK, n - from));
+      }
+    });
+    return combineBlocks(blocks.data(), numBlocks);
+  }
+};
+
+#endif
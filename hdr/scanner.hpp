@@ -0,0 +1,131 @@
+#ifndef SCANNER_HPP
+#define SCANNER_HPP
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+
+namespace GraderApplication
+{
+  /* Bytes classified per step, one bit each in a 64 bit mask */
+#define SCAN_CHUNK 64
+
+  /* Bytes read from the gradebook per scanned block */
+#define SCAN_BLOCK (1 << 20)
+
+
+  /* NOTE: Documentation
+   * One token, [start, end) as byte offsets into the
+   * scanned block
+   * */
+  struct TokenSpan
+  {
+    std::uint32_t start;
+    std::uint32_t end;
+  };
+
+
+  /* NOTE: Documentation
+   * One line of the block. [start, end) is the line without
+   * its newline, as getline would return it, comment is where
+   * the first COMM is, or end. Its tokens are
+   * tokens[firstToken, firstToken + numTokens)
+   * */
+  struct ScannedLine
+  {
+    std::uint32_t start;
+    std::uint32_t end;
+    std::uint32_t comment;
+    std::uint32_t firstToken;
+    std::uint32_t numTokens;
+  };
+
+
+  /* NOTE: Documentation
+   * Which classifier the scanner runs, chosen once from
+   * what the cpu supports. GRADER_SCAN=scalar|sse2|avx2 in
+   * the environment forces one, for testing
+   * */
+  enum ScanBackend
+  {
+    SCAN_SCALAR,
+    SCAN_SSE2,
+    SCAN_AVX2
+  };
+
+  ScanBackend scanBackend(void);
+  const char *scanBackendName(ScanBackend);
+
+
+  /* NOTE: Documentation
+   * Splits a whole block of lines into lines, comments and
+   * tokens in one pass. Every SCAN_CHUNK bytes are classified
+   * into newline, COMM and white space bit masks, with SSE2 or
+   * AVX2 compares where the cpu has them, then the token and
+   * line boundaries are read off the masks a set bit at a time.
+   *
+   * White space is every Delim that std::istream >> skips,
+   * and a token ends at a COMM, so the tokens are exactly those
+   * of getline, stripComments and >> on each line. The last
+   * line may be missing its newline
+   * */
+  class LineScanner
+  {
+    private:
+      ScanBackend backend;
+
+    public:
+      std::vector<ScannedLine> lines;
+      std::vector<TokenSpan> tokens;
+
+      LineScanner(void);
+      explicit LineScanner(ScanBackend);
+
+      /* replaces lines and tokens, blocks are at most 4GB */
+      void scan(const char *, std::size_t);
+  };
+
+
+  /* NOTE: Documentation
+   * Reads a stream SCAN_BLOCK bytes at a time, cut back to
+   * the last newline, scans each block and hands its lines
+   * out one by one. The partial line at the end of a block
+   * starts the next one, a line longer than a block grows
+   * the block until it fits
+   * */
+  class BlockReader
+  {
+    private:
+      std::istream &in;
+      std::string block;
+      std::string carry;
+      std::streamoff blockOffset;
+      LineScanner scanner;
+      std::size_t nextLine;
+
+      bool refill(void);
+
+    public:
+      /* offset is where in the file the stream is now */
+      BlockReader(std::istream &, std::streamoff);
+
+      /* move to the next line, false at the end of the stream */
+      bool next(void);
+
+      const char *data(void) const { return block.data(); }
+      const ScannedLine &line(void) const { return scanner.lines[nextLine - 1]; }
+      const TokenSpan *lineTokens(void) const { return scanner.tokens.data() + line().firstToken; }
+      std::streamoff lineOffset(void) const { return blockOffset + line().start; }
+  };
+
+
+  /* NOTE: Documentation
+   * --tokens file: print every line number with its tokens,
+   * used to compare the classifiers against each other
+   * */
+  void dumpTokens(std::istream &, std::ostream &);
+};
+
+#endif
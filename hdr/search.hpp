@@ -0,0 +1,97 @@
+#ifndef SEARCH_HPP
+#define SEARCH_HPP
+
+#include <cstdint>
+#include "grader.hpp"
+
+
+/* -s tob* is a prefix search */
+#define PREFIX_MARK '*'
+
+/* -s ~tob also matches ids one edit away */
+#define FUZZY_MARK '~'
+
+
+/* NOTE: Documentation
+ * One student found by a search, the section
+ * and its position in that Container vector
+ * */
+struct StudentMatch
+{
+  ContainerSection section;
+  int index;
+};
+
+
+/* NOTE: Documentation
+ * A compressed (radix) trie over every student id of a
+ * Container, graded, withdrawn and error rows alike.
+ *
+ * The ids are sorted once, each node then covers a range
+ * [lo, hi) of the sorted ids that share a prefix, and its
+ * edge is the run of characters that whole range has in
+ * common, read straight out of the first id of the range.
+ * So no node stores any characters of its own, and every
+ * match below a node is one contiguous range.
+ *
+ * The Container must outlive the trie
+ * */
+class StudentTrie
+{
+  private:
+    struct Entry
+    {
+      const std::string *id;
+      StudentMatch match;
+    };
+
+    struct Node
+    {
+      std::uint32_t lo;
+      std::uint32_t hi;
+      std::uint32_t depth;
+      std::uint32_t end;
+      std::uint32_t firstChild;
+      std::uint32_t numChildren;
+    };
+
+    std::vector<Entry> entries;
+    std::vector<Node> nodes;
+
+    const std::string &key(std::uint32_t node) const { return *entries[nodes[node].lo].id; }
+    std::uint32_t terminalEnd(std::uint32_t) const;
+
+    void build(std::uint32_t, std::uint32_t, std::uint32_t, std::uint32_t);
+    void fuzzy(std::uint32_t, std::uint32_t, const std::string &, std::size_t,
+        bool, std::vector<std::uint32_t> &) const;
+    void collect(std::uint32_t, std::uint32_t, std::vector<StudentMatch> &) const;
+
+  public:
+    explicit StudentTrie(const Container &);
+
+
+    /* NOTE: Documentation
+     * Every id that starts with prefix, in id order
+     * */
+    void prefixSearch(const std::string &, std::vector<StudentMatch> &) const;
+
+
+    /* NOTE: Documentation
+     * Every id within one insertion, deletion or
+     * substitution of query, in id order
+     * */
+    void fuzzySearch(const std::string &, std::vector<StudentMatch> &) const;
+};
+
+
+/* NOTE: Documentation
+ * -s with a trailing PREFIX_MARK or a leading FUZZY_MARK,
+ * prints every match with its section. With no match it
+ * prints the same not found message as a plain search
+ * and returns false
+ * */
+bool isPatternSearch(const std::string &);
+bool outputSearch(const Container &, const std::string &);
+
+
+#endif
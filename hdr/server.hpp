@@ -0,0 +1,109 @@
+#ifndef SERVER_HPP
+#define SERVER_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <sys/types.h>
+#include "grader.hpp"
+#include "snapshot.hpp"
+
+
+/* Worker threads answering clients */
+#define SERVER_THREADS 4
+
+/* How often the gradebook files are checked for changes */
+#define SERVER_POLL_MS 1000
+
+
+/* NOTE: Documentation
+ * A gradebook is one input file loaded, graded and
+ * indexed by student id, modified (nanoseconds) and
+ * size are the files stamp when it was read, used to
+ * spot changes. Once built it is never
+ * modified, a reload builds a whole new Gradebook and
+ * publishes it through a Snapshot, so any number of
+ * clients can read one without taking a lock
+ * */
+struct Gradebook
+{
+  private:
+    Gradebook(const Gradebook &) = delete;
+    Gradebook& operator=(const Gradebook &) = delete;
+
+  public:
+    std::string file;
+    EvaluationData eval;
+    std::unique_ptr<Container> container;
+    std::unordered_map<std::string, std::pair<ContainerSection, int>> index;
+    long long modified;
+    off_t size;
+    LoadStatus status;
+
+
+    /* NOTE: Documentation
+     * Explicit constructor
+     * loads and grades the file, the same steps
+     * as a normal grader run without the output.
+     * A file that can not be read or has a broken
+     * header is left ungraded with status set, and
+     * is never published
+     * */
+    Gradebook(const std::string &);
+};
+
+
+/* NOTE: Documentation
+ * Fixed size pool of worker threads, every submitted
+ * client socket is handed to the handler on the first
+ * free worker. The destructor lets the queued clients
+ * finish then joins every worker
+ * */
+class ThreadPool
+{
+  private:
+    std::vector<std::thread> workers;
+    std::queue<int> jobs;
+    std::mutex jobsMutex;
+    std::condition_variable jobsReady;
+    bool stopping;
+    std::function<void(int)> handler;
+
+    void workerLoop(void);
+
+  public:
+    ThreadPool(int, std::function<void(int)>);
+    ~ThreadPool(void);
+
+    void submit(int);
+};
+
+
+/* NOTE: Documentation
+ * Entry point for grader --serve socket file [file ...]
+ * Loads every file, then answers a line protocol on the
+ * unix socket until SIGINT or SIGTERM:
+ *
+ *   LIST                  loaded gradebooks
+ *   STUDENT <book> <id>   one student and its section
+ *   REPORT <book>         full table, withdrawn and errors
+ *   STATS <book>          counts, mean / min / max, letters
+ *   QUIT                  close the connection
+ *
+ * <book> is the path as given, or its base name.
+ * Every response ends with a line holding only END,
+ * failures start with ERR
+ *
+ * A socket file nobody answers on is replaced, a path
+ * that exists and is not a socket is refused untouched
+ *
+ * returns the process exit status
+ * */
+int runServer(const std::string &, const std::vector<std::string> &);
+
+
+#endif
@@ -16,14 +16,19 @@ namespace GraderApplication
 #define IS_D(x) ((x) >= 49.5 && (x) < 54.5)
 #define IS_F(x) ((x) >= 0 && (x) < 49.5)
 
-  /* Define a Debug flag here, Debug enabled print statements
-   * at important bottle neck points in the software still need
-   * to be implemented
-   *
-   * To turn Debug logging off change macro to 1
-   * To turn on change to 0
+  /* Define a Debug flag here, 1 compiles the trace points
+   * in trace.hpp into loading, grading and output, 0 compiles
+   * them to nothing. The debug build passes -DDEBUG=1, a
+   * traced run then writes the file GRADER_TRACE names
    * */
+#ifndef DEBUG
 #define DEBUG 0
+#endif
+
+  /* --fixed-point: marks, max marks and weights are held
+   * as integers in thousandths
+   * */
+#define FIXED_SCALE 1000
 
   /* Max amount of evaluation lines we can have */
 #define HEADER_MAX 4
@@ -31,14 +36,25 @@ namespace GraderApplication
   /* Define Header Keywords here. The text file surely should have
    * some standardization
    * */
-#define TEMPFILE ".temp"
-#define SANITIZE "rm .temp"
 #define TITLE "TITLE" 
 #define CATEGORY "CATEGORY"
 #define MAXMARK "MAXMARK"
 #define WEIGHT "WEIGHT"
 #define WDRN "WDR"
 
+  /* WEIGHT adds up to this, renormalized rows are capped at it */
+#define MAX_GRADE 100
+
+  /* A mark the student is excused from, in any case */
+#define EXEMPT "EXEMPT"
+#define EXEMPT_SHORT "EX"
+
+  /* Per category aggregation policies, declared after the
+   * header eg: "DROP Lab 1" or "BEST Assign 3"
+   * */
+#define DROP "DROP"
+#define BEST "BEST"
+
   /* NOTE: Documentaion
    * File delimiters, or characters we want to ignore, or look for 
    * when parsing the file 
@@ -47,7 +63,11 @@ namespace GraderApplication
   {
     WS = ' ',
     COMM = '#',
-    TAB = '\t'
+    TAB = '\t',
+    NL = '\n',
+    CR = '\r',
+    VT = '\v',
+    FF = '\f'
   };
 
   struct Colors
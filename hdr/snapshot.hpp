@@ -0,0 +1,258 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+namespace GraderApplication
+{
+  /* Most threads that may read snapshots at the same time */
+#define MAX_SNAPSHOT_READERS 128
+
+
+  /* NOTE: Documentation
+   * Epoch based reclamation shared by every Snapshot.
+   * A reading thread announces the epoch it entered in,
+   * in its own cache line, and clears it when it leaves.
+   * A retired object tagged with epoch e can be freed once
+   * no reader is still inside an epoch older than e, since
+   * any reader that could have seen it entered before it
+   * was unpublished.
+   *
+   * Readers never wait on anything, writers never wait on
+   * readers, they just free later
+   * */
+  class EpochDomain
+  {
+    private:
+      struct alignas(64) ReaderSlot
+      {
+        std::atomic<std::uint64_t> epoch;
+        std::atomic<bool> claimed;
+      };
+
+      std::atomic<std::uint64_t> globalEpoch;
+      ReaderSlot slots[MAX_SNAPSHOT_READERS];
+
+      EpochDomain(void)
+        : globalEpoch(1)
+      {
+        for (auto &s: slots)
+        {
+          s.epoch.store(0);
+          s.claimed.store(false);
+        }
+      }
+
+      /* NOTE: Documentation
+       * Per thread handle on a reader slot, claimed on the
+       * threads first read and handed back when it exits.
+       * depth lets a thread nest read sections
+       * */
+      struct ThreadSlot
+      {
+        ReaderSlot *slot;
+        int depth;
+
+        ThreadSlot(void) : slot(nullptr), depth(0) { }
+        ~ThreadSlot(void)
+        {
+          if (slot != nullptr)
+          {
+            slot->epoch.store(0);
+            slot->claimed.store(false);
+          }
+        }
+      };
+
+      ReaderSlot *claimSlot(void)
+      {
+        while (true)
+        {
+          for (auto &s: slots)
+          {
+            bool expected = false;
+            if (s.claimed.compare_exchange_strong(expected, true))
+            {
+              return &s;
+            }
+          }
+          /* every slot is taken, wait for a reader thread to exit */
+          std::this_thread::yield();
+        }
+      }
+
+      static ThreadSlot &threadSlot(void)
+      {
+        thread_local ThreadSlot mine;
+        return mine;
+      }
+
+    public:
+      EpochDomain(const EpochDomain &) = delete;
+      EpochDomain& operator=(const EpochDomain &) = delete;
+
+      static EpochDomain &instance(void)
+      {
+        static EpochDomain domain;
+        return domain;
+      }
+
+
+      /* NOTE: Documentation
+       * Start and end a read section on the calling thread,
+       * the announcement must be visible before the reader
+       * loads any published pointer, hence seq_cst
+       * */
+      void enter(void)
+      {
+        ThreadSlot &mine = threadSlot();
+        if (mine.depth++ > 0) { return; }
+        if (mine.slot == nullptr) { mine.slot = claimSlot(); }
+        mine.slot->epoch.store(globalEpoch.load());
+      }
+
+      void leave(void)
+      {
+        ThreadSlot &mine = threadSlot();
+        if (--mine.depth > 0) { return; }
+        mine.slot->epoch.store(0, std::memory_order_release);
+      }
+
+
+      /* NOTE: Documentation
+       * Called by a writer after it unpublished an object,
+       * returns the epoch to tag the retired object with
+       * */
+      std::uint64_t advance(void) { return globalEpoch.fetch_add(1) + 1; }
+
+
+      /* NOTE: Documentation
+       * true once no reader can still hold an object
+       * retired at epoch retiredAt
+       * */
+      bool safeToReclaim(std::uint64_t retiredAt)
+      {
+        for (auto &s: slots)
+        {
+          std::uint64_t e = s.epoch.load();
+          if (e != 0 && e < retiredAt)
+          {
+            return false;
+          }
+        }
+        return true;
+      }
+  };
+
+
+  /* NOTE: Documentation
+   * An immutable object published behind an atomically
+   * swapped pointer. Readers open a SnapshotReader and
+   * get a pointer that stays valid until it goes out of
+   * scope, without taking a lock. A writer builds the new
+   * object off to the side and publishes it, the old one
+   * is retired and freed by a later publish or reclaim
+   * once every reader that could see it has left.
+   *
+   * Writers must be serialized by the caller
+   * */
+  template <typename T>
+  class Snapshot
+  {
+    private:
+      std::atomic<const T *> current;
+      std::vector<std::pair<std::uint64_t, const T *>> retired;
+
+    public:
+      Snapshot(void) : current(nullptr) { }
+
+      explicit Snapshot(const T *initial) : current(initial) { }
+
+      Snapshot(const Snapshot &) = delete;
+      Snapshot& operator=(const Snapshot &) = delete;
+
+      /* no readers may remain when a Snapshot is destroyed */
+      ~Snapshot(void)
+      {
+        delete current.load();
+        for (auto &r: retired) { delete r.second; }
+      }
+
+
+      /* NOTE: Documentation
+       * only valid inside a read section, use SnapshotReader
+       * */
+      const T *load(void) const { return current.load(); }
+
+
+      /* NOTE: Documentation
+       * Swap in a fully built object and retire the old one
+       * */
+      void publish(const T *fresh)
+      {
+        const T *old = current.exchange(fresh);
+        if (old != nullptr)
+        {
+          retired.emplace_back(EpochDomain::instance().advance(), old);
+        }
+        reclaim();
+      }
+
+
+      /* NOTE: Documentation
+       * Free every retired object no reader can still see,
+       * returns how many are still waiting on readers
+       * */
+      std::size_t reclaim(void)
+      {
+        EpochDomain &domain = EpochDomain::instance();
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < retired.size(); i++)
+        {
+          if (domain.safeToReclaim(retired[i].first))
+          {
+            delete retired[i].second;
+          }
+          else
+          {
+            retired[kept++] = retired[i];
+          }
+        }
+        retired.resize(kept);
+        return kept;
+      }
+  };
+
+
+  /* NOTE: Documentation
+   * RAII read section on a Snapshot
+   * */
+  template <typename T>
+  class SnapshotReader
+  {
+    private:
+      const T *object;
+
+    public:
+      explicit SnapshotReader(const Snapshot<T> &snapshot)
+      {
+        EpochDomain::instance().enter();
+        object = snapshot.load();
+      }
+
+      ~SnapshotReader(void) { EpochDomain::instance().leave(); }
+
+      SnapshotReader(const SnapshotReader &) = delete;
+      SnapshotReader& operator=(const SnapshotReader &) = delete;
+
+      const T *operator->(void) const { return object; }
+      const T &operator*(void) const { return *object; }
+  };
+};
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef STREAM_HPP
+#define STREAM_HPP
+
+#include <cstdio>
+#include "grader.hpp"
+#include "writer.hpp"
+
+
+/* NOTE: Documentation
+ * Withdrawn and error rows are not needed until the end
+ * of the report, so the streaming reader writes them to
+ * an anonymous temporary file as they are found and
+ * replays them through the writer once every graded
+ * row is out
+ * */
+class RowSpool
+{
+  private:
+    std::FILE *file;
+    long rows;
+
+  public:
+    RowSpool(void);
+    ~RowSpool(void);
+
+    RowSpool(const RowSpool &) = delete;
+    RowSpool& operator=(const RowSpool &) = delete;
+
+    /* false if the temporary file could not be created */
+    bool good(void) const;
+
+    void spool(const StudentData &);
+
+    /* hand every spooled row to the writer, in file order */
+    void replay(OutputWriter &, ContainerSection);
+};
+
+
+/* NOTE: Documentation
+ * --stream: parse, grade and write the students one
+ * window at a time. Only window students are held at
+ * once, whatever the size of the file, the output is
+ * the same as the normal full report. false, with the
+ * reason in the evaluation diagnostics, if the gradebook
+ * or a spool file could not be opened
+ * */
+bool streamGrades(EvaluationData &, OutputWriter &, int window);
+
+
+#endif
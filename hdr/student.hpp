@@ -1,36 +1,86 @@
 #ifndef STUDENT_HPP
 #define STUDENT_HPP
 
+#include <memory>
 #include <vector>
+#include "duplicate.hpp"
 #include "evaluation.hpp"
+#include "scanner.hpp"
 #include "utillity.hpp"
 
 
 namespace GraderApplication
 {
+  /* NOTE: Documentation
+   * Letter grade of a student, one byte in the record.
+   * The texts are the Echelon ones, LETTER_INVALID is a
+   * total no range matched
+   * */
+  enum LetterGrade : std::uint8_t
+  {
+    LETTER_NONE,
+    LETTER_A_PLUS, LETTER_A, LETTER_A_MINUS,
+    LETTER_B_PLUS, LETTER_B, LETTER_B_MINUS,
+    LETTER_C_PLUS, LETTER_C, LETTER_C_MINUS,
+    LETTER_D, LETTER_F,
+    LETTER_WITHDRAWN,
+    LETTER_INVALID,
+    LETTER_COUNT
+  };
+
+
+  /* NOTE: Documentation
+   * The text of a LetterGrade, empty for LETTER_NONE
+   * */
+  const std::string &letterGradeText(LetterGrade);
+
+
+  /* NOTE: Documentation
+   * The text of a row that only its report needs, the
+   * raw line and the error message. Only an error or a
+   * withdrawn row has one, graded rows never allocate it
+   * */
+  struct StudentText
+  {
+    std::string line;
+    std::string errorDef;
+  };
+
+
   /* NOTE: Documentation
    * For every occurance of a valid student line
    * in the given file a student object will be created
    * and stored in a corresponding vector of the same type
    * defined and handled from the grader class.
+   *
+   * The fields grading reads and writes come first and
+   * fill the first cache line of the record: the scores,
+   * line, length, letter and status bits, and the id,
+   * which short ids keep inline. The marks follow, the
+   * cold text hangs off a pointer. Moves only hand over
+   * pointers, they never allocate or throw
    * */
-  class StudentData : public Utillity
+  class alignas(64) StudentData : public Utillity
   {
     private:
-      std::string name;
-      std::vector <float> gradesContainer;
-      std::vector <float> calculatedGradesContainer;
-      int studentDataLen;
       float labScore;
       float assignScore;
       float midtermScore;
       float finalScore;
       float totalGrade;
-      std::string letterGrade;
-      bool isWDR;
-      bool isError;
-      std::string errorDef;
       int mlineCount;
+      int studentDataLen;
+      LetterGrade letter;
+      std::uint8_t status;
+      std::string name;
+      std::vector <float> gradesContainer;
+      std::vector <std::int64_t> fixedGradesContainer;
+      std::vector <std::uint64_t> exemptBits;
+      std::vector <float> calculatedGradesContainer;
+      std::unique_ptr<StudentText> text;
+
+      /* the cold text, allocated on first use */
+      StudentText &studentText(void);
 
     public:
 
@@ -64,7 +114,7 @@ namespace GraderApplication
 
       /*
        * NOTE: Documentation
-       * Copy Constructor
+       * Copy Constructor, copies the cold text too
        */
       StudentData(const StudentData &);
 
@@ -90,15 +140,41 @@ namespace GraderApplication
       /* NOTE: Documentation
        * getters and setters for name
        * */
-      std::string studentName(void) const;
+      const std::string &studentName(void) const;
       void setStudentName(std::string &);
 
 
       /* NOTE: Documentation
-       * getters and setters for grades container
+       * getters and setters for grades container.
+       * The setter takes every mark token of the row,
+       * converts them all, then checks the whole row against
+       * the max marks at once. The error preserved is the one
+       * a mark by mark check would have stopped at first:
+       * a mark over its max before any WDR, or a token that
+       * is neither a number nor WDR. studentGrades is every
+       * mark at once, in column order, for the row kernels
        * */
-      float studentGradesContainer(int &);
-      void setStudentGradesContainer(std::string &, EvaluationData &);
+      float studentGradesContainer(int) const;
+      const float *studentGrades(void) const;
+      void setStudentGradesContainer(const char *, const TokenSpan *, std::uint32_t, EvaluationData &);
+
+
+      /* NOTE: Documentation
+       * getter for the marks in thousandths, only kept
+       * when the evaluation is in --fixed-point mode
+       * */
+      std::int64_t studentFixedGrade(int) const;
+
+
+      /* NOTE: Documentation
+       * getters for EX / EXEMPT marks. An exempt mark is
+       * stored as 0 and its bit is set in a bitmask next to
+       * the marks, bit j of word j / 64 for column j. The
+       * bitmask is only allocated for a student with an
+       * exemption, studentExemptBits is nullptr otherwise
+       * */
+      bool studentExempt(int) const;
+      const std::uint64_t *studentExemptBits(void) const;
 
 
       /* NOTE: Documentation
@@ -123,38 +199,42 @@ namespace GraderApplication
       /* NOTE: Documentation
        * Accessor methods for
        * the students accumulated
-       * total lab scores
+       * total lab scores, a negative score
+       * is refused with false
        * */
       float studentLabScore(void) const;
-      void setStudentLabScore(float score);
+      bool setStudentLabScore(float score);
 
 
       /* NOTE: Documentation
        * Accessor methods for
        * the students accumulated
-       * assignment scores
+       * assignment scores, a negative score
+       * is refused with false
        * */
       float studentAssignScore(void) const;
-      void setStudentAssignScore(float score);
+      bool setStudentAssignScore(float score);
 
 
       /* NOTE: Documentation
        * Accessor methods for
        * the students accumulated
-       * midterm scores
+       * midterm scores, a negative score
+       * is refused with false
        * */
       float studentMidtermScore(void) const;
-      void setStudentMidtermScore(float score);
+      bool setStudentMidtermScore(float score);
 
 
       /* NOTE: Documentation
        * Accessor methods for
        * the students accumulated
        * final (test) score this should
-       * only be one
+       * only be one, a negative score is
+       * refused with false
        * */
       float studentFinalScore(void) const;
-      void setStudentFinalScore(float score);
+      bool setStudentFinalScore(float score);
 
 
       /* NOTE: Documentation
@@ -167,10 +247,13 @@ namespace GraderApplication
 
       /* NOTE: Documentation
        * getters and setters for the Letter
-       * grader obtained by the student
+       * grader obtained by the student. Text that is not
+       * a letter grade or WITHDRAWN is stored as none
        * */
-      std::string studentLetterGrade(void) const;
+      const std::string &studentLetterGrade(void) const;
       void setStudentLetterGrade(const std::string &);
+      LetterGrade studentLetter(void) const;
+      void setStudentLetter(LetterGrade);
 
 
       /* NOTE: Documentation
@@ -196,52 +279,49 @@ namespace GraderApplication
 
       /* NOTE: Documentation
        * Store the error definition
-       * from out custom exceptions
+       * from out custom exceptions, an
+       * empty one is refused with false
        * */
-      std::string errorDefinition(void) const;
-      void setErrorDefinition(const std::string &);
+      const std::string &errorDefinition(void) const;
+      bool setErrorDefinition(const std::string &);
 
 
       /* NOTE: Documentation
-       * Update line count from evaluation
-       * object
+       * The raw line of an error or withdrawn row,
+       * empty for a graded one
        * */
-      int lineCount(void) const;
-      void setLineCount(int _count);
+      const std::string &currentLineContent(void) const;
+      void setCurrentLineContent(const std::string &);
 
 
       /* NOTE: Documentation
-       * Main method for Student Class, it uses the
-       * file position set from BaseHeader class,
-       * to skip right to where the students section is.
-       *
-       * The method its self is very similar to how loadBaseData
-       * works in the BaseHeader Class
-       * */
-      bool loadStudents(EvaluationData &);
-
-      /* NOTE: Documentation
-       * Helper method for loadDataFile, checks if student is found
-       * in temp file by string comparison, returns true or false
+       * Update line count from evaluation
+       * object, a count below 1 is refused
+       * with false
        * */
-      bool isStudentProcessed(const std::string &);
+      int lineCount(void) const;
+      bool setLineCount(int _count);
 
 
       /* NOTE: Documentation
-       * first test for tempfile existence, if it doesnt we havnt
-       * read the file at all yet
+       * Main method for Student Class, loads the student
+       * from the reader's current line, which the caller has
+       * checked is not empty. Readers start at the file
+       * position set from BaseHeader class, so they skip
+       * right to where the students section is.
+       *
+       * A line that is a duplicate of an earlier one is
+       * not parsed and false is returned
        * */
-      bool testForFileExistence(const std::string &);
+      bool loadStudent(const BlockReader &, EvaluationData &, DuplicateFilter &);
 
 
       /* NOTE: Documentation
-       * after a student is read in to the studentvector, this
-       * method writes said processed student to the temp file
-       * then closes it, if the file doesnt exist yet it creates it.
-       * it is careful to append students, and not trample previously
-       * written data.
+       * Parse the tokens of one student line, the id
+       * then every mark. Stops at the first error, which
+       * is preserved like any other
        * */
-      void processStudent(const std::string &);
+      void parseStudentTokens(const char *, const TokenSpan *, std::uint32_t, EvaluationData &);
   };
 };
 
@@ -0,0 +1,100 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include "settings.hpp"
+
+#if DEBUG
+#include <chrono>
+#include <cstdint>
+#endif
+
+
+namespace GraderApplication
+{
+  /* Environment variable naming the trace file to write */
+#define TRACE_ENV "GRADER_TRACE"
+
+#if DEBUG
+
+  /* NOTE: Documentation
+   * The trace of one run, as Chrome trace events. Every
+   * thread that records anything gets a buffer of its own,
+   * so recording never takes a lock, and a track of its
+   * own in the viewer. Names are string literals and are
+   * only kept as pointers.
+   *
+   * Nothing is recorded unless TRACE_ENV names a file, the
+   * buffers are written to it as JSON when the process
+   * exits, so a run that ends in exit() is traced as well
+   * */
+  class TraceLog
+  {
+    public:
+      /* NOTE: Documentation
+       * true once TRACE_ENV was found set, checked once
+       * */
+      static bool enabled(void);
+
+
+      /* NOTE: Documentation
+       * Nanoseconds since the log started
+       * */
+      static std::int64_t now(void);
+
+
+      /* NOTE: Documentation
+       * A finished span on the calling thread's track, and
+       * a counter sample on it
+       * */
+      static void span(const char *, std::int64_t, std::int64_t);
+      static void counter(const char *, std::int64_t);
+  };
+
+
+  /* NOTE: Documentation
+   * Times its own lifetime as one span of the calling
+   * thread, the whole cost when tracing is off is the
+   * enabled check
+   * */
+  class TraceScope
+  {
+    private:
+      const char *name;
+      std::int64_t start;
+
+    public:
+      explicit TraceScope(const char *_name)
+        : name(_name)
+          , start(TraceLog::enabled() ? TraceLog::now() : -1)
+      { }
+
+      ~TraceScope(void)
+      {
+        if (start >= 0) { TraceLog::span(name, start, TraceLog::now()); }
+      }
+
+      TraceScope(const TraceScope &) = delete;
+      TraceScope& operator=(const TraceScope &) = delete;
+  };
+
+
+#define TRACE_JOIN(a, b) a##b
+#define TRACE_NAME(a, b) TRACE_JOIN(a, b)
+
+  /* Time the rest of the enclosing block */
+#define TRACE_SCOPE(name) GraderApplication::TraceScope TRACE_NAME(traceScope, __LINE__)(name)
+
+  /* Sample a count on the calling thread's track */
+#define TRACE_COUNTER(name, value) \
+  do { if (GraderApplication::TraceLog::enabled()) { GraderApplication::TraceLog::counter(name, value); } } while (0)
+
+#else
+
+  /* Tracing is compiled out, the arguments are never evaluated */
+#define TRACE_SCOPE(name) do { } while (0)
+#define TRACE_COUNTER(name, value) do { } while (0)
+
+#endif
+};
+
+#endif
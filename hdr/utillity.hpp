@@ -1,6 +1,7 @@
 #ifndef UTILLITY_HPP
 #define UTILLITY_HPP
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include "customExceptions.hpp"
@@ -14,61 +15,13 @@ namespace GraderApplication
    * The Utillity class is just that, a collection
    * of methods that perform generic tasks, some are already
    * featured in the C standard or C++ standard library, but
-   * have been made more robust for this projects specifications
+   * have been made more robust for this projects specifications.
+   * It holds no state, so it costs nothing in the classes built on it
    * */
   class Utillity
   {
-    protected:
-      std::string currentLine;
-
     public:
 
-      /* NOTE: Documentation
-         Default Constructor
-         */
-      Utillity(void);
-
-
-      /*
-NOTE: Documentation
-Move Constructor
-use noexcept for compiler optimizations
-*/
-      Utillity(Utillity &&) noexcept;
-
-
-      /*
-NOTE: Documentation
-Copy Constructor
-*/
-      Utillity(const Utillity &);
-
-
-      /*
-NOTE: Documentation
-Overload the move assignment
-use noexcept for compiler optimizations
-*/
-      Utillity& operator=(Utillity &&) noexcept;
-
-
-      /*
-NOTE: Documentation
-Copy assignment
-*/
-      Utillity& operator=(const Utillity &);
-
-
-      /*
-NOTE: Documentation
-Accessor: getter and setter
-stores the current line we read in,
-this is mainly for the error reporing
-*/
-      std::string currentLineContent(void) const;
-      void setCurrentLineContent(const std::string &);
-
-
       /*
 NOTE: Documentation
 Strip all comments from the line that is passed
@@ -88,14 +41,26 @@ digits
       /*
 NOTE: Documentation
 convert a string to a float with out the
-truncating limitations of stof
+truncating limitations of stof, false and 0
+if it does not start with a number
+*/
+      bool stringTofloat(const std::string &, float &);
+
+
+      /*
+NOTE: Documentation
+convert a digits and '.' string to an exact integer
+count of thousandths (FIXED_SCALE), rounding half up
+past the third decimal. 71.25 is 71250, with none of
+the error of going through a float
 */
-      float stringTofloat(const std::string &);
+      std::int64_t stringToFixed(const char *, std::size_t);
 
 
       /*
 NOTE: Documentation
-Summ all elements in array
+Summ all elements in array, with deterministicSum
+so the result never depends on how it was split up
 */
       float vecSummation(std::vector<float> &);
 
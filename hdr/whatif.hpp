@@ -0,0 +1,61 @@
+#ifndef WHATIF_HPP
+#define WHATIF_HPP
+
+#include "grader.hpp"
+
+
+/* NOTE: Documentation
+ * A what-if run takes the marks that were already
+ * parsed and graded in a Container, and regrades
+ * every student under a batch of alternative WEIGHT
+ * vectors. The marks are never re-read from disk.
+ *
+ * The scenario weights are stored column major in a
+ * single flat vector, weights[j * numScenarios + s] is
+ * the weight of evaluation column j in scenario s, so the
+ * kernel can run across a whole block of scenarios with
+ * one contiguous inner loop
+ * */
+struct WhatIfScenarios
+{
+  int numScenarios;
+  std::vector<float> weights;
+  std::vector<std::string> labels;
+
+  WhatIfScenarios(void);
+};
+
+
+/* NOTE: Documentation
+ * Read every WEIGHT line from the scenario file.
+ * The leading WEIGHT keyword is optional, comments
+ * and blank lines are ignored. A scenario that does not
+ * match the evaluation length, has non numeric data, or
+ * does not sum to 100 is reported on stderr and skipped
+ *
+ * returns the number of scenarios that were accepted
+ * */
+int loadWhatIfScenarios(EvaluationData &, const std::string &, WhatIfScenarios &);
+
+
+/* NOTE: Documentation
+ * The weighting kernel: computes the total grade of
+ * every graded student in every scenario, a batched
+ * matrix product of the mark matrix against the
+ * weight matrix.
+ *
+ * totals is laid out row major, totals[i * numScenarios + s]
+ * */
+void computeWhatIfTotals(EvaluationData &, const Container &,
+    const WhatIfScenarios &, std::vector<float> &totals);
+
+
+/* NOTE: Documentation
+ * Print the baseline letter distribution, followed by
+ * the distribution and every letter change per scenario
+ * */
+void outputWhatIf(const Container &, const WhatIfScenarios &,
+    const std::vector<float> &totals);
+
+
+#endif
@@ -0,0 +1,150 @@
+#ifndef WRITER_HPP
+#define WRITER_HPP
+
+#include <cstdint>
+#include <ostream>
+#include "grader.hpp"
+
+
+/* Rows buffered per row group by the columnar writer */
+#define COLUMNAR_GROUP 4096
+
+
+/* NOTE: Documentation
+ * The name of each ContainerSection, as every machine
+ * readable format and a pattern search print it
+ * */
+extern const char *const sectionNames[];
+
+
+/* NOTE: Documentation
+ * An output writer receives the graded data one row at
+ * a time, so rows can go out while the rest of the
+ * gradebook is still being graded. Fields are streamed
+ * straight from the StudentData accessors.
+ *
+ * begin is called once before the first row and finish
+ * once after the last, rows arrive as graded students,
+ * then withdrawn students, then errors
+ * */
+class OutputWriter
+{
+  protected:
+    std::ostream &out;
+    std::ostream &err;
+
+  public:
+    OutputWriter(std::ostream &, std::ostream &);
+    virtual ~OutputWriter(void);
+
+    virtual void begin(void);
+    virtual void writeStudent(const StudentData &) = 0;
+    virtual void writeWDR(const StudentData &) = 0;
+    virtual void writeError(const StudentData &) = 0;
+    virtual void finish(void);
+};
+
+
+/* NOTE: Documentation
+ * The original fixed width table, errors in colour
+ * on the error stream
+ * */
+class TableWriter : public OutputWriter
+{
+  private:
+    bool headerDone;
+
+  public:
+    TableWriter(std::ostream &, std::ostream &);
+
+    void writeStudent(const StudentData &) override;
+    void writeWDR(const StudentData &) override;
+    void writeError(const StudentData &) override;
+};
+
+
+/* NOTE: Documentation
+ * RFC 4180 style CSV, one table for every section.
+ * A field is only quoted if it holds a comma, a quote
+ * or a line break
+ * */
+class CsvWriter : public OutputWriter
+{
+  private:
+    void writeRow(const char *, const StudentData &);
+
+  public:
+    CsvWriter(std::ostream &, std::ostream &);
+
+    void begin(void) override;
+    void writeStudent(const StudentData &) override;
+    void writeWDR(const StudentData &) override;
+    void writeError(const StudentData &) override;
+};
+
+
+/* NOTE: Documentation
+ * One JSON object per line, strings are only run
+ * through the escaper when they hold a character
+ * that needs it
+ * */
+class JsonLinesWriter : public OutputWriter
+{
+  private:
+    void writeRow(const char *, const StudentData &);
+
+  public:
+    JsonLinesWriter(std::ostream &, std::ostream &);
+
+    void writeStudent(const StudentData &) override;
+    void writeWDR(const StudentData &) override;
+    void writeError(const StudentData &) override;
+};
+
+
+/* NOTE: Documentation
+ * Little endian columnar binary. The file starts with
+ * the magic GRDC and a u16 version, then row groups of
+ * up to COLUMNAR_GROUP rows, each a u32 row count then
+ * the columns in this order:
+ *
+ *   section   u8    0 graded, 1 withdrawn, 2 error
+ *   line      u32   line number in the input
+ *   lab, assign, midterm, final, total   f32 each
+ *   letter    u8    Echelon order A+ = 0 .. F = 10, 11 WDR, 255 none
+ *   name, error, content   u32 offsets[rows + 1] then the bytes
+ *
+ * a row count of 0 ends the file
+ * */
+class ColumnarWriter : public OutputWriter
+{
+  private:
+    std::vector<std::uint8_t> section;
+    std::vector<std::uint32_t> line;
+    std::vector<float> scores[5];
+    std::vector<std::uint8_t> letter;
+    std::vector<std::uint32_t> offsets[3];
+    std::string text[3];
+
+    void addRow(std::uint8_t, const StudentData &);
+    void flushGroup(void);
+
+  public:
+    ColumnarWriter(std::ostream &, std::ostream &);
+
+    void begin(void) override;
+    void writeStudent(const StudentData &) override;
+    void writeWDR(const StudentData &) override;
+    void writeError(const StudentData &) override;
+    void finish(void) override;
+};
+
+
+/* NOTE: Documentation
+ * Writer for a --format name: table, csv, jsonl or
+ * columnar. returns nullptr for anything else
+ * */
+OutputWriter *makeWriter(const std::string &, std::ostream &, std::ostream &);
+
+
+#endif
@@ -27,3 +27,19 @@ if [[ -d "$GRADER_BIN" ]]; then
 else
   printf "Nothing to do for ==> %s\n" "$GRADER_BIN"
 fi
+
+# check if library object directory exits
+if [[ -d "$GRADER_OBJL" ]]; then
+  printf "Removing Object Files Library Directory\n"
+  rm -rf "$GRADER_OBJL"
+else
+  printf "Nothing to do for ==> %s\n" "$GRADER_OBJL"
+fi
+
+# check if library directory exits
+if [[ -d "$GRADER_LIB" ]]; then
+  printf "Removing Library Directory\n"
+  rm -rf "$GRADER_LIB"
+else
+  printf "Nothing to do for ==> %s\n" "$GRADER_LIB"
+fi
@@ -5,8 +5,12 @@
 GRADER_OBJ="obj"
 GRADER_OBJD="objd"
 GRADER_BIN="bin"
+GRADER_OBJL="objl"
+GRADER_LIB="lib"
 
 # export as environment variables for other scripts
 export GRADER_OBJ
 export GRADER_OBJD
 export GRADER_BIN
+export GRADER_OBJL
+export GRADER_LIB
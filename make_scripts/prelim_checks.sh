@@ -2,7 +2,7 @@
 
 # This is a helper build script for the root project makefile
 # A build rule will only be triggered if the script is called with
-# either '-r' for release or '-d' for debug
+# either '-r' for release, '-d' for debug or '-l' for the library
 
 # since the root makefile will be calling the scripts
 # the path must be sourced from the makefiles position
@@ -36,6 +36,21 @@ function trigger_debug() {
 }
 
 
+function trigger_library() {
+  # check if library object directory exits
+  if [[ ! -d "$GRADER_OBJL" ]]; then
+    printf "Creating Object Library Files Directory\n"
+    mkdir "$GRADER_OBJL"
+  fi
+
+  # build the library directory
+  if [[ ! -d "$GRADER_LIB" ]]; then
+    printf "Creating Library Directory\n"
+    mkdir "$GRADER_LIB"
+  fi
+}
+
+
 function trigger_binary() {
   # build the binary directory
   if [[ ! -d "$GRADER_BIN" ]]; then
@@ -52,8 +67,10 @@ if [[ "$#" -eq 1 ]]; then
       trigger_release
     elif [[ "$arg" == "-d" ]]; then
       trigger_debug
+    elif [[ "$arg" == "-l" ]]; then
+      trigger_library
     else
-      printf "%s accepts only one Argument:\n -r : release\n-d : debug\n" "$0"
+      printf "%s accepts only one Argument:\n -r : release\n-d : debug\n-l : library\n" "$0"
     fi
   done
 fi
@@ -0,0 +1,100 @@
+""" grader must give the same report for a gzip or zstd copy of a file """
+#!/usr/bin/env python3
+
+# imports
+import glob
+import gzip
+import os
+import shutil
+import subprocess as sc
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+GRADER = os.path.join(ROOT, 'bin', 'grader')
+FIXTURES = [os.path.join(ROOT, 'test_files', 'standard.txt')] + \
+    sorted(glob.glob(os.path.join(ROOT, 'test_files', 'In', '*', '*.txt')))
+
+
+def run(args: list):
+    """ stdout and stderr of one grader run """
+    result = sc.run([GRADER] + args, capture_output=True, check=False)
+    return result.stdout, result.stderr
+
+
+def zstd_supported(work: str):
+    """ the zstd CLI is there and grader was built with ZSTD=1 """
+    zstd = shutil.which('zstd')
+    if not zstd:
+        return False
+    probe = os.path.join(work, 'probe.zst')
+    sc.run([zstd, '-q', '-f', FIXTURES[0], '-o', probe], check=True)
+    _, err = run([probe])
+    return b'ZSTD=1' not in err
+
+
+def build_fixtures(source: str, work: str, with_zstd: bool):
+    """ every compressed copy of source this machine can build """
+    with open(source, 'rb') as handle:
+        data = handle.read()
+    name = os.path.join(work, os.path.basename(source))
+    copies = []
+
+    with gzip.open(name + '.gz', 'wb') as handle:
+        handle.write(data)
+    copies.append(name + '.gz')
+
+    # two gzip members back to back, split mid line
+    half = len(data) // 2
+    with open(name + '.2.gz', 'wb') as handle:
+        handle.write(gzip.compress(data[:half]) + gzip.compress(data[half:]))
+    copies.append(name + '.2.gz')
+
+    zstd = shutil.which('zstd')
+    if with_zstd:
+        sc.run([zstd, '-q', '-f', source, '-o', name + '.zst'], check=True)
+        copies.append(name + '.zst')
+        # one frame per line, so the frames decompress in parallel
+        with open(name + '.frames.zst', 'wb') as out:
+            for line in data.splitlines(keepends=True):
+                out.write(sc.run([zstd, '-q', '-c'], input=line,
+                                 capture_output=True, check=True).stdout)
+        copies.append(name + '.frames.zst')
+    return copies
+
+
+def main():
+    """ Entry point """
+    work = tempfile.mkdtemp()
+    with_zstd = zstd_supported(work)
+    if not with_zstd:
+        print("zstd copies skipped, needs the zstd CLI and a ZSTD=1 build")
+    failures = []
+    checked = 0
+    for source in FIXTURES:
+        expected = run([source])
+        streamed = run(['--stream', '2', source])
+        for copy in build_fixtures(source, work, with_zstd):
+            if run([copy]) != expected or run(['--stream', '2', copy]) != streamed:
+                failures.append(copy)
+            checked += 1
+
+    # a damaged file is reported, not graded
+    broken = os.path.join(work, 'broken.gz')
+    with open(broken, 'wb') as handle:
+        handle.write(gzip.compress(b'TITLE A\n' * 100)[:20])
+    out, err = run([broken])
+    if b'gzip' not in err or out:
+        failures.append(broken)
+
+    shutil.rmtree(work)
+    print(f"compressed copies checked: {checked}")
+    if failures:
+        print("FAILED:")
+        print("\n".join(failures))
+        sys.exit(1)
+    print("PASSED")
+
+
+if __name__ == '__main__':
+    main()
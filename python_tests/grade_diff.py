@@ -0,0 +1,127 @@
+""" --diff must list exactly the students whose grading changed between two gradebooks """
+#!/usr/bin/env python3
+
+# imports
+import os
+import random
+import shutil
+import struct
+import subprocess as sc
+import sys
+import tempfile
+
+from where_filter import MAX_MARKS, TITLES, CATEGORIES, WEIGHTS, columnar
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+GRADER = os.path.join(ROOT, 'bin', 'grader')
+STUDENTS = 20000
+SCORES = ['lab', 'assign', 'midterm', 'final', 'total']
+
+
+def f32(value: float):
+    """ value rounded to a float, as the grader holds it """
+    return struct.unpack('<f', struct.pack('<f', value))[0]
+
+
+def write(path: str, rows: list):
+    """ a gradebook of rows """
+    header = ['TITLE ' + ' '.join(TITLES), 'CATEGORY ' + ' '.join(CATEGORIES),
+              'MAXMARK ' + ' '.join(map(str, MAX_MARKS)), 'WEIGHT ' + ' '.join(map(str, WEIGHTS))]
+    with open(path, 'w', encoding='utf-8') as handle:
+        handle.write('\n'.join(header + rows) + '\n')
+
+
+def gradebooks(work: str, rng: random.Random):
+    """ an old gradebook and a corrected one """
+    old = []
+    for i in range(STUDENTS):
+        marks = [f'{rng.uniform(0, top):.{rng.randrange(3)}f}' for top in MAX_MARKS]
+        if rng.random() < 0.02:
+            marks[rng.randrange(len(marks))] = 'WDR'
+        old.append([f's{i}'] + marks)
+
+    new = []
+    for row in old:
+        roll = rng.random()
+        row = list(row)
+        if roll < 0.01:
+            continue
+        if roll < 0.05:
+            column = rng.randrange(1, len(row))
+            row[column] = f'{rng.uniform(0, MAX_MARKS[column - 1]):.2f}'
+        elif roll < 0.06:
+            row[rng.randrange(1, len(row))] = 'WDR'
+        elif roll < 0.065:
+            row.pop()
+        new.append(row)
+    rng.shuffle(new)
+    new += [[f'new{i}'] + ['1'] * len(MAX_MARKS) for i in range(30)]
+
+    paths = [os.path.join(work, 'old.txt'), os.path.join(work, 'new.txt')]
+    write(paths[0], [' '.join(r) for r in old])
+    write(paths[1], [' '.join(r) for r in new])
+    return paths
+
+
+def expected(paths: list):
+    """ the changes, by id, from the two columnar reports """
+    sides = []
+    for path in paths:
+        run = sc.run([GRADER, '--format', 'columnar', path], capture_output=True, check=True)
+        sides.append({r['name']: r for r in columnar(run.stdout)})
+    old, new = sides
+    changes = {}
+    for sid, after in new.items():
+        before = old.get(sid)
+        if before is None:
+            changes[sid] = ('added', None)
+        elif before['section'] != after['section'] or before['letter'] != after['letter'] \
+                or any(before[s] != after[s] for s in SCORES):
+            both = before['section'] == after['section'] == 'graded'
+            changes[sid] = ('changed', [f'{f32(after[s] - before[s]):+.2f}' for s in SCORES]
+                            if both else None)
+    for sid in old:
+        if sid not in new:
+            changes[sid] = ('removed', None)
+    return changes
+
+
+def main():
+    """ Entry point """
+    rng = random.Random(46)
+    work = tempfile.mkdtemp()
+    paths = gradebooks(work, rng)
+    want = expected(paths)
+
+    failures = []
+    for threads in ('1', '3'):
+        run = sc.run([GRADER, '--threads', threads, '--diff'] + paths, capture_output=True,
+                     check=True)
+        lines = run.stdout.decode().splitlines()
+        got = {}
+        for line in lines[1:-1]:
+            fields = line.split()
+            got[fields[1]] = (fields[0], fields[2:7])
+        for sid, (change, deltas) in want.items():
+            if sid not in got or got[sid][0] != change:
+                failures.append(f'{threads} threads: {sid} should be {change}')
+            elif deltas is not None and got[sid][1] != deltas:
+                failures.append(f'{threads} threads: {sid} deltas {got[sid][1]}, expected {deltas}')
+        failures += [f'{threads} threads: {sid} listed' for sid in got if sid not in want]
+
+        counts = [sum(1 for c, _ in want.values() if c == kind)
+                  for kind in ('added', 'removed', 'changed')]
+        if not lines[-1].startswith('Added: %d  Removed: %d  Changed: %d' % tuple(counts)):
+            failures.append(f'{threads} threads: summary {lines[-1]}')
+
+    shutil.rmtree(work)
+    print(f"students compared: {STUDENTS}, changes: {len(want)}")
+    if failures:
+        print("FAILED:")
+        print("\n".join(failures[:20]))
+        sys.exit(1)
+    print("PASSED")
+
+
+if __name__ == '__main__':
+    main()
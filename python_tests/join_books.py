@@ -0,0 +1,143 @@
+""" --join of several gradebooks must grade as the one gradebook they make up """
+#!/usr/bin/env python3
+
+# imports
+import gzip
+import os
+import random
+import shutil
+import subprocess as sc
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+GRADER = os.path.join(ROOT, 'bin', 'grader')
+# enough rows that the join spreads them over more than one partition
+STUDENTS = 200000
+
+# title, category, max mark, weight of every column, and the file it comes in
+COLUMNS = [('Lab1', 'Lab', 10, 5, 0), ('Lab2', 'Lab', 10, 5, 0), ('Lab3', 'Lab', 10, 5, 0),
+           ('Lab4', 'Lab', 10, 5, 0), ('Assign1', 'Assign', 15, 10, 1),
+           ('Assign2', 'Assign', 20, 10, 1), ('Midterm', 'Midterm', 40, 20, 2),
+           ('FinalExam', 'Final', 90, 40, 2)]
+FILES = 3
+POLICIES = ['DROP Lab 1\n', '', '']
+
+
+def header(columns: list):
+    """ the four header lines of some columns """
+    return ['TITLE ' + ' '.join(c[0] for c in columns),
+            'CATEGORY ' + ' '.join(c[1] for c in columns),
+            'MAXMARK ' + ' '.join(str(c[2]) for c in columns),
+            'WEIGHT ' + ' '.join(str(c[3]) for c in columns)]
+
+
+def books(work: str, rng: random.Random):
+    """ the part files, and the one gradebook joining them must give """
+    parts = [[c for c in COLUMNS if c[4] == f] for f in range(FILES)]
+    rows = [[] for _ in range(FILES)]
+    missing = set()
+    for i in range(STUDENTS):
+        sid = f's{i}'
+        for f in range(FILES):
+            marks = [f'{rng.uniform(0, c[2]):.{rng.randrange(3)}f}' for c in parts[f]]
+            if rng.random() < 0.01:
+                marks[0] = rng.choice(['WDR', 'EX', 'x'])
+            if rng.random() < 0.005:
+                missing.add((sid, f))
+                continue
+            rows[f].append(f'{sid} ' + ' '.join(marks))
+            if rng.random() < 0.001:
+                rows[f].append(f'{sid} ' + ' '.join(marks[::-1]))
+
+    # ids only a later file has come after the first file's, in its order
+    for f in range(1, FILES):
+        rng.shuffle(rows[f])
+        for extra in range(50):
+            sid = f'late{f}_{extra}'
+            rows[f].append(f'{sid} ' + ' '.join('1' for _ in parts[f]))
+            missing.update((sid, g) for g in range(FILES) if g != f)
+
+    # the first row of an id in each file is the one joined
+    order = list(dict.fromkeys(r.split(' ', 1)[0] for part in rows for r in part))
+    joined = {sid: [] for sid in order}
+    for part in rows:
+        first = {}
+        for r in part:
+            first.setdefault(r.split(' ', 1)[0], r.split(' ')[1:])
+        for sid, marks in first.items():
+            joined[sid] += marks
+
+    paths = []
+    for f in range(FILES):
+        text = '# part %d\n' % f + '\n'.join(header(parts[f])) + '\n' + POLICIES[f] \
+            + '\n' + '\n'.join(rows[f]) + '\n'
+        path = os.path.join(work, f'part{f}.txt' + ('.gz' if f == 1 else ''))
+        with (gzip.open if f == 1 else open)(path, 'wt', encoding='utf-8') as handle:
+            handle.write(text)
+        paths.append(path)
+
+    whole = os.path.join(work, 'whole.txt')
+    with open(whole, 'w', encoding='utf-8') as handle:
+        handle.write('\n'.join(header(COLUMNS)) + '\n' + ''.join(POLICIES))
+        for sid in order:
+            handle.write(' '.join([sid] + joined[sid]) + '\n')
+    return paths, whole, missing
+
+
+def main():
+    """ Entry point """
+    rng = random.Random(45)
+    work = tempfile.mkdtemp()
+    paths, whole, missing = books(work, rng)
+
+    failures = []
+    for args in (['--format', 'csv'], ['--stats'], ['--threads', '4', '--format', 'csv']):
+        want = sc.run([GRADER] + args + [whole], capture_output=True, check=True).stdout
+        run = sc.run([GRADER] + args + ['--join'] + paths, capture_output=True, check=True)
+        if run.stdout != want:
+            failures.append(f'{" ".join(args)}: joined report differs')
+
+    # every missing id is named once for every file that lacks it
+    reported = set()
+    for line in run.stderr.decode().splitlines():
+        if 'Missing from ' in line:
+            text = line.replace('\x1b[0m', '').replace('\x1b[1;33m', '').replace('\x1b[1;37m', '')
+            name, sid = text[len('Missing from '):].rsplit(': ', 1)
+            reported.add((sid, paths.index(name)))
+    if reported != missing:
+        failures.append(f'{len(reported)} ids reported missing, expected {len(missing)}')
+
+    # a part with a short header is refused and named
+    with open(paths[0], encoding='utf-8') as handle:
+        lines = handle.read().split('\n')
+    broken = os.path.join(work, 'broken.txt')
+    with open(broken, 'w', encoding='utf-8') as handle:
+        handle.write('\n'.join(lines[:3] + lines[5:]))
+    run = sc.run([GRADER, '--join', broken] + paths[1:], capture_output=True, check=False)
+    if run.returncode == 0 or run.stdout or broken.encode() not in run.stderr:
+        failures.append('a part with a short header was not refused')
+
+    # a policy may not reach another part's columns, both parts are named
+    for first, second in ((['DROP Lab 1'], ['DROP Lab 1']), (['DROP Lab 1'], []),
+                          ([], ['BEST Lab 2'])):
+        pair = []
+        for name, policy in (('labs_a.txt', first), ('labs_b.txt', second)):
+            pair.append(os.path.join(work, name))
+            with open(pair[-1], 'w', encoding='utf-8') as handle:
+                handle.write('\n'.join(header(COLUMNS[:4]) + policy + ['s1 1 2 3 4']) + '\n')
+        run = sc.run([GRADER, '--join'] + pair, capture_output=True, check=False)
+        if run.returncode == 0 or run.stdout or not all(p.encode() in run.stderr for p in pair):
+            failures.append(f'a policy across parts was not refused: {first} {second}')
+
+    shutil.rmtree(work)
+    print(f"students joined: {STUDENTS}, missing from a part: {len(missing)}")
+    if failures:
+        print("FAILED:")
+        print("\n".join(failures))
+        sys.exit(1)
+    print("PASSED")
+
+
+if __name__ == '__main__':
+    main()
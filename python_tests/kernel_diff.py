@@ -0,0 +1,81 @@
+""" the fixed width row kernels must grade bit for bit as the any width one """
+#!/usr/bin/env python3
+
+# imports
+import os
+import random
+import shutil
+import subprocess as sc
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+GRADER = os.path.join(ROOT, 'bin', 'grader')
+WIDTHS = [1, 5, 7, 8, 9, 11, 12, 13, 16, 17, 23, 24, 25, 31]
+CATEGORIES = ['Lab', 'Assign', 'Midterm', 'Final', 'Quiz']
+STUDENTS = 3000
+
+
+def header(width: int, rng: random.Random):
+    """ header lines for width columns, weights summing to 100 """
+    categories = [rng.choice(CATEGORIES) for _ in range(width)]
+    max_marks = [rng.choice([5, 10, 12.5, 15, 40, 90]) for _ in range(width)]
+    cuts = sorted(rng.sample(range(1, 100), width - 1)) if width > 1 else []
+    weights = [b - a for a, b in zip([0] + cuts, cuts + [100])]
+    lines = ['TITLE ' + ' '.join(f'C{j}' for j in range(width)),
+             'CATEGORY ' + ' '.join(categories),
+             'MAXMARK ' + ' '.join(str(m) for m in max_marks),
+             'WEIGHT ' + ' '.join(str(w) for w in weights)]
+    if rng.random() < 0.5:
+        lines.append(f'DROP {categories[0]} 1' if categories.count(categories[0]) > 1
+                     else f'BEST {categories[0]} 1')
+    return lines, max_marks
+
+
+def gradebook(path: str, width: int, rng: random.Random):
+    """ a class with awkward decimals and a few exemptions """
+    lines, max_marks = header(width, rng)
+    for i in range(STUDENTS):
+        marks = [f'{rng.uniform(0, top):.{rng.randrange(4)}f}' for top in max_marks]
+        if rng.random() < 0.05:
+            marks[rng.randrange(width)] = 'EX'
+        lines.append(f's{i} ' + ' '.join(marks))
+    with open(path, 'w', encoding='utf-8') as handle:
+        handle.write('\n'.join(lines) + '\n')
+
+
+def run(args: list, kernel: str):
+    """ stdout of one grader run, with the kernel forced or not """
+    env = dict(os.environ)
+    env.pop('GRADER_KERNEL', None)
+    if kernel:
+        env['GRADER_KERNEL'] = kernel
+    return sc.run([GRADER] + args, capture_output=True, check=True, env=env).stdout
+
+
+def main():
+    """ Entry point """
+    rng = random.Random(43)
+    work = tempfile.mkdtemp()
+    failures = []
+    checked = 0
+    for width in WIDTHS:
+        book = os.path.join(work, f'w{width}.txt')
+        gradebook(book, width, rng)
+        # columnar rows hold the raw floats, --stats the mean to every digit
+        for args in (['--format', 'columnar'], ['--stats'], ['--threads', '3', '--stats']):
+            if run(args + [book], '') != run(args + [book], 'generic'):
+                failures.append(f'{width} columns: {" ".join(args)}')
+            checked += 1
+
+    shutil.rmtree(work)
+    print(f"runs compared: {checked}")
+    if failures:
+        print("FAILED:")
+        print("\n".join(failures))
+        sys.exit(1)
+    print("PASSED")
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,166 @@
+""" libgrader must give the same rows as the csv report, from a file and from memory """
+#!/usr/bin/env python3
+
+# imports
+import csv
+import ctypes
+import glob
+import io
+import os
+import shutil
+import subprocess as sc
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+GRADER = os.path.join(ROOT, 'bin', 'grader')
+LIBRARY = os.path.join(ROOT, 'lib', 'libgrader.so')
+FIXTURES = [os.path.join(ROOT, 'test_files', 'standard.txt')] + \
+    sorted(glob.glob(os.path.join(ROOT, 'test_files', 'In', '*', '*.txt')))
+
+GRADER_OK = 0
+GRADER_BAD_HEADER = 2
+GRADER_NO_STUDENT = 4
+GRADER_FIXED_POINT = 1
+SECTIONS = ['graded', 'wdr', 'error']
+
+# ids on more than one row, -s and grader_find must pick the same one
+REPEATED = b"""TITLE Lab1 FinalExam
+CATEGORY Lab Final
+MAXMARK 10 10
+WEIGHT 50 50
+s1 1 1
+s1 9 9
+s2 WDR 1
+s2 1 2 3
+s3 2 2
+s3 x 1
+s3 4 4
+"""
+
+
+class Result(ctypes.Structure):
+    """ grader_result """
+    _fields_ = [('id', ctypes.c_char_p), ('section', ctypes.c_int), ('line', ctypes.c_int),
+                ('lab', ctypes.c_float), ('assign', ctypes.c_float),
+                ('midterm', ctypes.c_float), ('final_exam', ctypes.c_float),
+                ('total', ctypes.c_float), ('letter', ctypes.c_char_p),
+                ('error', ctypes.c_char_p)]
+
+
+def load():
+    """ the shared library with its signatures """
+    lib = ctypes.CDLL(LIBRARY)
+    book = ctypes.c_void_p
+    lib.grader_open_file.argtypes = [ctypes.c_char_p, ctypes.c_uint, ctypes.POINTER(book)]
+    lib.grader_open_buffer.argtypes = [ctypes.c_char_p, ctypes.c_size_t, ctypes.c_uint,
+                                       ctypes.POINTER(book)]
+    lib.grader_grade.argtypes = [book, ctypes.c_int]
+    lib.grader_count.argtypes = [book]
+    lib.grader_count.restype = ctypes.c_size_t
+    lib.grader_result_at.argtypes = [book, ctypes.c_size_t, ctypes.POINTER(Result)]
+    lib.grader_find.argtypes = [book, ctypes.c_char_p, ctypes.POINTER(Result)]
+    lib.grader_error.argtypes = [book]
+    lib.grader_error.restype = ctypes.c_char_p
+    lib.grader_close.argtypes = [book]
+    return lib
+
+
+def row(r: Result):
+    """ a result as the csv report prints it """
+    section = SECTIONS[r.section]
+    if section == 'error':
+        scores = [''] * 5 + ['']
+    else:
+        scores = [f'{v:.2f}' for v in (r.lab, r.assign, r.midterm, r.final_exam, r.total)]
+        scores.append(r.letter.decode())
+    return [section, r.id.decode(), str(r.line)] + scores + \
+        [r.error.decode() if r.error else '']
+
+
+def report(path: str, args: list):
+    """ the csv rows of bin/grader, or None if it refused the header """
+    run = sc.run([GRADER, '--format', 'csv'] + args + [path], capture_output=True, check=False)
+    if run.returncode != 0:
+        return None
+    return [r[:10] for r in csv.reader(io.StringIO(run.stdout.decode()))][1:]
+
+
+def grade(lib, opener, options: int):
+    """ rows of one book, None if the header was rejected """
+    book = ctypes.c_void_p()
+    status = opener(options, ctypes.byref(book))
+    try:
+        if status == GRADER_BAD_HEADER:
+            return None, book
+        assert status == GRADER_OK, lib.grader_error(book)
+        assert lib.grader_grade(book, 3) == GRADER_OK
+        rows = []
+        for i in range(lib.grader_count(book)):
+            r = Result()
+            assert lib.grader_result_at(book, i, ctypes.byref(r)) == GRADER_OK
+            rows.append(row(r))
+            found = Result()
+            assert lib.grader_find(book, r.id, ctypes.byref(found)) == GRADER_OK
+        missing = Result()
+        assert lib.grader_find(book, b'no such id', ctypes.byref(missing)) == GRADER_NO_STUDENT
+        return rows, book
+    finally:
+        lib.grader_close(book)
+
+
+def repeated(lib):
+    """ ids grader_find and -s do not agree on """
+    path = os.path.join(tempfile.mkdtemp(), 'repeated.txt')
+    with open(path, 'wb') as handle:
+        handle.write(REPEATED)
+    book = ctypes.c_void_p()
+    assert lib.grader_open_buffer(REPEATED, len(REPEATED), 0, ctypes.byref(book)) == GRADER_OK
+    assert lib.grader_grade(book, 1) == GRADER_OK
+    differ = []
+    try:
+        for sid in (b's1', b's2', b's3'):
+            found = Result()
+            assert lib.grader_find(book, sid, ctypes.byref(found)) == GRADER_OK
+            run = sc.run([GRADER, '-s', sid.decode(), path], capture_output=True, check=True)
+            fields = run.stdout.decode().splitlines()[1].split()
+            if [fields[5], fields[6]] != [f'{found.total:.2f}', found.letter.decode()]:
+                differ.append(sid.decode())
+    finally:
+        lib.grader_close(book)
+        shutil.rmtree(os.path.dirname(path))
+    return differ
+
+
+def main():
+    """ Entry point """
+    lib = load()
+    failures = [f'{sid}: grader_find and -s differ' for sid in repeated(lib)]
+    checked = 0
+    for path in FIXTURES:
+        with open(path, 'rb') as handle:
+            data = handle.read()
+        for options, args in ((0, []), (GRADER_FIXED_POINT, ['--fixed-point'])):
+            expected = report(path, args)
+            from_file, _ = grade(lib, lambda o, b: lib.grader_open_file(path.encode(), o, b), options)
+            from_memory, _ = grade(lib, lambda o, b: lib.grader_open_buffer(data, len(data), o, b),
+                                   options)
+            # the binary and the library refuse the same headers
+            if (from_file is None) != (expected is None):
+                failures.append(f'{path} {args}: header refused by only one')
+            elif from_file != expected:
+                failures.append(f'{path} {args}: rows differ')
+            if from_file != from_memory:
+                failures.append(f'{path} {args}: file and memory differ')
+            checked += 1
+
+    print(f"gradebooks checked: {checked}")
+    if failures:
+        print("FAILED:")
+        print("\n".join(failures))
+        sys.exit(1)
+    print("PASSED")
+
+
+if __name__ == '__main__':
+    main()
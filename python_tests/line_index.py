@@ -0,0 +1,114 @@
+""" -s through a .gidx index must answer exactly as reading every line does """
+#!/usr/bin/env python3
+
+# imports
+import gzip
+import os
+import random
+import shutil
+import subprocess as sc
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+GRADER = os.path.join(ROOT, 'bin', 'grader')
+STUDENTS = 5000
+SEARCHES = 400
+
+HEADER = ['# indexed gradebook',
+          'TITLE Lab1 Lab2 Lab3 Assign1 Midterm FinalExam',
+          'CATEGORY Lab Lab Lab Assign Midterm Final',
+          'MAXMARK 10 10 10 20 40 90',
+          'WEIGHT 10 10 10 15 20 35',
+          '',
+          'DROP Lab 1']
+
+
+def gradebook(rng: random.Random):
+    """ student lines with repeats, withdrawals, errors, comments and blank lines """
+    rows = []
+    for i in range(STUDENTS):
+        marks = [f'{rng.uniform(0, m):.1f}' for m in (10, 10, 10, 20, 40, 90)]
+        roll = rng.random()
+        if roll < 0.03:
+            marks[rng.randrange(len(marks))] = 'WDR'
+        elif roll < 0.05:
+            marks[rng.randrange(len(marks))] = 'x'
+        elif roll < 0.06:
+            marks.pop()
+        elif roll < 0.07:
+            marks[0] = 'EX'
+        line = ' '.join([f's{i}'] + marks)
+        if rng.random() < 0.05:
+            line += '  # checked'
+        rows.append(line)
+
+        # the same line again, or the same id with other marks
+        if rng.random() < 0.02:
+            rows.append(line)
+        if rng.random() < 0.02:
+            rows.append(' '.join([f's{i}'] + [f'{rng.uniform(0, 5):.1f}' for _ in range(6)]))
+        if rng.random() < 0.01:
+            rows.append('')
+    return rows
+
+
+def search(path: str, sid: str):
+    """ everything -s prints, and how it exits """
+    run = sc.run([GRADER, path, '-s', sid], capture_output=True, check=False)
+    return run.returncode, run.stdout, run.stderr
+
+
+def main():
+    """ Entry point """
+    rng = random.Random(47)
+    work = tempfile.mkdtemp()
+    path = os.path.join(work, 'book.txt')
+    with open(path, 'w', encoding='utf-8') as handle:
+        handle.write('\n'.join(HEADER + gradebook(rng)) + '\n')
+
+    ids = [f's{rng.randrange(STUDENTS)}' for _ in range(SEARCHES)] + ['nobody', 's', 's1x']
+    failures = []
+    scanned = {sid: search(path, sid) for sid in ids}
+    report = sc.run([GRADER, '--format', 'csv', path], capture_output=True, check=True).stdout
+
+    run = sc.run([GRADER, '--index', path], capture_output=True, check=True)
+    if not os.path.exists(path + '.gidx') or b'student lines' not in run.stdout:
+        failures.append('no index written')
+    for sid in ids:
+        if search(path, sid) != scanned[sid]:
+            failures.append(f'{sid}: indexed search differs')
+    if sc.run([GRADER, '--format', 'csv', path], capture_output=True, check=True).stdout != report:
+        failures.append('full report differs with an index')
+
+    # a touched gradebook keeps its index, an edited one falls back to reading every line
+    os.utime(path)
+    if search(path, ids[0]) != scanned[ids[0]]:
+        failures.append('touched gradebook: search differs')
+    with open(path, 'a', encoding='utf-8') as handle:
+        handle.write(f'{ids[1]} 1 1 1 1 1 1\n')
+    stale = search(path, ids[1])
+    os.rename(path + '.gidx', path + '.old')
+    fresh = search(path, ids[1])
+    if b'Index out of date' not in stale[2] or stale[:2] != fresh[:2] or fresh == scanned[ids[1]]:
+        failures.append('stale index was used')
+
+    # only plain gradebooks are indexed
+    packed = path + '.gz'
+    with open(path, 'rb') as plain, gzip.open(packed, 'wb') as handle:
+        handle.write(plain.read())
+    run = sc.run([GRADER, '--index', packed], capture_output=True, check=False)
+    if run.returncode == 0 or os.path.exists(packed + '.gidx'):
+        failures.append('a compressed gradebook was indexed')
+
+    shutil.rmtree(work)
+    print(f"students: {STUDENTS}, searches: {len(ids)}")
+    if failures:
+        print("FAILED:")
+        print("\n".join(failures[:20]))
+        sys.exit(1)
+    print("PASSED")
+
+
+if __name__ == '__main__':
+    main()
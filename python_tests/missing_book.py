@@ -0,0 +1,43 @@
+""" A gradebook that can not be opened must be reported once, and the run must fail """
+#!/usr/bin/env python3
+
+# imports
+import os
+import subprocess as sc
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+GRADER = os.path.join(ROOT, 'bin', 'grader')
+MISSING = os.path.join(ROOT, 'test_files', 'no_such_gradebook.txt')
+MODES = [[], ['-s', 'x'], ['--stats'], ['--stream', '3'], ['--pipeline'], ['--where', 'total>1'],
+         ['--threads', '3'], ['--fixed-point']]
+
+
+def main():
+    """ Entry point """
+    failures = []
+    work = tempfile.mkdtemp()
+    for mode in MODES:
+        run = sc.run([GRADER] + mode + [MISSING], capture_output=True, check=False, cwd=work)
+        name = ' '.join(mode) or 'report'
+        if run.returncode != 1:
+            failures.append(f'{name}: exited {run.returncode}')
+        if run.stdout:
+            failures.append(f'{name}: wrote a report')
+        if run.stderr.decode().count('File Not Found') != 1:
+            failures.append(f'{name}: not reported exactly once')
+        if os.listdir(work):
+            failures.append(f'{name}: left files behind')
+
+    os.rmdir(work)
+    print(f"modes: {len(MODES)}")
+    if failures:
+        print("FAILED:")
+        print("\n".join(failures))
+        sys.exit(1)
+    print("PASSED")
+
+
+if __name__ == '__main__':
+    main()
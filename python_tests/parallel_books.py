@@ -0,0 +1,122 @@
+""" many in-memory gradebooks graded at once must match grading them one by one """
+#!/usr/bin/env python3
+
+# imports
+import ctypes
+import os
+import random
+import sys
+import tempfile
+from concurrent.futures import ThreadPoolExecutor
+
+from library_api import GRADER_BAD_HEADER, GRADER_FIXED_POINT, GRADER_OK, Result, load, row
+
+BOOKS = 1000
+WORKERS = 16
+
+TITLES = ['Lab1', 'Lab2', 'Assign1', 'Midterm', 'Lab3', 'Lab4', 'Assign2', 'FinalExam']
+CATEGORIES = ['Lab', 'Lab', 'Assign', 'Midterm', 'Lab', 'Lab', 'Assign', 'Final']
+MAX_MARKS = [10, 10, 15, 40, 10, 10, 20, 90]
+WEIGHTS = [5, 5, 10, 20, 5, 5, 10, 40]
+
+
+def gradebook(rng: random.Random):
+    """ bytes of one gradebook and whether its header is broken """
+    lines = ['TITLE ' + ' '.join(TITLES), 'CATEGORY ' + ' '.join(CATEGORIES),
+             'MAXMARK ' + ' '.join(map(str, MAX_MARKS)), 'WEIGHT ' + ' '.join(map(str, WEIGHTS))]
+    broken = rng.random() < 0.1
+    if broken:
+        fault = rng.randrange(5)
+        if fault == 0:
+            lines.pop(rng.randrange(len(lines)))
+        elif fault == 1:
+            lines[3] = 'WEIGHT 5 5 10 20 5 5 10 90'
+        elif fault == 2:
+            lines.append('DROP Quiz 1')
+        elif fault == 3:
+            # all digits and dots, but not a number
+            lines[2] = 'MAXMARK 10 10 15 40 10 10 20 .'
+        else:
+            lines[3] = 'WEIGHT 5 5 10 20 5 5 . 40'
+    elif rng.random() < 0.3:
+        lines.append(rng.choice(['DROP Lab 1', 'BEST Assign 1', 'DROP Lab 2']))
+
+    for i in range(rng.randrange(0, 60)):
+        marks = [f'{rng.uniform(0, top):.{rng.randrange(4)}f}' for top in MAX_MARKS]
+        roll = rng.random()
+        if roll < 0.05:
+            marks[rng.randrange(len(marks))] = 'WDR'
+        elif roll < 0.10:
+            marks[rng.randrange(len(marks))] = 'EX'
+        elif roll < 0.13:
+            marks.pop()
+        elif roll < 0.15:
+            marks[rng.randrange(len(marks))] = 'x'
+        lines.append(f's{i} ' + ' '.join(marks))
+    return ('\n'.join(lines) + '\n').encode(), broken
+
+
+def grade(lib, data: bytes, options: int, threads: int):
+    """ status, error and rows of one book, loaded and graded from memory """
+    book = ctypes.c_void_p()
+    status = lib.grader_open_buffer(data, len(data), options, ctypes.byref(book))
+    try:
+        error = lib.grader_error(book).decode()
+        if status != GRADER_OK:
+            return status, error, None
+        assert lib.grader_grade(book, threads) == GRADER_OK
+        rows = []
+        for i in range(lib.grader_count(book)):
+            r = Result()
+            assert lib.grader_result_at(book, i, ctypes.byref(r)) == GRADER_OK
+            rows.append(row(r))
+        return status, error, rows
+    finally:
+        lib.grader_close(book)
+
+
+def main():
+    """ Entry point """
+    rng = random.Random(41)
+    lib = load()
+    books = [gradebook(rng) for _ in range(BOOKS)]
+    jobs = [(data, GRADER_FIXED_POINT if i % 2 else 0) for i, (data, _) in enumerate(books)]
+
+    # nothing the library does may reach stderr or the working directory
+    before = set(os.listdir('.'))
+    capture = tempfile.TemporaryFile()
+    saved = os.dup(2)
+    os.dup2(capture.fileno(), 2)
+    try:
+        expected = [grade(lib, data, options, 1) for data, options in jobs]
+        with ThreadPoolExecutor(max_workers=WORKERS) as pool:
+            actual = list(pool.map(lambda job: grade(lib, job[0], job[1], 1 + len(job[0]) % 4),
+                                   jobs))
+    finally:
+        os.dup2(saved, 2)
+        os.close(saved)
+
+    failures = []
+    for i, ((_, broken), want, got) in enumerate(zip(books, expected, actual)):
+        if want != got:
+            failures.append(f'book {i}: parallel result differs')
+        if broken != (want[0] == GRADER_BAD_HEADER):
+            failures.append(f'book {i}: status {want[0]} {want[1]}')
+        if want[0] == GRADER_BAD_HEADER and not want[1].startswith('line '):
+            failures.append(f'book {i}: error without a line number: {want[1]}')
+    capture.seek(0)
+    if capture.read():
+        failures.append('the library wrote to stderr')
+    if set(os.listdir('.')) != before:
+        failures.append('the library left files in the working directory')
+
+    print(f"gradebooks checked: {len(books)}, bad headers: {sum(b for _, b in books)}")
+    if failures:
+        print("FAILED:")
+        print("\n".join(failures))
+        sys.exit(1)
+    print("PASSED")
+
+
+if __name__ == '__main__':
+    main()
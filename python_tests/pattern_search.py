@@ -0,0 +1,102 @@
+""" -s prefix* and -s ~id must find exactly what a brute force filter over the ids finds """
+#!/usr/bin/env python3
+
+# imports
+import csv
+import glob
+import io
+import os
+import random
+import subprocess as sc
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+GRADER = os.path.join(ROOT, 'bin', 'grader')
+FIXTURES = [os.path.join(ROOT, 'test_files', 'standard.txt')] + \
+    sorted(glob.glob(os.path.join(ROOT, 'test_files', 'In', '*', '*.txt')))
+SECTIONS = ['graded', 'wdr', 'error']
+QUERIES = 30
+
+
+def within_one_edit(a: str, b: str):
+    """ one insertion, deletion or substitution at most, by the edit distance table """
+    previous = list(range(len(b) + 1))
+    for i, ca in enumerate(a, 1):
+        current = [i]
+        for j, cb in enumerate(b, 1):
+            current.append(min(previous[j] + 1, current[j - 1] + 1, previous[j - 1] + (ca != cb)))
+        previous = current
+    return previous[-1] <= 1
+
+
+def rows(path: str):
+    """ (section, id) of every row, None if the header is refused """
+    run = sc.run([GRADER, '--format', 'csv', path], capture_output=True, check=False)
+    if run.returncode != 0:
+        return None
+    return [(r[0], r[1]) for r in csv.reader(io.StringIO(run.stdout.decode()))][1:]
+
+
+def expected(ids: list, keep):
+    """ the matching rows in id order, equal ids graded, withdrawn, then error """
+    found = [(sid, SECTIONS.index(section), section) for section, sid in ids if keep(sid)]
+    return [(section, sid) for sid, _, section in sorted(found, key=lambda f: f[:2])]
+
+
+def search(path: str, pattern: str):
+    """ (section, id) of every row -s pattern prints """
+    run = sc.run([GRADER, '-s', pattern, path], capture_output=True, check=False)
+    lines = run.stdout.decode().splitlines()
+    if not lines or not lines[0].startswith('Section'):
+        return []
+    found = []
+    for line in lines[1:]:
+        rest = line[10:]
+        found.append((line.split()[0], '' if rest.startswith(' ') else rest.split()[0]))
+    return found
+
+
+def queries(ids: list, rng: random.Random):
+    """ prefixes and one or two edits of the ids, and strings that match nothing """
+    names = sorted({sid for _, sid in ids if sid})
+    made = ['*', '~', 'zzzz*', '~zzzzzz']
+    while len(made) < QUERIES:
+        sid = rng.choice(names)
+        at = rng.randrange(len(sid) + 1)
+        ch = rng.choice('abcdefghijklmnopqrstuvwxyz0123456789')
+        made += [sid[:at] + '*', '~' + sid,
+                 '~' + rng.choice([sid[:at] + sid[at + 1:], sid[:at] + ch + sid[at:],
+                                   sid[:at] + ch + sid[at + 1:],
+                                   sid[:at] + ch + ch + sid[at + 2:]])]
+    return made
+
+
+def main():
+    """ Entry point """
+    rng = random.Random(33)
+    failures = []
+    checked = 0
+    for path in FIXTURES:
+        ids = rows(path)
+        if not ids or not any(sid for _, sid in ids):
+            continue
+        for pattern in queries(ids, rng):
+            if pattern.endswith('*'):
+                want = expected(ids, lambda sid, p=pattern[:-1]: sid.startswith(p))
+            else:
+                want = expected(ids, lambda sid, q=pattern[1:]: within_one_edit(q, sid))
+            got = search(path, pattern)
+            checked += 1
+            if got != want:
+                failures.append(f'{os.path.relpath(path, ROOT)} -s {pattern}: {got} != {want}')
+
+    print(f"searches checked: {checked}")
+    if failures:
+        print("FAILED:")
+        print("\n".join(failures[:10]))
+        sys.exit(1)
+    print("PASSED")
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,52 @@
+""" --perf-counters must report every phase, with or without hardware counters, and change nothing else """
+#!/usr/bin/env python3
+
+# imports
+import os
+import re
+import subprocess as sc
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+GRADER = os.path.join(ROOT, 'bin', 'grader')
+BOOK = os.path.join(ROOT, 'test_files', 'standard.txt')
+PHASES = ['header', 'count', 'load', 'grade', 'output', 'total']
+COLOR = re.compile(rb'\x1b\[[0-9;]*m')
+
+
+def main():
+    """ Entry point """
+    failures = []
+    for args in ([BOOK], ['--threads', '3', BOOK], ['--stats', BOOK], [BOOK, '-s', 'tob']):
+        plain = sc.run([GRADER] + args, capture_output=True, check=False)
+        run = sc.run([GRADER, '--perf-counters'] + args, capture_output=True, check=False)
+        if run.stdout != plain.stdout or run.returncode != plain.returncode:
+            failures.append(f'{" ".join(args)}: report changed')
+            continue
+
+        # the phase table is the tail of stderr
+        err = COLOR.sub(b'', run.stderr).decode()
+        lines = err.splitlines()
+        table = lines[-len(PHASES) - 1:]
+        counted = table[0].startswith('Phase') and 'IPC' in table[0]
+        if not counted and 'Hardware counters unavailable' not in err:
+            failures.append(f'{" ".join(args)}: no counters and no reason given')
+        if [line.split()[0] for line in table[1:]] != PHASES:
+            failures.append(f'{" ".join(args)}: phases {table}')
+        if COLOR.sub(b'', plain.stderr).decode() not in err:
+            failures.append(f'{" ".join(args)}: diagnostics changed')
+
+    run = sc.run([GRADER, '--perf-counters', '--stream', '3', BOOK], capture_output=True, check=False)
+    if run.returncode == 0:
+        failures.append('--perf-counters with --stream was not refused')
+
+    print(f"phases: {len(PHASES) - 1}")
+    if failures:
+        print("FAILED:")
+        print("\n".join(failures))
+        sys.exit(1)
+    print("PASSED")
+
+
+if __name__ == '__main__':
+    main()
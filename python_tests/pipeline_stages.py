@@ -0,0 +1,59 @@
+""" --pipeline must write the same report as a normal run, then its stage and queue tables """
+#!/usr/bin/env python3
+
+# imports
+import glob
+import os
+import subprocess as sc
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+GRADER = os.path.join(ROOT, 'bin', 'grader')
+BOOKS = [os.path.join(ROOT, 'test_files', 'standard.txt')] + \
+    sorted(glob.glob(os.path.join(ROOT, 'test_files', 'In', '*', '*.txt')))
+MODES = [[], ['--threads', '3'], ['--fixed-point'], ['--format', 'csv']]
+STAGES = ['read', 'parse', 'grade', 'write']
+QUEUES = ['read>parse', 'parse>grade', 'grade>write']
+REFUSED = [['-s', 'tob'], ['--stats'], ['--stream', '4'], ['--perf-counters']]
+
+
+def main():
+    """ Entry point """
+    failures = []
+    runs = 0
+    for book in BOOKS:
+        for mode in MODES:
+            plain = sc.run([GRADER] + mode + [book], capture_output=True, check=False)
+            piped = sc.run([GRADER, '--pipeline'] + mode + [book], capture_output=True, check=False)
+            runs += 1
+            name = f"{os.path.relpath(book, ROOT)} {' '.join(mode)}"
+            if piped.stdout != plain.stdout or piped.returncode != plain.returncode:
+                failures.append(f'{name}: the report differs')
+            elif not piped.stderr.startswith(plain.stderr):
+                failures.append(f'{name}: the diagnostics differ')
+
+    book = BOOKS[0]
+    piped = sc.run([GRADER, '--pipeline', book], capture_output=True, check=True)
+    lines = piped.stderr.decode().splitlines()
+    rows = {line.split()[0]: line.split() for line in lines if line.split()}
+    failures += [f'no {stage} stage' for stage in STAGES if stage not in rows]
+    failures += [f'no {queue} queue' for queue in QUEUES if queue not in rows]
+    # read passes on blocks, the rest the same batches
+    if all(stage in rows for stage in STAGES) and len({rows[s][1] for s in STAGES[1:]}) != 1:
+        failures.append('parse, grade and write passed on different numbers of batches')
+
+    for extra in REFUSED:
+        refused = sc.run([GRADER, '--pipeline'] + extra + [book], capture_output=True, check=False)
+        if refused.returncode == 0 or b'--pipeline' not in refused.stderr:
+            failures.append(f"--pipeline {' '.join(extra)} was not refused")
+
+    print(f"books: {len(BOOKS)}, runs: {runs}")
+    if failures:
+        print("FAILED:")
+        print("\n".join(failures))
+        sys.exit(1)
+    print("PASSED")
+
+
+if __name__ == '__main__':
+    main()
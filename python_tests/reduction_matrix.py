@@ -0,0 +1,77 @@
+""" grading and class wide sums must come out bit for bit the same on any number of threads """
+#!/usr/bin/env python3
+
+# imports
+import os
+import random
+import shutil
+import subprocess as sc
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+GRADER = os.path.join(ROOT, 'bin', 'grader')
+THREADS = [1, 2, 3, 4, 5, 6, 7, 8, 11, 16, 24, 31, 32, 33, 48, 63, 64]
+STUDENTS = 200000
+
+HEADER = """TITLE Lab1 Lab2 Assign1 Midterm Lab3 Lab4 Assign2 FinalExam
+CATEGORY Lab Lab Assign Midterm Lab Lab Assign Final
+MAXMARK 10 10 15 40 10 10 20 90
+WEIGHT 5 5 10 20 5 5 10 40
+"""
+MAX_MARKS = [10, 10, 15, 40, 10, 10, 20, 90]
+
+
+def roster(path: str, policies: str, rng: random.Random):
+    """ a large class with awkward decimals, a few withdrawn and broken rows """
+    with open(path, 'w', encoding='utf-8') as handle:
+        handle.write(HEADER + policies + '\n')
+        for i in range(STUDENTS):
+            marks = [f'{rng.uniform(0, top):.3f}' for top in MAX_MARKS]
+            roll = rng.random()
+            if roll < 0.01:
+                marks[rng.randrange(len(marks))] = 'WDR'
+            elif roll < 0.02:
+                marks.pop()
+            handle.write(f's{i} ' + ' '.join(marks) + '\n')
+
+
+def run(args: list):
+    """ stdout of one grader run """
+    return sc.run([GRADER] + args, capture_output=True, check=True).stdout
+
+
+def main():
+    """ Entry point """
+    rng = random.Random(38)
+    work = tempfile.mkdtemp()
+    books = {
+        'plain': os.path.join(work, 'plain.txt'),
+        'policies': os.path.join(work, 'policies.txt'),
+    }
+    roster(books['plain'], '', rng)
+    roster(books['policies'], 'DROP Lab 1\nBEST Assign 1\n', rng)
+
+    failures = []
+    checked = 0
+    for name, book in books.items():
+        for mode in ([], ['--fixed-point']):
+            for report in (['--stats'], []):
+                args = mode + report + [book]
+                expected = run(['--threads', '1'] + args)
+                for threads in THREADS[1:]:
+                    if run(['--threads', str(threads)] + args) != expected:
+                        failures.append(f'{name} {" ".join(mode + report)} --threads {threads}')
+                    checked += 1
+
+    shutil.rmtree(work)
+    print(f"thread counts checked: {checked}")
+    if failures:
+        print("FAILED:")
+        print("\n".join(failures))
+        sys.exit(1)
+    print("PASSED")
+
+
+if __name__ == '__main__':
+    main()
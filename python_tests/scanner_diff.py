@@ -0,0 +1,92 @@
+""" the scalar, SSE2 and AVX2 scanners must split every line into the same tokens """
+#!/usr/bin/env python3
+
+# imports
+import glob
+import os
+import random
+import shutil
+import subprocess as sc
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+GRADER = os.path.join(ROOT, 'bin', 'grader')
+FIXTURES = [os.path.join(ROOT, 'test_files', 'standard.txt')] + \
+    sorted(glob.glob(os.path.join(ROOT, 'test_files', 'In', '*', '*.txt')))
+BACKENDS = ['scalar', 'sse2', 'avx2']
+MUTANTS = 20
+
+# what getline, stripComments and >> see as white space and comment
+NOISE = [b'#', b'\t', b'\r', b'\v', b'\f', b' ', b'  ', b'\n', b'\n\n', b'x']
+
+
+def reference(data: bytes):
+    """ the tokens of every line, split the way the old parser did """
+    lines = data.split(b'\n')
+    if lines and lines[-1] == b'':
+        lines.pop()
+    out = []
+    for number, line in enumerate(lines, 1):
+        line = line.split(b'#', 1)[0]
+        for space in b'\t\r\v\f':
+            line = line.replace(bytes([space]), b' ')
+        out.append(b'%d:' % number + b''.join(b' ' + t for t in line.split(b' ') if t))
+    return b''.join(l + b'\n' for l in out)
+
+
+def mutate(data: bytes, rng: random.Random):
+    """ sprinkle delimiters in, and cut bytes out """
+    data = bytearray(data)
+    for _ in range(rng.randint(1, 40)):
+        at = rng.randint(0, len(data))
+        if rng.random() < 0.3 and at < len(data):
+            del data[at]
+        else:
+            data[at:at] = rng.choice(NOISE)
+    # lines straddling the 64 byte chunks, and a missing final newline
+    if rng.random() < 0.3:
+        data += b'#' * rng.randint(1, 130)
+    if rng.random() < 0.5 and data.endswith(b'\n'):
+        data = data.rstrip(b'\n')
+    return bytes(data)
+
+
+def tokens(path: str, backend: str):
+    """ --tokens output under one forced backend """
+    env = dict(os.environ, GRADER_SCAN=backend)
+    return sc.run([GRADER, '--tokens', path], capture_output=True, env=env, check=True).stdout
+
+
+def main():
+    """ Entry point """
+    rng = random.Random(35)
+    work = tempfile.mkdtemp()
+    failures = []
+    checked = 0
+    for source in FIXTURES:
+        with open(source, 'rb') as handle:
+            original = handle.read()
+        for n in range(MUTANTS + 1):
+            data = original if n == 0 else mutate(original, rng)
+            path = os.path.join(work, f'{n}_' + os.path.basename(source))
+            with open(path, 'wb') as handle:
+                handle.write(data)
+
+            expected = reference(data)
+            for backend in BACKENDS:
+                if tokens(path, backend) != expected:
+                    failures.append(f'{source} mutant {n} ({backend})')
+            checked += 1
+
+    shutil.rmtree(work)
+    print(f"inputs checked: {checked}")
+    if failures:
+        print("FAILED:")
+        print("\n".join(failures))
+        sys.exit(1)
+    print("PASSED")
+
+
+if __name__ == '__main__':
+    main()
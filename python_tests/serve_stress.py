@@ -0,0 +1,170 @@
+""" Stress test for grader --serve: readers and reloads at the same time """
+#!/usr/bin/env python3
+
+# imports
+import os
+import shutil
+import socket
+import subprocess as sc
+import sys
+import tempfile
+import threading
+import time
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+GRADER = os.path.join(ROOT, 'bin', 'grader')
+STANDARD = os.path.join(ROOT, 'test_files', 'standard.txt')
+
+READERS = 8
+SECONDS = 5
+EXTRA = 'newbie 10 10 15 40 10 10 20 90\n'
+
+# ids on more than one row, STUDENT must answer with the row -s prints
+REPEATED = ['s1 1 1 1 1 1 1 1 1', 's1 9 9 9 9 9 9 9 9', 's2 WDR 1 1 1 1 1 1 1', 's2 1 2 3',
+            's3 2 2 2 2 2 2 2 2', 's3 x 1 1 1 1 1 1 1', 's3 4 4 4 4 4 4 4 4']
+
+
+def query(sock_path: str, commands: list):
+    """ send each command, return the answer lines of each """
+    conn = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    conn.connect(sock_path)
+    stream = conn.makefile('rw')
+    answers = []
+    for command in commands:
+        stream.write(command + '\n')
+        stream.flush()
+        lines = []
+        while True:
+            line = stream.readline()
+            if line in ('END\n', ''):
+                break
+            lines.append(line.rstrip('\n'))
+        answers.append(lines)
+    conn.close()
+    return answers
+
+
+def reader(sock_path: str, deadline: float, failures: list, counts: list):
+    """ every answer must come from exactly one version of the file """
+    while time.time() < deadline:
+        listing, report, student = query(sock_path,
+                                         ['LIST', 'REPORT book.txt', 'STUDENT book.txt tob'])
+        # each command reads its own snapshot, so only check each answer
+        graded = int(listing[0].split()[1])
+        rows = len(report) - 1
+        newest = rows == 10 and report[-1].startswith('newbie ')
+        if graded not in (9, 10) or not (rows == 9 or newest):
+            failures.append((listing, report))
+        if not student or student[0] != 'SECTION graded':
+            failures.append(student)
+        counts[rows - 9] += 1
+
+
+def reloader(sock_path: str, book: str, original: str, deadline: float, failures: list):
+    """ flip the file between two versions and force a reload each time """
+    extended = original + EXTRA
+    flip = False
+    while time.time() < deadline:
+        flip = not flip
+        with open(book, 'w') as handle:
+            handle.write(extended if flip else original)
+        answer = query(sock_path, ['RELOAD book.txt'])[0]
+        if not answer or not answer[0].startswith('OK'):
+            failures.append(answer)
+
+
+def repeated(sock_path: str, work: str):
+    """ ids STUDENT and -s do not agree on """
+    path = os.path.join(work, 'repeat.txt')
+    differ = []
+    for sid in ('s1', 's2', 's3'):
+        answer = query(sock_path, [f'STUDENT repeat.txt {sid}'])[0]
+        run = sc.run([GRADER, '-s', sid, path], capture_output=True, check=True)
+        if answer[1:] != run.stdout.decode().splitlines():
+            differ.append(sid)
+    return differ
+
+
+def socket_path_guard(work: str):
+    """ a regular file as the socket path is refused and kept, a stale socket is replaced """
+    problems = []
+    victim = os.path.join(work, 'victim.txt')
+    with open(victim, 'w') as handle:
+        handle.write('not a socket\n')
+    try:
+        run = sc.run([GRADER, '--serve', victim, STANDARD], capture_output=True, check=False,
+                     timeout=5)
+        if run.returncode == 0 or b'Not a socket' not in run.stderr:
+            problems.append('a regular file was accepted as the socket path')
+    except sc.TimeoutExpired:
+        problems.append('a regular file was replaced by a served socket')
+    if not os.path.isfile(victim):
+        problems.append('the regular file given as the socket path was deleted')
+
+    # bound and closed, nobody answers on it
+    stale = os.path.join(work, 'stale.sock')
+    left = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    left.bind(stale)
+    left.close()
+    daemon = sc.Popen([GRADER, '--serve', stale, STANDARD], stderr=sc.DEVNULL)
+    for _ in range(50):
+        try:
+            if query(stale, ['LIST'])[0]:
+                break
+        except OSError:
+            time.sleep(0.1)
+    else:
+        problems.append('a stale socket was not replaced')
+    daemon.terminate()
+    daemon.wait()
+    return problems
+
+
+def main():
+    """ Entry point """
+    work = tempfile.mkdtemp()
+    book = os.path.join(work, 'book.txt')
+    sock_path = os.path.join(work, 'grader.sock')
+    shutil.copy(STANDARD, book)
+    with open(STANDARD) as handle:
+        original = handle.read()
+    header = [line for line in original.splitlines()
+              if line.split()[:1] in (['TITLE'], ['CATEGORY'], ['MAXMARK'], ['WEIGHT'])]
+    with open(os.path.join(work, 'repeat.txt'), 'w') as handle:
+        handle.write('\n'.join(header + REPEATED) + '\n')
+
+    daemon = sc.Popen([GRADER, '--serve', sock_path, 'book.txt', 'repeat.txt'], cwd=work,
+                      stderr=sc.DEVNULL)
+    for _ in range(50):
+        if os.path.exists(sock_path):
+            break
+        time.sleep(0.1)
+
+    failures = [f'{sid}: STUDENT and -s differ' for sid in repeated(sock_path, work)]
+    failures += socket_path_guard(work)
+    counts = [0, 0]
+    deadline = time.time() + SECONDS
+    threads = [threading.Thread(target=reader, args=(sock_path, deadline, failures, counts))
+               for _ in range(READERS)]
+    threads.append(threading.Thread(target=reloader,
+                                    args=(sock_path, book, original, deadline, failures)))
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+
+    alive = daemon.poll() is None
+    daemon.terminate()
+    daemon.wait()
+    shutil.rmtree(work)
+
+    print(f"answers from old version: {counts[0]}, new version: {counts[1]}")
+    if failures or not alive:
+        print(f"FAILED: {len(failures)} torn or mismatched answers, daemon alive: {alive}")
+        print(failures[:3])
+        sys.exit(1)
+    print("PASSED")
+
+
+if __name__ == '__main__':
+    main()
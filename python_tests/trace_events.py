@@ -0,0 +1,61 @@
+""" The debug build must write a Chrome trace of each phase, one track per thread """
+#!/usr/bin/env python3
+
+# imports
+import json
+import os
+import shutil
+import subprocess as sc
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+GRADER = os.path.join(ROOT, 'bin', 'grader')
+GRADER_DEBUG = os.path.join(ROOT, 'bin', 'graderdebug')
+BOOK = os.path.join(ROOT, 'test_files', 'standard.txt')
+THREADS = 4
+PHASES = ['loadEvaluationData', 'countStudentLines', 'loadStudents', 'makeGrades', 'outputReport']
+
+
+def main():
+    """ Entry point """
+    work = tempfile.mkdtemp()
+    trace = os.path.join(work, 'trace.json')
+    env = dict(os.environ, GRADER_TRACE=trace)
+    failures = []
+
+    args = ['--threads', str(THREADS), BOOK]
+    traced = sc.run([GRADER_DEBUG] + args, capture_output=True, check=True, env=env)
+    plain = sc.run([GRADER] + args, capture_output=True, check=True)
+    if traced.stdout != plain.stdout:
+        failures.append('a traced run reports differently')
+
+    events = json.load(open(trace, encoding='utf-8'))['traceEvents']
+    spans = [e for e in events if e['ph'] == 'X']
+    names = {e['name'] for e in spans}
+    failures += [f'no {phase} span' for phase in PHASES if phase not in names]
+    if len({e['tid'] for e in spans if e['name'] == 'gradeRange'}) != THREADS:
+        failures.append(f'gradeRange is not on {THREADS} tracks')
+    tracks = {e['tid'] for e in events if e['ph'] == 'M'}
+    if tracks != {e['tid'] for e in events}:
+        failures.append('an event is on an unnamed track')
+    if any(e['dur'] < 0 for e in spans):
+        failures.append('a span ends before it starts')
+
+    # the release build has no trace points at all
+    os.remove(trace)
+    sc.run([GRADER] + args, capture_output=True, check=True, env=env)
+    if os.path.exists(trace):
+        failures.append('the release build wrote a trace')
+
+    shutil.rmtree(work)
+    print(f"trace events: {len(events)}, tracks: {len(tracks)}")
+    if failures:
+        print("FAILED:")
+        print("\n".join(failures))
+        sys.exit(1)
+    print("PASSED")
+
+
+if __name__ == '__main__':
+    main()
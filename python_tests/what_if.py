@@ -0,0 +1,111 @@
+""" --what-if must skip bad WEIGHT lines and count letters and changes under the rest """
+#!/usr/bin/env python3
+
+# imports
+import os
+import re
+import shutil
+import subprocess as sc
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+GRADER = os.path.join(ROOT, 'bin', 'grader')
+LETTERS = ['A+', 'A', 'A-', 'B+', 'B', 'B-', 'C+', 'C', 'C-', 'D', 'F']
+
+# max marks of 100, so a total is the sum of mark * weight / 100
+BOOK = """TITLE Lab1 Midterm FinalExam
+CATEGORY Lab Midterm Final
+MAXMARK 100 100 100
+WEIGHT 20 30 50
+s1 100 100 0
+s2 0 0 100
+s3 100 50 80
+s4 90 90 90
+w1 WDR 1 1
+"""
+# baseline: s1 50 D, s2 50 D, s3 75 B, s4 90 A+, w1 is never graded
+BASELINE = {'A+': 1, 'B': 1, 'D': 2}
+
+SCENARIOS = """# scenarios
+WEIGHT 50 30 20
+10 40 50
+
+WEIGHT 20 30
+WEIGHT 50 50 50
+WEIGHT 20 30 abc
+WEIGHT 20 30 50 # unchanged
+"""
+# line, and the start of the message it is rejected with
+REJECTED = [(5, '*** Evaluation data length'), (6, '*** Weight summation'),
+            (7, '*** Could not convert')]
+
+# label, letter counts, and each changed row: id, total, letter, new total, new letter
+EXPECTED = [
+    # s1 50+30+0, s2 0+0+20, s3 50+15+16, s4 45+27+18
+    ('WEIGHT 50 30 20', {'A+': 1, 'A-': 2, 'F': 1},
+     [['s1', '50.00', 'D', '->', '80.00', 'A-'], ['s2', '50.00', 'D', '->', '20.00', 'F'],
+      ['s3', '75.00', 'B', '->', '81.00', 'A-']]),
+    # s1 10+40+0, s2 0+0+50, s3 10+20+40, s4 9+36+45
+    ('10 40 50', {'A+': 1, 'B-': 1, 'D': 2},
+     [['s3', '75.00', 'B', '->', '70.00', 'B-']]),
+    ('WEIGHT 20 30 50 # unchanged', BASELINE, []),
+]
+
+
+def counts(line: str):
+    """ the letter counts of a distribution line, zeros left out """
+    tokens = line.split()
+    found = dict(zip(tokens[0::2], map(int, tokens[1::2])))
+    if list(found) != LETTERS:
+        return None
+    return {l: n for l, n in found.items() if n}
+
+
+def main():
+    """ Entry point """
+    work = tempfile.mkdtemp()
+    book = os.path.join(work, 'book.txt')
+    scenarios = os.path.join(work, 'scenarios.txt')
+    with open(book, 'w', encoding='utf-8') as handle:
+        handle.write(BOOK)
+    with open(scenarios, 'w', encoding='utf-8') as handle:
+        handle.write(SCENARIOS)
+    run = sc.run([GRADER, '--what-if', scenarios, book], capture_output=True, check=True)
+    shutil.rmtree(work)
+
+    failures = []
+    plain = re.sub(r'\x1b\[[0-9;]*m', '', run.stderr.decode())
+    rejected = [(int(line), message) for message, line in
+                re.findall(r'Error message: (.*)\nOffending line: (\d+)', plain)]
+    if [line for line, _ in rejected] != [line for line, _ in REJECTED] or \
+            not all(got.startswith(want) for (_, got), (_, want) in zip(rejected, REJECTED)):
+        failures.append(f'rejected {rejected}, expected {REJECTED}')
+
+    lines = run.stdout.decode().splitlines()
+    if lines[:1] != ['Baseline'] or counts(lines[1]) != BASELINE:
+        failures.append(f'baseline: {lines[:2]}')
+    blocks = run.stdout.decode().split('\n\n')[1:]
+    if len(blocks) != len(EXPECTED):
+        failures.append(f'{len(blocks)} scenarios reported, expected {len(EXPECTED)}')
+    for s, (block, (label, letters, changed)) in enumerate(zip(blocks, EXPECTED)):
+        rows = block.rstrip('\n').split('\n')
+        if rows[0] != f'Scenario {s + 1}: {label}':
+            failures.append(f'scenario {s + 1} is labelled {rows[0]}')
+        if counts(rows[1]) != letters:
+            failures.append(f'scenario {s + 1} letters: {rows[1]}')
+        if rows[2] != f'Letter changes: {len(changed)}':
+            failures.append(f'scenario {s + 1}: {rows[2]}')
+        if [r.split() for r in rows[3:]] != changed:
+            failures.append(f'scenario {s + 1} changed rows: {rows[3:]}')
+
+    print(f"scenarios: {len(EXPECTED)}, rejected: {len(REJECTED)}")
+    if failures:
+        print("FAILED:")
+        print("\n".join(failures))
+        sys.exit(1)
+    print("PASSED")
+
+
+if __name__ == '__main__':
+    main()
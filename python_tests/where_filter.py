@@ -0,0 +1,157 @@
+""" --where must report exactly the rows its expression holds for """
+#!/usr/bin/env python3
+
+# imports
+import os
+import random
+import shutil
+import struct
+import subprocess as sc
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+GRADER = os.path.join(ROOT, 'bin', 'grader')
+STUDENTS = 5000
+
+TITLES = ['Lab-1', 'Lab2', 'Assign1', 'Midterm', 'Lab3', 'Lab4', 'Assign2', 'FinalExam']
+CATEGORIES = ['Lab', 'Lab', 'Assign', 'Midterm', 'Lab', 'Lab', 'Assign', 'Final']
+MAX_MARKS = [10, 10, 15, 40, 10, 10, 20, 90]
+WEIGHTS = [5, 5, 10, 20, 5, 5, 10, 40]
+LETTERS = ['A+', 'A', 'A-', 'B+', 'B', 'B-', 'C+', 'C', 'C-', 'D', 'F', 'WITHDRAWN']
+
+
+def f32(value: float):
+    """ value rounded to a float, as the grader holds it """
+    return struct.unpack('<f', struct.pack('<f', value))[0]
+
+
+def nan_false(test):
+    """ every comparison with a missing number is false """
+    return lambda r: r['section'] == 'graded' and test(r)
+
+
+# expression and the same test in python, marks and scores are floats
+CASES = [
+    ('Midterm < 20 && Final >= 30',
+     nan_false(lambda r: r['marks'][3] < 20 and r['final'] >= 30)),
+    ('letter in (D,F) && !wdr', lambda r: r['letter'] in ('D', 'F') and r['section'] != 'wdr'),
+    ('letter in (d, f, WDR) || error',
+     lambda r: r['letter'] in ('D', 'F', 'WITHDRAWN') or r['section'] == 'error'),
+    ('letter != A+ && total > 80',
+     nan_false(lambda r: r['letter'] != 'A+' and r['total'] > 80)),
+    ('!(total >= 50)', lambda r: not (r['section'] == 'graded' and r['total'] >= 50)),
+    ('total != 60.5', nan_false(lambda r: r['total'] != f32(60.5))),
+    ('`Lab-1` + Lab2 == 2 * Lab3 || Lab4 == 10',
+     nan_false(lambda r: f32(r['marks'][0] + r['marks'][1]) == f32(2 * r['marks'][4])
+               or r['marks'][5] == 10)),
+    ('lab - assign / 2 > -midterm + 25',
+     nan_false(lambda r: f32(r['lab'] - f32(r['assign'] / 2)) > f32(-r['midterm'] + 25))),
+    ('Lab > 15 && (Assign < 10 || FinalExam > 80)',
+     nan_false(lambda r: r['lab'] > 15 and (r['assign'] < 10 or r['marks'][7] > 80))),
+    ('wdr', lambda r: r['section'] == 'wdr'),
+]
+
+BAD = ['Quiz > 3', 'total <', 'letter < 3', 'total + wdr', 'letter in (Q)', '(total > 3',
+       'total', '', '`Lab-1 > 3', 'total > 3 extra']
+
+
+def gradebook(path: str, rng: random.Random):
+    """ a class with withdrawals, exemptions and broken rows, and its marks """
+    lines = ['TITLE ' + ' '.join(TITLES), 'CATEGORY ' + ' '.join(CATEGORIES),
+             'MAXMARK ' + ' '.join(map(str, MAX_MARKS)), 'WEIGHT ' + ' '.join(map(str, WEIGHTS))]
+    marks = {}
+    for i in range(STUDENTS):
+        row = [f'{rng.uniform(0, top):.{rng.randrange(3)}f}' for top in MAX_MARKS]
+        if rng.random() < 0.2:
+            row[rng.randrange(len(row))] = str(rng.choice([0, 10]))
+        roll = rng.random()
+        if roll < 0.05:
+            row[rng.randrange(len(row))] = 'WDR'
+        elif roll < 0.08:
+            row[rng.randrange(len(row))] = 'EX'
+        elif roll < 0.10:
+            row.pop()
+        marks[f's{i}'] = [f32(float(m)) if m not in ('WDR', 'EX') else 0.0 for m in row]
+        lines.append(f's{i} ' + ' '.join(row))
+    with open(path, 'w', encoding='utf-8') as handle:
+        handle.write('\n'.join(lines) + '\n')
+    return marks
+
+
+def columnar(data: bytes):
+    """ rows of a columnar report, see writer.hpp """
+    assert data[:4] == b'GRDC'
+    at = 6
+    rows = []
+    while True:
+        (n,) = struct.unpack_from('<I', data, at)
+        at += 4
+        if n == 0:
+            return rows
+        section = data[at:at + n]
+        at += n
+        line = struct.unpack_from(f'<{n}I', data, at)
+        at += 4 * n
+        scores = []
+        for _ in range(5):
+            scores.append(struct.unpack_from(f'<{n}f', data, at))
+            at += 4 * n
+        letter = data[at:at + n]
+        at += n
+        text = []
+        for _ in range(3):
+            offsets = struct.unpack_from(f'<{n + 1}I', data, at)
+            at += 4 * (n + 1)
+            text.append([data[at + offsets[k]:at + offsets[k + 1]].decode() for k in range(n)])
+            at += offsets[n]
+        for k in range(n):
+            rows.append({'section': ['graded', 'wdr', 'error'][section[k]], 'line': line[k],
+                         'name': text[0][k], 'lab': scores[0][k], 'assign': scores[1][k],
+                         'midterm': scores[2][k], 'final': scores[3][k], 'total': scores[4][k],
+                         'letter': LETTERS[letter[k]] if letter[k] < len(LETTERS) else ''})
+
+
+def report(book: str, args: list):
+    """ the columnar rows of one run """
+    run = sc.run([GRADER, '--format', 'columnar'] + args + [book], capture_output=True, check=True)
+    return columnar(run.stdout)
+
+
+def main():
+    """ Entry point """
+    rng = random.Random(44)
+    work = tempfile.mkdtemp()
+    book = os.path.join(work, 'book.txt')
+    marks = gradebook(book, rng)
+    everyone = report(book, [])
+    for r in everyone:
+        r['marks'] = marks.get(r['name'])
+
+    failures = []
+    for expression, test in CASES:
+        want = [(r['section'], r['line']) for r in everyone if test(r)]
+        for threads in ('1', '5'):
+            got = [(r['section'], r['line'])
+                   for r in report(book, ['--threads', threads, '--where', expression])]
+            if got != want:
+                failures.append(f'{expression} on {threads} threads: {len(got)} rows, '
+                                f'expected {len(want)}')
+
+    # a bad expression is refused before any row is read, and says where
+    for expression in BAD:
+        run = sc.run([GRADER, '--where', expression, book], capture_output=True, check=False)
+        if run.returncode == 0 or run.stdout or b'^' not in run.stderr:
+            failures.append(f'{expression!r} was not refused')
+
+    shutil.rmtree(work)
+    print(f"expressions checked: {len(CASES)}, refused: {len(BAD)}")
+    if failures:
+        print("FAILED:")
+        print("\n".join(failures))
+        sys.exit(1)
+    print("PASSED")
+
+
+if __name__ == '__main__':
+    main()
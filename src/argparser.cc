@@ -99,6 +99,53 @@ namespace GraderApplication
   }
 
 
+  bool ArgParse::extractOption(int &argc, char **argv,
+      const char *flag, std::string &value)
+  {
+    for (int i = 1; i < argc; i++)
+    {
+      if (strcmp(flag, argv[i]) == 0)
+      {
+        if (i + 1 >= argc)
+        {
+          fprintf(stderr, "\n\t\t%s requires an argument\n\n", flag);
+          printUsage();
+        }
+        value = argv[i+1];
+
+        /* shift the remaining arguments down over the option */
+        for (int j = i; j + 2 < argc; j++)
+        {
+          argv[j] = argv[j+2];
+        }
+        argc -= 2;
+        argv[argc] = nullptr;
+        return true;
+      }
+    }
+    return false;
+  }
+
+
+  bool ArgParse::extractFlag(int &argc, char **argv, const char *flag)
+  {
+    for (int i = 1; i < argc; i++)
+    {
+      if (strcmp(flag, argv[i]) == 0)
+      {
+        for (int j = i; j + 1 < argc; j++)
+        {
+          argv[j] = argv[j+1];
+        }
+        argc -= 1;
+        argv[argc] = nullptr;
+        return true;
+      }
+    }
+    return false;
+  }
+
+
   void ArgParse::manualFileInput(std::string &input)
   {
     std::cout << "Enter file path: ";
@@ -114,6 +161,22 @@ namespace GraderApplication
     fprintf(stderr, "./grader filename           [Run with specified file]\n");
     fprintf(stderr, "./grader filename -s sname  [Run specified file on just the specified student]\n");
     fprintf(stderr, "./grader -s name1 name2     [Run with name2 as filename and name1 as student name]\n");
+    fprintf(stderr, "./grader --what-if wfile filename  [Regrade filename under every WEIGHT line in wfile]\n");
+    fprintf(stderr, "./grader --serve socket file ...   [Answer LIST, STUDENT, REPORT, STATS queries on a unix socket]\n");
+    fprintf(stderr, "./grader --format fmt filename     [Write the report as table (default), csv, jsonl or columnar]\n");
+    fprintf(stderr, "./grader -s 'prefix*' filename      [Every student whose id starts with prefix]\n");
+    fprintf(stderr, "./grader -s '~name' filename       [Every student whose id is within one edit of name]\n");
+    fprintf(stderr, "./grader --stream rows filename    [Grade and write rows students at a time, in bounded memory]\n");
+    fprintf(stderr, "./grader --fixed-point filename    [Grade in exact integer thousandths, totals rounded to the hundredth]\n");
+    fprintf(stderr, "./grader --threads n filename      [Grade and sum on n threads (1 to 64), the results are the same for any n]\n");
+    fprintf(stderr, "./grader --stats filename          [Counts, mean, min, max and letter counts instead of the report]\n");
+    fprintf(stderr, "./grader --tokens filename         [Print the tokens of every line, as the scanner splits them]\n");
+    fprintf(stderr, "./grader --where 'expr' filename   [Report only the rows expr holds for, eg 'Midterm < 20 && !wdr']\n");
+    fprintf(stderr, "./grader --join file1 file2 ...    [Join gradebooks by student id, headers side by side, and grade them as one]\n");
+    fprintf(stderr, "./grader --diff old new            [Students added, removed or changed from old to new, with score deltas]\n");
+    fprintf(stderr, "./grader --index filename          [Write filename.gidx, so -s reads only the lines of that student]\n");
+    fprintf(stderr, "./grader --perf-counters filename  [Time each phase, with cycles, instructions, IPC and misses per student]\n");
+    fprintf(stderr, "./grader --pipeline filename       [Read, parse, grade and write on threads of their own, with queue occupancy]\n");
 
     exit(EXIT_FAILURE);
   }
@@ -0,0 +1,203 @@
+/* All  main documentaion is in header files
+ * for corresponding cpp files.
+ * */
+#include <iomanip>
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include "../hdr/diff.hpp"
+
+
+/* Where one id sits in a Container */
+struct DiffSlot
+{
+  const StudentData *student;
+  ContainerSection section;
+};
+
+
+/* NOTE: Documentation
+ * One side of a diff, loaded and graded on its own
+ * thread, its diagnostics held until both are done
+ * */
+struct DiffSide
+{
+  EvaluationData eval;
+  std::unique_ptr<Container> container;
+  std::ostringstream diagnostics;
+  LoadStatus status;
+
+  DiffSide(const std::string &file)
+    : eval(file)
+      , status(LOAD_OK)
+  { }
+};
+
+
+static void gradeSide(DiffSide &side, bool fixedPoint, int threads)
+{
+  side.eval.setEvaluationDiagnostics(side.diagnostics);
+  side.eval.setEvaluationFixedPoint(fixedPoint);
+  side.eval.setEvaluationThreads(threads);
+  side.status = side.eval.loadEvaluationData();
+  if (side.status != LOAD_OK) { return; }
+
+  side.container.reset(new Container(countStudentLines(side.eval)));
+  side.status = loadStudentContainers(side.eval, *side.container);
+  if (side.status == LOAD_OK) { makeGrades(side.eval, *side.container); }
+}
+
+
+/* every id of a Container, in the order searchStudent ranks them */
+static void indexContainer(const Container &c, std::unordered_map<std::string_view, DiffSlot> &index)
+{
+  index.reserve(c.student.size() + c.wdr.size() + c.error.size());
+  const StudentVector *sections[] = { &c.error, &c.wdr, &c.student };
+  const ContainerSection order[] = { ERROR_SECTION, WDR_SECTION, GRADED_SECTION };
+  for (int s = 0; s < 3; s++)
+  {
+    for (const auto &stu: *sections[s]) { index[stu.studentName()] = { &stu, order[s] }; }
+  }
+}
+
+
+static bool sameStudent(const DiffSlot &a, const DiffSlot &b)
+{
+  if (a.section != b.section) { return false; }
+  if (a.section == ERROR_SECTION)
+  {
+    return a.student->currentLineContent() == b.student->currentLineContent()
+      && a.student->errorDefinition() == b.student->errorDefinition();
+  }
+  const StudentData &x = *a.student;
+  const StudentData &y = *b.student;
+  return x.studentLetter() == y.studentLetter()
+    && x.studentLabScore() == y.studentLabScore()
+    && x.studentAssignScore() == y.studentAssignScore()
+    && x.studentMidtermScore() == y.studentMidtermScore()
+    && x.studentFinalScore() == y.studentFinalScore()
+    && x.studentTotalGrade() == y.studentTotalGrade();
+}
+
+
+long diffContainers(const Container &before, const Container &after, std::vector<DiffRow> &rows)
+{
+  long unchanged = 0;
+  std::unordered_map<std::string_view, DiffSlot> old;
+  std::unordered_map<std::string_view, DiffSlot> now;
+  indexContainer(before, old);
+  indexContainer(after, now);
+
+  /* probe the old ids with the new ones, in the new file's order */
+  const StudentVector *sections[] = { &after.student, &after.wdr, &after.error };
+  for (int s = GRADED_SECTION; s <= ERROR_SECTION; s++)
+  {
+    for (const auto &stu: *sections[s])
+    {
+      const DiffSlot &slot = now.find(stu.studentName())->second;
+      if (slot.student != &stu) { continue; }
+
+      auto found = old.find(stu.studentName());
+      if (found == old.end())
+      {
+        rows.push_back({ DIFF_ADDED, nullptr, GRADED_SECTION, slot.student, slot.section });
+      }
+      else if (! (sameStudent(found->second, slot)) )
+      {
+        rows.push_back({ DIFF_CHANGED, found->second.student, found->second.section,
+            slot.student, slot.section });
+      }
+      else
+      {
+        unchanged++;
+      }
+    }
+  }
+
+  const StudentVector *oldSections[] = { &before.student, &before.wdr, &before.error };
+  for (int s = GRADED_SECTION; s <= ERROR_SECTION; s++)
+  {
+    for (const auto &stu: *oldSections[s])
+    {
+      const DiffSlot &slot = old.find(stu.studentName())->second;
+      if (slot.student != &stu || now.count(stu.studentName()) > 0) { continue; }
+      rows.push_back({ DIFF_REMOVED, slot.student, slot.section, nullptr, GRADED_SECTION });
+    }
+  }
+  return unchanged;
+}
+
+
+/* the letter column of one side */
+static const std::string &diffLetter(const StudentData *s, ContainerSection section)
+{
+  static const std::string error("ERROR");
+  return section == ERROR_SECTION ? error : s->studentLetterGrade();
+}
+
+
+static void outputDiffRow(const DiffRow &row, std::ostream &out)
+{
+  static const char *changes[] = { "added", "removed", "changed" };
+  const StudentData *s = row.after != nullptr ? row.after : row.before;
+  ContainerSection section = row.after != nullptr ? row.afterSection : row.beforeSection;
+
+  float scores[5] = { s->studentLabScore(), s->studentAssignScore(), s->studentMidtermScore(),
+    s->studentFinalScore(), s->studentTotalGrade() };
+  bool deltas = row.change == DIFF_CHANGED
+    && row.beforeSection == GRADED_SECTION && row.afterSection == GRADED_SECTION;
+  if (deltas)
+  {
+    scores[0] -= row.before->studentLabScore();
+    scores[1] -= row.before->studentAssignScore();
+    scores[2] -= row.before->studentMidtermScore();
+    scores[3] -= row.before->studentFinalScore();
+    scores[4] -= row.before->studentTotalGrade();
+  }
+
+  out << std::left << std::setw(10) << changes[row.change]
+    << std::left << std::setw(10) << s->studentName();
+  if (deltas) { out << std::showpos; }
+  for (float score: scores) { out << std::left << std::setw(10) << score; }
+  out << std::noshowpos;
+
+  std::string letter = diffLetter(s, section);
+  if (row.change == DIFF_CHANGED && diffLetter(row.before, row.beforeSection) != letter)
+  {
+    letter = diffLetter(row.before, row.beforeSection) + " -> " + letter;
+  }
+  out << letter << std::endl;
+}
+
+
+bool diffGradebooks(const std::string &oldFile, const std::string &newFile, bool fixedPoint,
+    int threads, std::ostream &out)
+{
+  DiffSide before(oldFile);
+  DiffSide after(newFile);
+  std::thread other(gradeSide, std::ref(before), fixedPoint, threads);
+  gradeSide(after, fixedPoint, threads);
+  other.join();
+
+  std::cerr << before.diagnostics.str() << after.diagnostics.str();
+  if (before.status != LOAD_OK || after.status != LOAD_OK) { return false; }
+
+  std::vector<DiffRow> rows;
+  long unchanged = diffContainers(*before.container, *after.container, rows);
+
+  long counts[3] = { 0, 0, 0 };
+  out << std::fixed << std::setprecision(2);
+  out << std::left << std::setw(10) << "Change";
+  outputHeader(out);
+  for (const auto &row: rows)
+  {
+    outputDiffRow(row, out);
+    counts[row.change]++;
+  }
+
+  out << "Added: " << counts[DIFF_ADDED] << "  Removed: " << counts[DIFF_REMOVED]
+    << "  Changed: " << counts[DIFF_CHANGED]
+    << "  Unchanged: " << unchanged << std::endl;
+  return true;
+}
@@ -0,0 +1,136 @@
+/* All  main documentaion is in header files
+ * for corresponding cpp files.
+ * */
+#include <functional>
+#include "../hdr/duplicate.hpp"
+#include "../hdr/utillity.hpp"
+
+
+namespace GraderApplication
+{
+  static const std::uint64_t OFFSET_MASK = (1ULL << DUPLICATE_OFFSET_BITS) - 1;
+
+
+  /* Map a 32 bit value onto [0, n) without a division */
+  static std::size_t reduce(std::uint32_t x, std::size_t n)
+  {
+    return static_cast<std::size_t>((static_cast<std::uint64_t>(x) * n) >> 32);
+  }
+
+
+  static std::uint32_t slotFingerprint(std::uint64_t slot)
+  {
+    return static_cast<std::uint32_t>(slot >> DUPLICATE_OFFSET_BITS);
+  }
+
+
+  DuplicateFilter::DuplicateFilter(std::unique_ptr<std::istream> input, int expected)
+    : confirm(std::move(input))
+      , victim(0)
+  {
+    /* about 93% full with every expected line in it */
+    std::size_t lines = expected > 0 ? expected : 1;
+    buckets.resize(lines * 100 / (DUPLICATE_BUCKET * 93) + 1, Bucket{});
+  }
+
+
+  /* NOTE: Documentation
+   * The two buckets of a fingerprint are i and
+   * (h(fp) - i) mod n, applying it twice gets back
+   * to i so an evicted entry knows its other bucket
+   * without the original hash, for any table size
+   * */
+  std::size_t DuplicateFilter::altBucket(std::size_t i, std::uint32_t fp) const
+  {
+    std::size_t n = buckets.size();
+    std::size_t h = reduce(fp * 0x9e3779b1u, n);
+    return h >= i ? h - i : h + n - i;
+  }
+
+
+  bool DuplicateFilter::confirmLine(std::uint64_t offset, const std::string &stripped)
+  {
+    Utillity util;
+    std::string earlier("");
+    confirm->clear();
+    confirm->seekg(offset);
+    std::getline(*confirm, earlier);
+    util.stripComments(earlier);
+    return earlier == stripped;
+  }
+
+
+  bool DuplicateFilter::place(std::size_t i, std::uint64_t entry)
+  {
+    for (auto &s: buckets[i].slot)
+    {
+      if (s == 0)
+      {
+        s = entry;
+        return true;
+      }
+    }
+    return false;
+  }
+
+
+  bool DuplicateFilter::testAndInsert(const std::string &stripped, std::streamoff offset)
+  {
+    std::uint64_t h = std::hash<std::string>{}(stripped);
+    std::uint32_t fp = static_cast<std::uint32_t>(h >> DUPLICATE_OFFSET_BITS);
+    /* 0 marks an empty slot */
+    if (fp == 0) { fp = 1; }
+
+    std::size_t i1 = reduce(static_cast<std::uint32_t>(h), buckets.size());
+    std::size_t i2 = altBucket(i1, fp);
+
+    for (std::size_t i: { i1, i2 })
+    {
+      for (auto s: buckets[i].slot)
+      {
+        if (s != 0 && slotFingerprint(s) == fp && confirmLine(s & OFFSET_MASK, stripped))
+        {
+          return true;
+        }
+      }
+    }
+    for (const auto &s: stash)
+    {
+      if (s.fp == fp && (s.bucket == i1 || s.bucket == i2)
+          && confirmLine(s.offset, stripped))
+      {
+        return true;
+      }
+    }
+
+    if (static_cast<std::uint64_t>(offset) > OFFSET_MASK)
+    {
+      /* too far into the file for a slot, keep the offset whole */
+      stash.push_back({ fp, i1, static_cast<std::uint64_t>(offset) });
+      return false;
+    }
+    std::uint64_t entry = (static_cast<std::uint64_t>(fp) << DUPLICATE_OFFSET_BITS)
+      | static_cast<std::uint64_t>(offset);
+
+    if (place(i1, entry) || place(i2, entry))
+    {
+      return false;
+    }
+
+    /* both buckets are full, evict down a chain of alternates */
+    std::size_t i = i1;
+    for (int kick = 0; kick < DUPLICATE_MAX_KICKS; kick++)
+    {
+      victim = victim * 1664525u + 1013904223u;
+      std::uint64_t &slot = buckets[i].slot[(victim >> 16) % DUPLICATE_BUCKET];
+      std::swap(entry, slot);
+      i = altBucket(i, slotFingerprint(entry));
+      if (place(i, entry))
+      {
+        return false;
+      }
+    }
+    stash.push_back({ slotFingerprint(entry), i, entry & OFFSET_MASK });
+    return false;
+  }
+};
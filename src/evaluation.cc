@@ -2,10 +2,12 @@
    All  main documentaion is in header files
    for corresponding cpp files.
    */
+#include <algorithm>
 #include <iostream>
 #include <iterator>
 #include <sstream>
 #include "../hdr/evaluation.hpp"
+#include "../hdr/trace.hpp"
 
 
 namespace GraderApplication
@@ -20,6 +22,12 @@ namespace GraderApplication
       , category("")
       , maxMark("")
       , weight("")
+      , fixedPoint(false)
+      , threads(1)
+      , diagnostics(&std::cerr)
+      , status(LOAD_OK)
+      , loadError("")
+      , currentLine("")
   {
     /* Init vectors */
     titleContainer.reserve(1);
@@ -29,6 +37,13 @@ namespace GraderApplication
   }
 
 
+  EvaluationData::EvaluationData(const std::string &name, std::shared_ptr<const MappedInput> input)
+    : EvaluationData(name)
+  {
+    this->decompressed = input;
+  }
+
+
   EvaluationData::~EvaluationData(void)
   {
     /* Clear all vectors */
@@ -42,6 +57,33 @@ namespace GraderApplication
   std::string EvaluationData::evaluationFile(void) const { return this->dataFile; }
 
 
+  std::unique_ptr<std::istream> EvaluationData::openInput(void)
+  {
+    if (! (this->decompressed) )
+    {
+      InputCompression compression = inputCompression(this->dataFile);
+      if (compression == PLAIN_INPUT)
+      {
+        return std::unique_ptr<std::istream>(new std::ifstream(this->dataFile));
+      }
+      this->decompressed = std::make_shared<MappedInput>(this->dataFile, compression);
+      if (! (this->decompressed->error().empty()) )
+      {
+        Colors c;
+        *this->diagnostics << c.BRed << "*** " << this->decompressed->error() << ": " << c.Reset
+          << c.BWhite << this->dataFile << c.Reset << std::endl;
+      }
+    }
+    return std::unique_ptr<std::istream>(new MemoryStream(this->decompressed));
+  }
+
+
+  bool EvaluationData::evaluationOnDisk(void) const
+  {
+    return ! (this->decompressed) && inputCompression(this->dataFile) == PLAIN_INPUT;
+  }
+
+
   int EvaluationData::totalEvaluationCount(void) const { return this->totalHeaderCount; }
 
 
@@ -92,7 +134,7 @@ namespace GraderApplication
   std::streampos EvaluationData::currentFilePosition(void) const { return this->currentFilePos; }
 
 
-  void EvaluationData::setCurrentFilePosition(std::ifstream &f) { this->currentFilePos = f.tellg(); }
+  void EvaluationData::setCurrentFilePosition(std::istream &f) { this->currentFilePos = f.tellg(); }
 
 
   std::string EvaluationData::evaluationTitle(void) const { return this->title; }
@@ -118,15 +160,7 @@ namespace GraderApplication
   }
 
 
-  std::string EvaluationData::evaluationTitleContainer(int itr) const
-  {
-    if (itr < 0 || itr > this->evaluationDataLength())
-    {
-      std::cerr << "Iterator found out of bounds for eval data length" << std::endl;
-      exit(EXIT_FAILURE);
-    }
-    return this->titleContainer[itr];
-  }
+  std::string EvaluationData::evaluationTitleContainer(int itr) const { return this->titleContainer.at(itr); }
 
 
   void EvaluationData::setEvaluationTitleContainer(const std::string &_sub)
@@ -173,15 +207,7 @@ namespace GraderApplication
   }
 
 
-  std::string EvaluationData::evaluationCategoryContainer(int itr)
-  {
-    if (itr < 0 || itr > this->evaluationDataLength())
-    {
-      std::cerr << "Iterator found out of bounds for eval data length" << std::endl;
-      exit(EXIT_FAILURE);
-    }
-    return this->categoryContainer[itr];
-  }
+  std::string EvaluationData::evaluationCategoryContainer(int itr) { return this->categoryContainer.at(itr); }
 
 
   void EvaluationData::setEvaluationCategoryContainer(const std::string &_sub)
@@ -189,6 +215,13 @@ namespace GraderApplication
     /* Nothing much to check here */
     this->categoryContainer.emplace_back(_sub);
 
+    std::size_t group = std::find(this->categoryNameContainer.begin(),
+        this->categoryNameContainer.end(), _sub) - this->categoryNameContainer.begin();
+    if (group == this->categoryNameContainer.size())
+    {
+      this->categoryNameContainer.emplace_back(_sub);
+    }
+    this->columnCategoryContainer.emplace_back(group);
   }
 
 
@@ -215,25 +248,39 @@ namespace GraderApplication
   }
 
 
-  float EvaluationData::evaluationMaxMarkContainer(int itr)
-  {
-    if (itr < 0 || itr > this->evaluationDataLength())
-    {
-      std::cerr << "Iterator found out of bounds for eval data length" << std::endl;
-      exit(EXIT_FAILURE);
-    }
-    return this->maxMarkContainer[itr];
-  }
+  float EvaluationData::evaluationMaxMarkContainer(int itr) { return this->maxMarkContainer.at(itr); }
+
+
+  const std::vector<float> &EvaluationData::evaluationMaxMarks(void) const { return this->maxMarkContainer; }
+
+
+  const std::vector<std::int64_t> &EvaluationData::evaluationFixedMaxMarks(void) const { return this->fixedMaxMarkContainer; }
+
+
+  const std::vector<std::int64_t> &EvaluationData::evaluationFixedWeights(void) const { return this->fixedWeightContainer; }
+
+
+  bool EvaluationData::evaluationFixedPoint(void) const { return this->fixedPoint; }
+
+
+  void EvaluationData::setEvaluationFixedPoint(bool _fixedPoint) { this->fixedPoint = _fixedPoint; }
+
+
+  int EvaluationData::evaluationThreads(void) const { return this->threads; }
+
+
+  void EvaluationData::setEvaluationThreads(int _threads) { this->threads = _threads; }
 
 
   void EvaluationData::setEvaluationMaxMarkContainer(std::string &_sub)
   {
     try
     {
-      if (isDigits(_sub))
+      float temp = 0;
+      if (isDigits(_sub) && stringTofloat(_sub, temp))
       {
-        float temp = stringTofloat(_sub);
         this->maxMarkContainer.emplace_back(temp);
+        this->fixedMaxMarkContainer.emplace_back(stringToFixed(_sub.data(), _sub.size()));
       }
       else
       {
@@ -279,10 +326,11 @@ namespace GraderApplication
     float total;
     try
     {
-      if (isDigits(_sub))
+      float temp = 0;
+      if (isDigits(_sub) && stringTofloat(_sub, temp))
       {
-        float temp = stringTofloat(_sub);
         this->weightContainer.emplace_back(temp);
+        this->fixedWeightContainer.emplace_back(stringToFixed(_sub.data(), _sub.size()));
       }
       else
       {
@@ -315,11 +363,139 @@ namespace GraderApplication
   }
 
 
-  void EvaluationData::loadEvaluationData(void)
+  int EvaluationData::evaluationPolicyCount(void) const { return this->policyCategoryContainer.size(); }
+
+
+  std::string EvaluationData::evaluationPolicyCategory(int itr) const { return this->policyCategoryContainer[itr]; }
+
+
+  int EvaluationData::evaluationPolicyDrop(int itr) const { return this->policyDropContainer[itr]; }
+
+
+  void EvaluationData::setEvaluationPolicy(const std::string &_keyword,
+      const std::string &_category, std::string &_count)
+  {
+    try
+    {
+      /* counts are whole numbers only */
+      if (_count.empty() || !(isDigits(_count))
+          || _count.find('.') != std::string::npos)
+      {
+        throw FailStringFloatConversion();
+      }
+
+      int items = 0;
+      for (const auto &cat: this->categoryContainer)
+      {
+        if (cat == _category) { items++; }
+      }
+      if (items == 0)
+      {
+        throw PolicyCategoryNotFound();
+      }
+
+      for (const auto &cat: this->policyCategoryContainer)
+      {
+        if (cat == _category)
+        {
+          throw DuplicateFound();
+        }
+      }
+
+      /* anything this long is out of bounds anyway */
+      if (_count.size() > 6)
+      {
+        throw PolicyOutOfBounds();
+      }
+      int count = std::stoi(_count);
+      int drop = (_keyword == DROP) ? count : items - count;
+      if (drop < 0 || drop >= items)
+      {
+        throw PolicyOutOfBounds();
+      }
+
+      int policy = this->policyCategoryContainer.size();
+      this->policyCategoryContainer.emplace_back(_category);
+      this->policyDropContainer.emplace_back(drop);
+
+      if (this->columnPolicyContainer.empty())
+      {
+        this->columnPolicyContainer.assign(this->categoryContainer.size(), -1);
+      }
+      for (std::size_t j = 0; j < this->categoryContainer.size(); j++)
+      {
+        if (this->categoryContainer[j] == _category)
+        {
+          this->columnPolicyContainer[j] = policy;
+        }
+      }
+    }
+    catch (FailStringFloatConversion &e)
+    {
+      errorPrint(e.what());
+    }
+    catch (PolicyCategoryNotFound &e)
+    {
+      errorPrint(e.what());
+    }
+    catch (DuplicateFound &e)
+    {
+      errorPrint(e.what());
+    }
+    catch (PolicyOutOfBounds &e)
+    {
+      errorPrint(e.what());
+    }
+  }
+
+
+  int EvaluationData::evaluationColumnPolicy(int itr) const
   {
+    if (this->columnPolicyContainer.empty())
+    {
+      return -1;
+    }
+    return this->columnPolicyContainer[itr];
+  }
+
+
+  int EvaluationData::evaluationColumnCategory(int itr) const { return this->columnCategoryContainer[itr]; }
+
+
+  int EvaluationData::evaluationCategoryCount(void) const { return this->categoryNameContainer.size(); }
+
+
+  std::ostream &EvaluationData::evaluationDiagnostics(void) const { return *this->diagnostics; }
+
+
+  void EvaluationData::setEvaluationDiagnostics(std::ostream &out) { this->diagnostics = &out; }
+
+
+  const std::string &EvaluationData::currentLineContent(void) const { return this->currentLine; }
+
+
+  void EvaluationData::setCurrentLineContent(const std::string &_currentLine)
+  {
+    if (!(_currentLine.empty()))
+    {
+      this->currentLine = _currentLine;
+    }
+  }
+
+
+  LoadStatus EvaluationData::evaluationStatus(void) const { return this->status; }
+
+
+  const std::string &EvaluationData::evaluationError(void) const { return this->loadError; }
+
+
+  LoadStatus EvaluationData::loadEvaluationData(void)
+  {
+    TRACE_SCOPE("loadEvaluationData");
     try
     {
-      std::ifstream inFile(this->evaluationFile());
+      std::unique_ptr<std::istream> input = this->openInput();
+      std::istream &inFile = *input;
       std::string line("");
       if (inFile.good())
       {
@@ -390,40 +566,94 @@ namespace GraderApplication
             this->setEvaluationDataLength(i);
           }
 
+          else if (keyword == DROP || keyword == BEST)
+          {
+            std::string policyCategory("");
+            ss >> policyCategory >> sTemp;
+            this->setEvaluationPolicy(keyword, policyCategory, sTemp);
+          }
+
           /* we read a line so increment the count */
           this->setFileLineCount(1);
 
           if (this->totalEvaluationCount() == HEADER_MAX)
           {
             this->setCurrentFilePosition(inFile);
-            inFile.close();
+
+            /* Policies may directly follow the header, blank and
+             * comment lines are only consumed if a policy comes
+             * after them, otherwise they belong to the students
+             * */
+            int pending = 0;
+            while (std::getline(inFile, line))
+            {
+              std::string content(line);
+              this->stripComments(line);
+
+              std::string policyKeyword("");
+              std::string policyCategory("");
+              std::string policyCount("");
+              std::stringstream ps(line);
+              ps >> policyKeyword;
+
+              if (policyKeyword.empty()) { pending++; continue; }
+              if (policyKeyword != DROP && policyKeyword != BEST) { break; }
+
+              this->setFileLineCount(pending + 1);
+              pending = 0;
+              this->setCurrentLineContent(content);
+
+              ps >> policyCategory >> policyCount;
+              this->setEvaluationPolicy(policyKeyword, policyCategory, policyCount);
+              this->setCurrentFilePosition(inFile);
+            }
+            /* the rest of the file belongs to the students */
+            break;
           }
         }
+
+        /* ran out of file with a header line still missing */
+        if (this->totalEvaluationCount() != HEADER_MAX)
+        {
+          errorPrint(HeaderIncomplete().what());
+        }
       }
       else
       {
-        throw std::logic_error("*** File Not Found: ");
+        this->status = LOAD_NOT_FOUND;
+        this->loadError = "could not read " + this->evaluationFile();
+
+        /* openInput already reported a failed decompression */
+        if (! (this->decompressed) ) { throw std::logic_error("*** File Not Found: "); }
       }
     }
     catch (std::logic_error &e)
     {
       Colors c;
-      std::cerr << c.BRed << e.what() << c.Reset << c.BWhite <<
+      *this->diagnostics << c.BRed << e.what() << c.Reset << c.BWhite <<
         this->evaluationFile() << c.Reset << std::endl;
     }
+    catch (HeaderError &e)
+    {
+      /* errorPrint has written it out, the gradebook can not be graded */
+      this->status = LOAD_BAD_HEADER;
+      this->loadError = "line " + std::to_string(e.lineNumber()) + ": " + e.what();
+    }
+    return this->status;
   }
 
 
   void EvaluationData::errorPrint(const char *a)
   {
     Colors c;
-    std::cerr << c.BRed << "ERROR: " << c.Reset
+    std::ostream &err = *this->diagnostics;
+    err << c.BRed << "ERROR: " << c.Reset
       << c.BWhite << a << c.Reset <<  std::endl;
-    std::cerr << c.BYellow << "Offending line number: " << c.Reset
+    err << c.BYellow << "Offending line number: " << c.Reset
       << c.BWhite << this->fileLineCount() << c.Reset << std::endl;
-    std::cerr << c.BYellow << "Offending content: " << c.Reset
+    err << c.BYellow << "Offending content: " << c.Reset
       << c.BWhite << this->currentLineContent() << c.Reset << std::endl;
 
-    exit (EXIT_FAILURE);
+    throw HeaderError(a, this->fileLineCount());
   }
 };
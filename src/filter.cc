@@ -0,0 +1,539 @@
+/* All  main documentaion is in header files
+ * for corresponding cpp files.
+ * */
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include "../hdr/filter.hpp"
+#include "../hdr/trace.hpp"
+#include "../hdr/writer.hpp"
+
+
+/* What a piece of an expression gives, a batch of floats or of bits */
+enum FilterType
+{
+  FILTER_NUMBER,
+  FILTER_TEST
+};
+
+
+/* The report columns FILTER_SCORE reads, in FilterScore order */
+static float (StudentData::*const scoreGetters[])(void) const = {
+  &StudentData::studentLabScore,
+  &StudentData::studentAssignScore,
+  &StudentData::studentMidtermScore,
+  &StudentData::studentFinalScore,
+  &StudentData::studentTotalGrade
+};
+
+
+/* Recursive descent over the expression, emitting the
+ * postfix program and tracking how deep each stack gets
+ * */
+class FilterParser
+{
+  private:
+    const std::string &src;
+    std::size_t pos;
+    EvaluationData &e;
+    std::vector<FilterOp> &program;
+    int numbers;
+    int tests;
+
+  public:
+    int maxNumbers;
+    int maxTests;
+
+    FilterParser(const std::string &_src, EvaluationData &_e, std::vector<FilterOp> &_program)
+      : src(_src)
+        , pos(0)
+        , e(_e)
+        , program(_program)
+        , numbers(0)
+        , tests(0)
+        , maxNumbers(0)
+        , maxTests(0)
+    { }
+
+
+    void parse(void)
+    {
+      std::size_t start = skipSpace();
+      if (start == src.size()) { throw FilterError("an expression is needed", start); }
+      expect(orExpr(), FILTER_TEST, start, "the expression is a number, not a test");
+      if (skipSpace() != src.size()) { throw FilterError("unexpected text", pos); }
+    }
+
+  private:
+    std::size_t skipSpace(void)
+    {
+      while (pos < src.size() && std::isspace(static_cast<unsigned char>(src[pos]))) { pos++; }
+      return pos;
+    }
+
+
+    /* take the operator op if it is next */
+    bool accept(const char *op)
+    {
+      skipSpace();
+      std::size_t n = std::char_traits<char>::length(op);
+      if (src.compare(pos, n, op) != 0) { return false; }
+      pos += n;
+      return true;
+    }
+
+
+    void expect(FilterType got, FilterType want, std::size_t at, const char *message)
+    {
+      if (got != want) { throw FilterError(message, at); }
+    }
+
+
+    /* push the op, number ops pop pops numbers and push pushes numbers */
+    void emit(FilterOpCode code, int popNumbers, int popTests, FilterType push,
+        std::uint32_t arg = 0, float value = 0)
+    {
+      program.push_back({ code, arg, value });
+      numbers -= popNumbers;
+      tests -= popTests;
+      if (push == FILTER_NUMBER) { numbers++; }
+      else                       { tests++; }
+      maxNumbers = std::max(maxNumbers, numbers);
+      maxTests = std::max(maxTests, tests);
+    }
+
+
+    FilterType orExpr(void)
+    {
+      std::size_t at = skipSpace();
+      FilterType left = andExpr();
+      while (accept("||"))
+      {
+        std::size_t right = skipSpace();
+        expect(left, FILTER_TEST, at, "|| needs a test on its left");
+        expect(andExpr(), FILTER_TEST, right, "|| needs a test on its right");
+        emit(FILTER_OR, 0, 2, FILTER_TEST);
+      }
+      return left;
+    }
+
+
+    FilterType andExpr(void)
+    {
+      std::size_t at = skipSpace();
+      FilterType left = notExpr();
+      while (accept("&&"))
+      {
+        std::size_t right = skipSpace();
+        expect(left, FILTER_TEST, at, "&& needs a test on its left");
+        expect(notExpr(), FILTER_TEST, right, "&& needs a test on its right");
+        emit(FILTER_AND, 0, 2, FILTER_TEST);
+      }
+      return left;
+    }
+
+
+    FilterType notExpr(void)
+    {
+      /* ! but not != */
+      skipSpace();
+      if (pos < src.size() && src[pos] == '!' && src.compare(pos, 2, "!=") != 0)
+      {
+        pos++;
+        std::size_t at = skipSpace();
+        expect(notExpr(), FILTER_TEST, at, "! needs a test");
+        emit(FILTER_NOT, 0, 1, FILTER_TEST);
+        return FILTER_TEST;
+      }
+      return comparison();
+    }
+
+
+    FilterType comparison(void)
+    {
+      static const struct { const char *op; FilterOpCode code; } ops[] = {
+        { "<=", FILTER_LE }, { ">=", FILTER_GE }, { "==", FILTER_EQ },
+        { "!=", FILTER_NE }, { "<", FILTER_LT }, { ">", FILTER_GT }
+      };
+
+      std::size_t at = skipSpace();
+      FilterType left = sum();
+      for (const auto &o: ops)
+      {
+        if (! (accept(o.op)) ) { continue; }
+        std::size_t right = skipSpace();
+        expect(left, FILTER_NUMBER, at, "only numbers can be compared");
+        expect(sum(), FILTER_NUMBER, right, "only numbers can be compared");
+        emit(o.code, 2, 0, FILTER_TEST);
+        return FILTER_TEST;
+      }
+      return left;
+    }
+
+
+    FilterType sum(void)
+    {
+      std::size_t at = skipSpace();
+      FilterType left = product();
+      for (;;)
+      {
+        FilterOpCode code;
+        if      (accept("+")) { code = FILTER_ADD; }
+        else if (accept("-")) { code = FILTER_SUB; }
+        else                  { return left; }
+        std::size_t right = skipSpace();
+        expect(left, FILTER_NUMBER, at, "only numbers can be added");
+        expect(product(), FILTER_NUMBER, right, "only numbers can be added");
+        emit(code, 2, 0, FILTER_NUMBER);
+      }
+    }
+
+
+    FilterType product(void)
+    {
+      std::size_t at = skipSpace();
+      FilterType left = unary();
+      for (;;)
+      {
+        FilterOpCode code;
+        if      (accept("*")) { code = FILTER_MUL; }
+        else if (accept("/")) { code = FILTER_DIV; }
+        else                  { return left; }
+        std::size_t right = skipSpace();
+        expect(left, FILTER_NUMBER, at, "only numbers can be multiplied");
+        expect(unary(), FILTER_NUMBER, right, "only numbers can be multiplied");
+        emit(code, 2, 0, FILTER_NUMBER);
+      }
+    }
+
+
+    FilterType unary(void)
+    {
+      if (accept("-"))
+      {
+        std::size_t at = skipSpace();
+        expect(unary(), FILTER_NUMBER, at, "only a number can be negated");
+        emit(FILTER_NEG, 1, 0, FILTER_NUMBER);
+        return FILTER_NUMBER;
+      }
+      return primary();
+    }
+
+
+    FilterType primary(void)
+    {
+      std::size_t at = skipSpace();
+      if (at == src.size()) { throw FilterError("the expression ends too soon", at); }
+
+      char ch = src[at];
+      if (ch == '(')
+      {
+        pos++;
+        FilterType inner = orExpr();
+        if (! (accept(")")) ) { throw FilterError("missing )", skipSpace()); }
+        return inner;
+      }
+
+      if (std::isdigit(static_cast<unsigned char>(ch)) || ch == '.')
+      {
+        char *end = nullptr;
+        float value = std::strtof(src.c_str() + at, &end);
+        if (end == src.c_str() + at) { throw FilterError("bad number", at); }
+        pos = end - src.c_str();
+        emit(FILTER_CONST, 0, 0, FILTER_NUMBER, 0, value);
+        return FILTER_NUMBER;
+      }
+
+      std::string name;
+      if (ch == '`')
+      {
+        std::size_t close = src.find('`', at + 1);
+        if (close == std::string::npos) { throw FilterError("missing closing `", at); }
+        name = src.substr(at + 1, close - at - 1);
+        pos = close + 1;
+        return column(name, at);
+      }
+
+      while (pos < src.size() && (std::isalnum(static_cast<unsigned char>(src[pos]))
+            || src[pos] == '_' || src[pos] == '.'))
+      {
+        pos++;
+      }
+      if (pos == at) { throw FilterError(std::string("unexpected ") + ch, at); }
+      name = src.substr(at, pos - at);
+
+      if (name == "letter") { return letterTest(at); }
+      if (name == "wdr")    { emit(FILTER_WDR, 0, 0, FILTER_TEST); return FILTER_TEST; }
+      if (name == "error")  { emit(FILTER_ERROR, 0, 0, FILTER_TEST); return FILTER_TEST; }
+
+      static const char *scores[] = { "lab", "assign", "midterm", "final", "total" };
+      for (std::uint32_t s = FILTER_LAB; s <= FILTER_TOTAL; s++)
+      {
+        if (name == scores[s])
+        {
+          emit(FILTER_SCORE, 0, 0, FILTER_NUMBER, s);
+          return FILTER_NUMBER;
+        }
+      }
+      return column(name, at);
+    }
+
+
+    /* a TITLE, else a report category */
+    FilterType column(const std::string &name, std::size_t at)
+    {
+      int m = e.evaluationDataLength();
+      for (int j = 0; j < m; j++)
+      {
+        if (e.evaluationTitleContainer(j) == name)
+        {
+          emit(FILTER_MARK, 0, 0, FILTER_NUMBER, j);
+          return FILTER_NUMBER;
+        }
+      }
+
+      static const char *categories[] = { "Lab", "Assign", "Midterm", "Final" };
+      for (std::uint32_t s = FILTER_LAB; s <= FILTER_FINAL; s++)
+      {
+        if (name == categories[s])
+        {
+          emit(FILTER_SCORE, 0, 0, FILTER_NUMBER, s);
+          return FILTER_NUMBER;
+        }
+      }
+      throw FilterError("unknown name " + name, at);
+    }
+
+
+    /* letter == L, letter != L or letter in (L, ...) */
+    FilterType letterTest(std::size_t at)
+    {
+      bool negate = false;
+      std::uint32_t mask = 0;
+      if (accept("=="))    { mask = letter(); }
+      else if (accept("!=")) { mask = letter(); negate = true; }
+      else if (accept("in"))
+      {
+        if (! (accept("(")) ) { throw FilterError("letter in needs a ( list )", skipSpace()); }
+        do { mask |= letter(); } while (accept(","));
+        if (! (accept(")")) ) { throw FilterError("missing )", skipSpace()); }
+      }
+      else
+      {
+        throw FilterError("letter is tested with ==, != or in", at);
+      }
+
+      emit(FILTER_LETTER_IN, 0, 0, FILTER_TEST, mask);
+      if (negate) { emit(FILTER_NOT, 0, 1, FILTER_TEST); }
+      return FILTER_TEST;
+    }
+
+
+    /* the LetterGrade bit of a grade as the report prints it, WDR for withdrawn */
+    std::uint32_t letter(void)
+    {
+      std::size_t at = skipSpace();
+      while (pos < src.size() && std::isalnum(static_cast<unsigned char>(src[pos]))) { pos++; }
+      if (pos < src.size() && (src[pos] == '+' || src[pos] == '-')) { pos++; }
+
+      std::string text = src.substr(at, pos - at);
+      std::transform(text.begin(), text.end(), text.begin(),
+          [](unsigned char c) { return std::toupper(c); });
+      if (text == "WDR") { return 1u << LETTER_WITHDRAWN; }
+      for (int l = LETTER_A_PLUS; l <= LETTER_WITHDRAWN; l++)
+      {
+        if (letterGradeText(static_cast<LetterGrade>(l)) == text) { return 1u << l; }
+      }
+      throw FilterError(text.empty() ? "missing letter grade" : "unknown letter grade " + text, at);
+    }
+};
+
+
+RowFilter::RowFilter(void)
+  : numberDepth(0)
+    , bitsDepth(0)
+{ }
+
+
+bool RowFilter::compile(const std::string &expression, EvaluationData &e)
+{
+  program.clear();
+  compileError.clear();
+  try
+  {
+    FilterParser parser(expression, e, program);
+    parser.parse();
+    numberDepth = parser.maxNumbers;
+    bitsDepth = parser.maxTests;
+  }
+  catch (FilterError &err)
+  {
+    /* the message, the expression and a caret under the mistake */
+    compileError = std::string(err.what()) + "\n\t\t" + expression + "\n\t\t"
+      + std::string(err.characterPosition(), ' ') + "^";
+    program.clear();
+    return false;
+  }
+  return true;
+}
+
+
+const std::string &RowFilter::error(void) const { return this->compileError; }
+
+
+/* one bit per row of the batch, for a comparison of two number batches */
+template <typename Compare>
+static void compareBatch(const float *a, const float *b, std::uint64_t *out, Compare cmp)
+{
+  for (int w = 0; w < FILTER_WORDS; w++)
+  {
+    std::uint64_t word = 0;
+    for (int k = 0; k < 64; k++)
+    {
+      word |= static_cast<std::uint64_t>(cmp(a[w * 64 + k], b[w * 64 + k])) << k;
+    }
+    out[w] = word;
+  }
+}
+
+
+void RowFilter::selectRows(const StudentVector &v, ContainerSection section, std::size_t begin,
+    std::size_t end, float *numbers, std::uint64_t *tests, std::uint64_t *out) const
+{
+  const std::size_t n = end - begin;
+  const bool graded = section == GRADED_SECTION;
+  int ns = 0;
+  int ts = 0;
+
+  for (const FilterOp &op: program)
+  {
+    float *top = numbers + ns * FILTER_BATCH;
+    float *a = top - 2 * FILTER_BATCH;
+    float *b = top - FILTER_BATCH;
+    std::uint64_t *bits = tests + ts * FILTER_WORDS;
+    std::uint64_t *x = bits - 2 * FILTER_WORDS;
+    std::uint64_t *y = bits - FILTER_WORDS;
+
+    switch (op.code)
+    {
+      /* withdrawn and error rows have no numbers */
+      case FILTER_MARK:
+        if (graded)
+        {
+          for (std::size_t k = 0; k < n; k++) { top[k] = v[begin + k].studentGrades()[op.arg]; }
+        }
+        else { std::fill(top, top + n, NAN); }
+        ns++;
+        break;
+      case FILTER_SCORE:
+        if (graded)
+        {
+          auto get = scoreGetters[op.arg];
+          for (std::size_t k = 0; k < n; k++) { top[k] = (v[begin + k].*get)(); }
+        }
+        else { std::fill(top, top + n, NAN); }
+        ns++;
+        break;
+      case FILTER_CONST:
+        std::fill(top, top + FILTER_BATCH, op.value);
+        ns++;
+        break;
+
+      case FILTER_ADD: for (int k = 0; k < FILTER_BATCH; k++) { a[k] = a[k] + b[k]; } ns--; break;
+      case FILTER_SUB: for (int k = 0; k < FILTER_BATCH; k++) { a[k] = a[k] - b[k]; } ns--; break;
+      case FILTER_MUL: for (int k = 0; k < FILTER_BATCH; k++) { a[k] = a[k] * b[k]; } ns--; break;
+      case FILTER_DIV: for (int k = 0; k < FILTER_BATCH; k++) { a[k] = a[k] / b[k]; } ns--; break;
+      case FILTER_NEG: for (int k = 0; k < FILTER_BATCH; k++) { b[k] = -b[k]; } break;
+
+      /* every comparison with a NaN is false, != included */
+      case FILTER_LT: compareBatch(a, b, bits, [](float l, float r) { return l < r; }); ns -= 2; ts++; break;
+      case FILTER_LE: compareBatch(a, b, bits, [](float l, float r) { return l <= r; }); ns -= 2; ts++; break;
+      case FILTER_GT: compareBatch(a, b, bits, [](float l, float r) { return l > r; }); ns -= 2; ts++; break;
+      case FILTER_GE: compareBatch(a, b, bits, [](float l, float r) { return l >= r; }); ns -= 2; ts++; break;
+      case FILTER_EQ: compareBatch(a, b, bits, [](float l, float r) { return l == r; }); ns -= 2; ts++; break;
+      case FILTER_NE:
+        compareBatch(a, b, bits, [](float l, float r) { return l < r || l > r; });
+        ns -= 2;
+        ts++;
+        break;
+
+      case FILTER_LETTER_IN:
+        std::fill(bits, bits + FILTER_WORDS, 0);
+        for (std::size_t k = 0; k < n; k++)
+        {
+          std::uint64_t hit = (op.arg >> v[begin + k].studentLetter()) & 1;
+          bits[k / 64] |= hit << (k % 64);
+        }
+        ts++;
+        break;
+      case FILTER_WDR:
+      case FILTER_ERROR:
+        {
+          bool all = (op.code == FILTER_WDR && section == WDR_SECTION)
+            || (op.code == FILTER_ERROR && section == ERROR_SECTION);
+          std::fill(bits, bits + FILTER_WORDS, all ? ~std::uint64_t(0) : 0);
+          ts++;
+        }
+        break;
+
+      case FILTER_AND: for (int w = 0; w < FILTER_WORDS; w++) { x[w] &= y[w]; } ts--; break;
+      case FILTER_OR:  for (int w = 0; w < FILTER_WORDS; w++) { x[w] |= y[w]; } ts--; break;
+      case FILTER_NOT: for (int w = 0; w < FILTER_WORDS; w++) { y[w] = ~y[w]; } break;
+    }
+  }
+
+  /* only the rows of this batch, a short last batch leaves the rest unset */
+  std::size_t words = (n + 63) / 64;
+  for (std::size_t w = 0; w < words; w++) { out[w] = tests[w]; }
+  if (n % 64 != 0) { out[words - 1] &= (std::uint64_t(1) << (n % 64)) - 1; }
+}
+
+
+void RowFilter::select(const Container &c, int threads, FilterSelection &selection) const
+{
+  const StudentVector *sections[] = { &c.student, &c.wdr, &c.error };
+  std::vector<std::uint64_t> *bits[] = { &selection.graded, &selection.wdr, &selection.error };
+
+  for (int s = GRADED_SECTION; s <= ERROR_SECTION; s++)
+  {
+    const StudentVector &v = *sections[s];
+    std::vector<std::uint64_t> &out = *bits[s];
+    out.assign((v.size() + 63) / 64, 0);
+
+    /* batches write disjoint words, so ranges of them run on separate threads */
+    std::size_t batches = (v.size() + FILTER_BATCH - 1) / FILTER_BATCH;
+    parallelFor(batches, threads, [&](std::size_t begin, std::size_t end)
+    {
+      std::vector<float> numbers(std::max(numberDepth, 1) * FILTER_BATCH, 0);
+      std::vector<std::uint64_t> tests(std::max(bitsDepth, 1) * FILTER_WORDS, 0);
+      for (std::size_t b = begin; b < end; b++)
+      {
+        std::size_t from = b * FILTER_BATCH;
+        selectRows(v, static_cast<ContainerSection>(s), from,
+            std::min(v.size(), from + FILTER_BATCH), numbers.data(), tests.data(),
+            out.data() + b * FILTER_WORDS);
+      }
+    });
+  }
+}
+
+
+void outputSelected(const Container &c, const FilterSelection &selection, OutputWriter &writer)
+{
+  TRACE_SCOPE("outputSelected");
+  writer.begin();
+  for (std::size_t i = 0; i < c.student.size(); i++)
+  {
+    if (FilterSelection::selected(selection.graded, i)) { writer.writeStudent(c.student[i]); }
+  }
+  for (std::size_t i = 0; i < c.wdr.size(); i++)
+  {
+    if (FilterSelection::selected(selection.wdr, i)) { writer.writeWDR(c.wdr[i]); }
+  }
+  for (std::size_t i = 0; i < c.error.size(); i++)
+  {
+    if (FilterSelection::selected(selection.error, i)) { writer.writeError(c.error[i]); }
+  }
+  writer.finish();
+}
@@ -0,0 +1,149 @@
+/* All  main documentaion is in header files
+ * for corresponding cpp files.
+ * */
+#include <algorithm>
+#include "../hdr/fixedpoint.hpp"
+#include "../hdr/kernel.hpp"
+#include "../hdr/policy.hpp"
+#include "../hdr/trace.hpp"
+#include "../hdr/writer.hpp"
+
+
+/* num / den rounded half up, both non negative */
+static std::int64_t roundedDivide(__int128 num, std::int64_t den)
+{
+  return static_cast<std::int64_t>((num + den / 2) / den);
+}
+
+
+/* a sum of units as the hundredths it prints as */
+static float toPoints(std::int64_t units)
+{
+  return static_cast<float>(roundedDivide(units, FIXED_HUNDREDTH)) / 100;
+}
+
+
+void makeFixedGrades(EvaluationData &e, Container &c, OutputWriter *writer)
+{
+  int stuSize = c.student.size();
+  int m = e.evaluationDataLength();
+  const std::vector<std::int64_t> &maxMarks = e.evaluationFixedMaxMarks();
+  const std::vector<std::int64_t> &weights = e.evaluationFixedWeights();
+
+  /* Everything per column is worked out once */
+  std::vector<std::int64_t> factor(m);
+  std::vector<int> category = reportCategories(e);
+  for ( int j = 0; j < m; j++ )
+  {
+    factor[j] = maxMarks[j] > 0
+      ? roundedDivide(static_cast<__int128>(weights[j]) * FIXED_UNIT, maxMarks[j] * FIXED_SCALE)
+      : 0;
+  }
+
+  /* DROP / BEST and EX renormalize per category of the header */
+  bool hasPolicies = e.evaluationPolicyCount() > 0;
+  int numCategories = e.evaluationCategoryCount();
+  std::vector<int> group(m);
+  std::vector<std::int64_t> categoryWeight(numCategories, 0);
+  std::int64_t totalWeight = 0;
+  for ( int j = 0; j < m; j++ )
+  {
+    group[j] = e.evaluationColumnCategory(j);
+    categoryWeight[group[j]] += weights[j];
+    totalWeight += weights[j];
+  }
+  if (hasPolicies)
+  {
+    selectKeptMarks(e, c);
+  }
+
+  int threads = e.evaluationThreads();
+  auto gradeRange = [&](std::size_t begin, std::size_t end)
+  {
+    TRACE_SCOPE("gradeRange");
+    std::vector<std::int64_t> marks(m);
+    std::vector<std::int64_t> units(m);
+    std::vector<std::int64_t> keptWeight(numCategories, 0);
+    std::vector<int> keptCount(numCategories, 0);
+    std::vector<std::int64_t> keep(m);
+    std::vector<float> calculated(m);
+    for ( int i = begin; i < static_cast<int>(end); i++ )
+    {
+      StudentData &stu = c.student[i];
+      for ( int j = 0; j < m; j++ ) { marks[j] = stu.studentFixedGrade(j); }
+
+      /* (mark * weight) / maxmark, a multiply per column */
+      for ( int j = 0; j < m; j++ ) { units[j] = marks[j] * factor[j]; }
+
+      /* only rows with dropped or exempt marks are renormalized */
+      const std::uint64_t *exempt = stu.studentExemptBits();
+      if (hasPolicies || exempt != nullptr)
+      {
+        const unsigned char *mask = hasPolicies
+          ? &c.markMask[static_cast<std::size_t>(i) * m] : nullptr;
+        std::fill(keptWeight.begin(), keptWeight.end(), 0);
+        std::fill(keptCount.begin(), keptCount.end(), 0);
+        for ( int j = 0; j < m; j++ )
+        {
+          /* 1 for a kept mark, 0 for a dropped or exempt one */
+          std::uint64_t k = mask != nullptr ? mask[j] : 1;
+          if (exempt != nullptr) { k &= ~(exempt[j >> 6] >> (j & 63)); }
+          keep[j] = k & 1;
+          keptWeight[group[j]] += keep[j] * weights[j];
+          keptCount[group[j]] += keep[j];
+        }
+
+        /* a category with nothing left hands its weight to the rest */
+        std::int64_t lostWeight = 0;
+        for ( int g = 0; g < numCategories; g++ )
+        {
+          lostWeight += keptCount[g] == 0 ? categoryWeight[g] : 0;
+        }
+        std::int64_t spreadNum = totalWeight;
+        std::int64_t spreadDen = totalWeight - lostWeight;
+        if (lostWeight == 0 || spreadDen <= 0) { spreadNum = spreadDen = 1; }
+
+        for ( int j = 0; j < m; j++ )
+        {
+          int g = group[j];
+          units[j] *= keep[j];
+          if (keptWeight[g] == 0) { units[j] = 0; continue; }
+          if (keptWeight[g] == categoryWeight[g] && lostWeight == 0) { continue; }
+          units[j] = roundedDivide(static_cast<__int128>(units[j]) * categoryWeight[g] * spreadNum,
+              keptWeight[g] * spreadDen);
+        }
+      }
+
+      /* Accumulate category grades, KERNEL_OTHER for the rest */
+      std::int64_t categories[KERNEL_CATEGORIES] = { 0, 0, 0, 0, 0 };
+      std::int64_t total = 0;
+      for ( int j = 0; j < m; j++ )
+      {
+        categories[category[j]] += units[j];
+        total += units[j];
+        calculated[j] = static_cast<float>(static_cast<double>(units[j]) / FIXED_UNIT);
+      }
+
+      stu.setStudentLabScore(toPoints(categories[KERNEL_LAB]));
+      stu.setStudentAssignScore(toPoints(categories[KERNEL_ASSIGN]));
+      stu.setStudentMidtermScore(toPoints(categories[KERNEL_MIDTERM]));
+      stu.setStudentFinalScore(toPoints(categories[KERNEL_FINAL]));
+      stu.setCalculatedGrades(calculated);
+
+      /* The total is already exact to the hundredth */
+      float finalGrade = toPoints(total);
+      stu.setStudentTotalGrade(finalGrade);
+      stu.setStudentLetter(assignLetter(finalGrade));
+
+      /* hand the row on as soon as it is graded */
+      if (writer != nullptr && threads == 1) { writer->writeStudent(stu); }
+    }
+  };
+  parallelFor(stuSize, threads, gradeRange);
+
+  /* threads finish out of order, the rows go out in order */
+  if (writer != nullptr && threads > 1)
+  {
+    for (const auto &stu: c.student) { writer->writeStudent(stu); }
+  }
+}
@@ -1,7 +1,23 @@
 #include <chrono>
 #include <iomanip>
+#include <limits>
+#include <sstream>
 #include "../hdr/argparser.hpp"
+#include "../hdr/diff.hpp"
+#include "../hdr/filter.hpp"
+#include "../hdr/fixedpoint.hpp"
+#include "../hdr/join.hpp"
 #include "../hdr/grader.hpp"
+#include "../hdr/kernel.hpp"
+#include "../hdr/perfcount.hpp"
+#include "../hdr/pipeline.hpp"
+#include "../hdr/policy.hpp"
+#include "../hdr/search.hpp"
+#include "../hdr/server.hpp"
+#include "../hdr/stream.hpp"
+#include "../hdr/trace.hpp"
+#include "../hdr/writer.hpp"
+#include "../hdr/whatif.hpp"
 
 
 /* Define container explicit constructor */
@@ -16,12 +32,6 @@ Container::Container(int _x)
 
 Container::~Container(void)
 {
-  /* Check to see if the temp file
-   * exists, if it does delete it
-   * */
-  std::ifstream temp(TEMPFILE);
-  if (temp.good()) { temp.close(); sanitize(); }
-
   /* Clean up Vectors */
   student.clear();
   error.clear();
@@ -29,6 +39,8 @@ Container::~Container(void)
 }
 
 
+#ifndef GRADER_LIBRARY
+
 /* NOTE: Documentation
  * Initialize main routine,
  * */
@@ -38,27 +50,259 @@ int main(int argc, char **argv)
 
   std::string inputFile("");
   std::string name("");
+  std::string whatIfFile("");
+  std::string socketPath("");
+  std::string format("table");
+  std::string streamWindow("");
+  std::string tokensFile("");
+  std::string threadCount("1");
+  std::string whereExpression("");
+  std::string diffFile("");
+  std::string indexFile("");
   ArgParse parser("-s");
-  int numargsfilled = parser.parseArguments(argc, argv, inputFile, name);
+  parser.extractOption(argc, argv, "--what-if", whatIfFile);
+  parser.extractOption(argc, argv, "--format", format);
+  parser.extractOption(argc, argv, "--stream", streamWindow);
+  bool fixedPoint = parser.extractFlag(argc, argv, "--fixed-point");
+  bool statsOnly = parser.extractFlag(argc, argv, "--stats");
+  parser.extractOption(argc, argv, "--threads", threadCount);
+  bool filtered = parser.extractOption(argc, argv, "--where", whereExpression);
+  bool joined = parser.extractFlag(argc, argv, "--join");
+  bool diffed = parser.extractOption(argc, argv, "--diff", diffFile);
+  bool perfCounters = parser.extractFlag(argc, argv, "--perf-counters");
+  bool pipelined = parser.extractFlag(argc, argv, "--pipeline");
+
+  int threads = 0;
+  if (threadCount.find_first_not_of("0123456789") == std::string::npos
+      && threadCount.size() < 3)
+  {
+    threads = std::stoi(threadCount);
+  }
+  if (threads < 1 || threads > MAX_THREADS)
+  {
+    fprintf(stderr, "\n\t\t--threads needs a count from 1 to %d\n\n", MAX_THREADS);
+    parser.printUsage();
+  }
 
-  if (numargsfilled > 0)
+  std::unique_ptr<OutputWriter> writer(makeWriter(format, std::cout, std::cerr));
+  if (! (writer) )
   {
-    EvaluationData eval(inputFile);
-    eval.loadEvaluationData();
-    int numStudents = countStudentLines(eval);
-    Container container(numStudents);
+    fprintf(stderr, "\n\t\tUnknown --format: %s\n\n", format.c_str());
+    parser.printUsage();
+  }
+
+  if (parser.extractOption(argc, argv, "--tokens", tokensFile))
+  {
+    /* the whole file as the scanner splits it, header included */
+    EvaluationData eval(tokensFile);
+    std::unique_ptr<std::istream> input = eval.openInput();
+    if (! (input->good()) )
+    {
+      std::cerr << "*** File Not Found: " << tokensFile << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    dumpTokens(*input, std::cout);
+    exit(EXIT_SUCCESS);
+  }
+
+  if (parser.extractOption(argc, argv, "--index", indexFile))
+  {
+    EvaluationData eval(indexFile);
+    if (eval.loadEvaluationData() != LOAD_OK) { exit(EXIT_FAILURE); }
+    long indexed = writeLineIndex(eval);
+    if (indexed < 0) { exit(EXIT_FAILURE); }
+    std::cout << "Indexed " << indexed << " student lines: " << indexPath(indexFile) << std::endl;
+    exit(EXIT_SUCCESS);
+  }
+
+  if (parser.extractOption(argc, argv, "--serve", socketPath))
+  {
+    /* every remaining argument is a gradebook to serve */
+    std::vector<std::string> files(argv + 1, argv + argc);
+    if (files.empty())
+    {
+      fprintf(stderr, "\n\t\t--serve needs at least one file\n\n");
+      parser.printUsage();
+    }
+    exit(runServer(socketPath, files));
+  }
+
+  /* A joined gradebook is read from the temporary file the join
+   * wrote, inputFile then only names it in messages
+   * */
+  std::shared_ptr<const MappedInput> joinedBook;
+  int numargsfilled = 0;
+  if (joined)
+  {
+    /* every remaining argument is a gradebook to join */
+    numargsfilled = parser.extractOption(argc, argv, "-s", name) ? 2 : 1;
+    std::vector<std::string> files(argv + 1, argv + argc);
+    if (files.size() < 2)
+    {
+      fprintf(stderr, "\n\t\t--join needs at least two files\n\n");
+      parser.printUsage();
+    }
+    for (const auto &f: files) { inputFile += (inputFile.empty() ? "" : "+") + f; }
+
+    GradebookJoin join(files, std::cerr);
+    joinedBook = join.join();
+    if (! (joinedBook) ) { exit(EXIT_FAILURE); }
+  }
+  else
+  {
+    numargsfilled = parser.parseArguments(argc, argv, inputFile, name);
+  }
+
+  if (perfCounters && (diffed || pipelined || ! (streamWindow.empty())) )
+  {
+    fprintf(stderr, "\n\t\t--perf-counters measures the phases of a loaded gradebook, not --stream, --pipeline or --diff\n\n");
+    parser.printUsage();
+  }
+
+  if (diffed)
+  {
+    /* the other file argument is the new gradebook */
+    if (numargsfilled != 1 || joined || filtered || statsOnly || pipelined || ! (whatIfFile.empty())
+        || ! (streamWindow.empty()) )
+    {
+      fprintf(stderr, "\n\t\t--diff needs an old and a new file, and no other report\n\n");
+      parser.printUsage();
+    }
+    exit(diffGradebooks(diffFile, inputFile, fixedPoint, threads, std::cout) ? EXIT_SUCCESS : EXIT_FAILURE);
+  }
+
+  if (numargsfilled > 0 && filtered
+      && (numargsfilled != 1 || ! (whatIfFile.empty()) || statsOnly || ! (streamWindow.empty()) || pipelined) )
+  {
+    fprintf(stderr, "\n\t\t--where needs a full report, without -s, --what-if, --stats, --stream or --pipeline\n\n");
+    parser.printUsage();
+  }
+
+  if (numargsfilled > 0 && pipelined
+      && (numargsfilled != 1 || ! (whatIfFile.empty()) || statsOnly || ! (streamWindow.empty())) )
+  {
+    fprintf(stderr, "\n\t\t--pipeline needs a full report, without -s, --what-if, --stats or --stream\n\n");
+    parser.printUsage();
+  }
 
-    loadStudentContainers(eval, container);
-    makeGrades(eval, container);
+  if (numargsfilled > 0 && ! (streamWindow.empty()) )
+  {
+    /* The window is the only bound on how many students are held */
+    int window = 0;
+    if (streamWindow.find_first_not_of("0123456789") == std::string::npos
+        && streamWindow.size() < 10)
+    {
+      window = std::stoi(streamWindow);
+    }
+    if (window < 1 || numargsfilled != 1 || ! (whatIfFile.empty()) || statsOnly)
+    {
+      fprintf(stderr, "\n\t\t--stream needs a window of at least 1 student, and a full report\n\n");
+      parser.printUsage();
+    }
+
+    EvaluationData eval(inputFile, joinedBook);
+    eval.setEvaluationFixedPoint(fixedPoint);
+    eval.setEvaluationThreads(threads);
+    /* what is wrong with the gradebook has already been written out */
+    if (eval.loadEvaluationData() != LOAD_OK) { exit(EXIT_FAILURE); }
+    if (! (streamGrades(eval, *writer, window)) ) { exit(EXIT_FAILURE); }
+  }
+  else if (numargsfilled > 0 && pipelined)
+  {
+    EvaluationData eval(inputFile, joinedBook);
+    eval.setEvaluationFixedPoint(fixedPoint);
+    eval.setEvaluationThreads(threads);
+    /* what is wrong with the gradebook has already been written out */
+    if (eval.loadEvaluationData() != LOAD_OK) { exit(EXIT_FAILURE); }
+    if (! (pipelineGrades(eval, *writer, std::cerr)) ) { exit(EXIT_FAILURE); }
+  }
+  else if (numargsfilled > 0)
+  {
+    /* every phase is timed, and counted where the hardware lets us */
+    std::unique_ptr<PerfCounters> counters(perfCounters ? new PerfCounters() : nullptr);
+    auto lap = [&](const char *phase) { if (counters) { counters->lap(phase); } };
+
+    lap("header");
+    EvaluationData eval(inputFile, joinedBook);
+    eval.setEvaluationFixedPoint(fixedPoint);
+    eval.setEvaluationThreads(threads);
+    /* what is wrong with the gradebook has already been written out */
+    if (eval.loadEvaluationData() != LOAD_OK) { exit(EXIT_FAILURE); }
+
+    /* the expression names header columns, so it is checked before any row is read */
+    RowFilter filter;
+    if (filtered && ! (filter.compile(whereExpression, eval)) )
+    {
+      fprintf(stderr, "\n\t\t--where: %s\n\n", filter.error().c_str());
+      exit(EXIT_FAILURE);
+    }
 
-    if (numargsfilled == 1)
+    /* a single student is read straight from its lines if the gradebook is indexed */
+    LineIndex index;
+    IndexStatus indexStatus = INDEX_MISSING;
+    if (numargsfilled == 2 && whatIfFile.empty() && ! (isPatternSearch(name)) )
+    {
+      indexStatus = index.open(eval);
+      if (indexStatus == INDEX_STALE)
+      {
+        Colors color;
+        std::cerr << color.BYellow << "*** Index out of date, reading every line: " << color.Reset
+          << color.BWhite << indexPath(inputFile) << color.Reset << std::endl;
+      }
+    }
+
+    lap("count");
+    int numStudents = indexStatus == INDEX_FRESH ? 1 : countStudentLines(eval);
+    Container container(numStudents);
+
+    lap("load");
+    LoadStatus loaded = indexStatus == INDEX_FRESH ? loadIndexedStudent(eval, index, name, container)
+      : loadStudentContainers(eval, container);
+    if (loaded != LOAD_OK) { exit(EXIT_FAILURE); }
+
+    /* Use a precision stream to round grades to hundreths place, an
+     * indexed search has not read the other rows, it goes by whether
+     * the gradebook has any
+     * */
+    bool anyGraded = indexStatus == INDEX_FRESH ? index.size() > 0 : ! (container.student.empty());
+    if (anyGraded) { std::cout << std::fixed << std::setprecision(2); }
+
+    /* A full report streams each row out while grading */
+    bool fullReport = whatIfFile.empty() && numargsfilled == 1 && ! (statsOnly) && ! (filtered);
+    if (fullReport) { writer->begin(); }
+    lap("grade");
+    makeGrades(eval, container, fullReport ? writer.get() : nullptr);
+    lap("output");
+
+    if (! (whatIfFile.empty()) )
+    {
+      WhatIfScenarios scenarios;
+      if (loadWhatIfScenarios(eval, whatIfFile, scenarios) > 0)
+      {
+        std::vector<float> totals;
+        computeWhatIfTotals(eval, container, scenarios, totals);
+        outputWhatIf(container, scenarios, totals);
+      }
+    }
+    else if (filtered)
     {
-      /* Only output a vector if its size is greater than 0 */
-      if (container.student.size() > 0) { outputStudent(container); }
+      FilterSelection selection;
+      filter.select(container, threads, selection);
+      outputSelected(container, selection, *writer);
+    }
+    else if (numargsfilled == 1 && statsOnly)
+    {
+      outputStats(container, threads, std::cout);
+    }
+    else if (numargsfilled == 1)
+    {
+      TRACE_SCOPE("outputReport");
+      /* The graded students went out from makeGrades */
+      for (const auto &i: container.wdr) { writer->writeWDR(i); }
 
-      if (container.wdr.size() > 0) { outputWDR(container); }
+      for (const auto &i: container.error) { writer->writeError(i); }
 
-      if (container.error.size() > 0) { outputError(container); }
+      writer->finish();
 
       //auto end = std::chrono::system_clock::now();
       //std::chrono::duration<double> elapsed_seconds = end-start;
@@ -67,10 +311,27 @@ int main(int argc, char **argv)
 
     }
     /* Both arguments were filled */
+    else if (numargsfilled == 2 && isPatternSearch(name))
+    {
+      if (! (outputSearch(container, name)) ) { exit(EXIT_FAILURE); }
+    }
     else if (numargsfilled == 2)
     {
-      StudentData stu = searchStudent(container, name);
-      outputStudent(stu);
+      const StudentData *stu = searchStudent(container, name);
+      if (stu == nullptr)
+      {
+        outputNotFound(name);
+        exit(EXIT_FAILURE);
+      }
+      outputStudent(*stu);
+    }
+
+    if (counters)
+    {
+      counters->stop();
+      std::cout.flush();
+      counters->report(container.student.size() + container.wdr.size() + container.error.size(),
+          std::cerr);
     }
   }
   else
@@ -81,211 +342,275 @@ int main(int argc, char **argv)
 
   exit(EXIT_SUCCESS);
 }
+#endif
 
 
-int countStudentLines(const EvaluationData &e)
+int countStudentLines(EvaluationData &e)
 {
-  std::streampos jump;
-  jump = e.currentFilePosition();
+  TRACE_SCOPE("countStudentLines");
+  LineIndex index;
+  if (index.open(e) == INDEX_FRESH) { return index.size(); }
 
-  std::ifstream inFile(e.evaluationFile());
-  inFile.seekg(jump);
+  std::unique_ptr<std::istream> input = e.openInput();
+  std::istream &inFile = *input;
   int numberOfLines = 0;
-  std::string dummyLine("");
 
   if ( inFile.good() )
   {
-    while ( std::getline( inFile, dummyLine ))
+    inFile.seekg(e.currentFilePosition());
+    BlockReader reader(inFile, e.currentFilePosition());
+    while ( reader.next() )
     {
-      if (! ( dummyLine.empty()) ) { ++numberOfLines; }
+      if (reader.line().start != reader.line().end) { ++numberOfLines; }
     }
   }
 
-  inFile.close();
   return numberOfLines;
 }
 
 
-void loadStudentContainers(EvaluationData &e, Container &c)
+/* into the section of the Container a loaded student belongs in */
+static void placeStudent(Container &c, StudentData &stu)
 {
-  for (int i = 0; i < c.numStudents; i++)
+  if (stu.studentError())
   {
-    StudentData stu;
-    if (stu.loadStudents(e))
-    {
-      if (stu.studentError())
-      {
-        c.error.emplace_back(stu);
-      }
-      else if (stu.studentWDR())
-      {
-        stu.setStudentLetterGrade("WITHDRAWN");
-        c.wdr.emplace_back(stu);
-      }
-      else
-      {
-        c.student.emplace_back(stu);
-      }
-    }
+    c.error.emplace_back(std::move(stu));
+  }
+  else if (stu.studentWDR())
+  {
+    stu.setStudentLetter(LETTER_WITHDRAWN);
+    c.wdr.emplace_back(std::move(stu));
+  }
+  else
+  {
+    c.student.emplace_back(std::move(stu));
   }
 }
 
 
-StudentData searchStudent(const Container &c, const std::string &name)
+LoadStatus loadStudentContainers(EvaluationData &e, Container &c)
 {
-  /* Check each container for the student name */
-  bool found = false;
-  StudentData targetStudent;
+  TRACE_SCOPE("loadStudents");
+  std::unique_ptr<std::istream> input = e.openInput();
+  std::istream &inFile = *input;
+  if (! (inFile.good()) )
+  {
+    e.evaluationDiagnostics() << "*** File Not Found: " << e.evaluationFile() << std::endl;
+    return LOAD_NOT_FOUND;
+  }
+  inFile.seekg(e.currentFilePosition());
 
-  for (const auto &elem: c.student)
+  DuplicateFilter seen(e.openInput(), c.numStudents);
+  BlockReader reader(inFile, e.currentFilePosition());
+  while (reader.next())
   {
-    if (elem.studentName() == name)
+    e.setFileLineCount(1);
+    /* skip empty lines */
+    if (reader.line().start == reader.line().end)
     {
-      found = true;
-      targetStudent = std::move(elem);
+      continue;
     }
+
+    StudentData stu;
+    if (stu.loadStudent(reader, e, seen)) { placeStudent(c, stu); }
   }
+  TRACE_COUNTER("graded", c.student.size());
+  TRACE_COUNTER("withdrawn", c.wdr.size());
+  TRACE_COUNTER("errors", c.error.size());
+  return LOAD_OK;
+}
+
 
-  if ( !(found) )
+LoadStatus loadIndexedStudent(EvaluationData &e, const LineIndex &index, const std::string &name,
+    Container &c)
+{
+  TRACE_SCOPE("loadIndexedStudent");
+  std::unique_ptr<std::istream> input = e.openInput();
+  std::istream &inFile = *input;
+  if (! (inFile.good()) )
   {
-    for (const auto &elem: c.wdr)
-    {
-      if (elem.studentName() == name)
-      {
-        found = true;
-        targetStudent = std::move(elem);
-      }
-    }
+    e.evaluationDiagnostics() << "*** File Not Found: " << e.evaluationFile() << std::endl;
+    return LOAD_NOT_FOUND;
   }
 
-  if ( !(found) )
+  std::vector<std::size_t> rows;
+  index.find(name, rows);
+  DuplicateFilter seen(e.openInput(), rows.size());
+  for (auto row: rows)
   {
-    for (const auto &elem: c.error)
+    /* each row is read and scanned on its own, where it lies in the file */
+    std::string text;
+    inFile.clear();
+    inFile.seekg(index.lineOffset(row));
+    std::getline(inFile, text);
+    std::istringstream line(text);
+    BlockReader reader(line, index.lineOffset(row));
+    if (! (reader.next()) || reader.line().numTokens == 0) { continue; }
+
+    const TokenSpan &id = reader.lineTokens()[0];
+    if (name.compare(0, std::string::npos, reader.data() + id.start, id.end - id.start) != 0)
     {
-      if (elem.studentName() == name)
-      {
-        found = true;
-        targetStudent = std::move(elem);
-      }
+      continue;
     }
+
+    e.setFileLineCount(index.lineNumber(row) - e.fileLineCount());
+    StudentData stu;
+    if (stu.loadStudent(reader, e, seen)) { placeStudent(c, stu); }
   }
+  return LOAD_OK;
+}
 
-  /* If found is still false, the student does not exist */
-  try
+
+const StudentData *searchStudent(const Container &c, const std::string &name)
+{
+  /* Check each container for the student name, the last
+   * match in the first container that has one wins
+   * */
+  const StudentData *targetStudent = nullptr;
+  for (const StudentVector *section: { &c.student, &c.wdr, &c.error })
   {
-    if (! (found) )
+    for (const auto &elem: *section)
     {
-      throw StudentNotFound();
+      if (elem.studentName() == name) { targetStudent = &elem; }
     }
+    if (targetStudent != nullptr) { break; }
   }
-  catch (StudentNotFound &e)
+  return targetStudent;
+}
+
+
+void outputNotFound(const std::string &name)
+{
+  Colors color;
+  std::cout << color.BYellow << StudentNotFound().what() << color.Reset
+    << color.BWhite << name << color.Reset << std::endl;
+}
+
+
+std::vector<int> reportCategories(EvaluationData &e)
+{
+  int m = e.evaluationDataLength();
+  std::vector<int> category(m);
+  for ( int j = 0; j < m; j++ )
   {
-    Colors color;
-    std::cout << color.BYellow << e.what() << color.Reset 
-      << color.BWhite << name << color.Reset << std::endl;
-    sanitize();
-    exit(EXIT_FAILURE);
+    const std::string name = e.evaluationCategoryContainer(j);
+    if      ( name == "Lab" )     { category[j] = KERNEL_LAB; }
+    else if ( name == "Assign" )  { category[j] = KERNEL_ASSIGN; }
+    else if ( name == "Midterm" ) { category[j] = KERNEL_MIDTERM; }
+    else if ( name == "Final" )   { category[j] = KERNEL_FINAL; }
+    else                          { category[j] = KERNEL_OTHER; }
   }
-
-  return targetStudent;
+  return category;
 }
 
 
-void makeGrades(EvaluationData &e, Container &c)
+void makeGrades(EvaluationData &e, Container &c, OutputWriter *writer)
 {
+  TRACE_SCOPE("makeGrades");
+  if (e.evaluationFixedPoint())
+  {
+    makeFixedGrades(e, c, writer);
+    return;
+  }
+
   int stuSize = c.student.size();
-  for ( int i = 0; i < stuSize; i++ )
+  int m = e.evaluationDataLength();
+  int threads = e.evaluationThreads();
+
+  /* Category policies only need the weight vector and a scale per column */
+  bool hasPolicies = e.evaluationPolicyCount() > 0;
+  std::vector<float> weights(m);
+  if (hasPolicies)
   {
-    // create temp vector
-    std::vector<float> tempGradeContainer;
-    tempGradeContainer.reserve(e.evaluationDataLength());
+    selectKeptMarks(e, c);
+  }
+  for ( int j = 0; j < m; j++ ) { weights[j] = e.evaluationWeightContainer(j); }
 
-    float tempValue = 0.0;
-    for ( int j = 0; j < e.evaluationDataLength(); j++ )
-    {
-      // first calculate single grades (mark * weight) / maxmark
-      tempValue = subGradeComputation(e, c, i, j);
-      tempGradeContainer.emplace_back(tempValue);
-    }
+  /* Each column's report category, looked up once instead of per row */
+  std::vector<int> category = reportCategories(e);
+  RowKernel gradeRow = rowKernel(m);
 
-    /* Accumulate category grades */
-    for ( int k = 0; k < e.evaluationDataLength(); k++ )
+  /* Every student is graded on its own, so ranges of them
+   * can be graded on separate threads
+   * */
+  auto gradeRange = [&](std::size_t begin, std::size_t end)
+  {
+    TRACE_SCOPE("gradeRange");
+    std::vector<float> scale(m);
+    std::vector<float> tempGradeContainer(m);
+    RowColumns cols = { weights.data(), e.evaluationMaxMarks().data(), category.data(), nullptr };
+    for ( int i = begin; i < static_cast<int>(end); i++ )
     {
-      /*
-       * These values are hardcoded, there has to be a better
-       * way to do this
-       */
-      float t = 0;
-      if ( e.evaluationCategoryContainer(k) == "Lab" )
-      {
-        t = tempGradeContainer[k];
-        c.student[i].setStudentLabScore(t);
-      }
-      else if (e.evaluationCategoryContainer(k) == "Assign")
-      {
-        t = tempGradeContainer[k];
-        c.student[i].setStudentAssignScore(t);
-      }
-      else if (e.evaluationCategoryContainer(k) == "Midterm")
-      {
-        t = tempGradeContainer[k];
-        c.student[i].setStudentMidtermScore(t);
-      }
-      else if (e.evaluationCategoryContainer(k) == "Final")
+      StudentData &stu = c.student[i];
+
+      /* only rows with dropped or exempt marks are renormalized */
+      const std::uint64_t *exempt = stu.studentExemptBits();
+      bool renormalized = hasPolicies || exempt != nullptr;
+      cols.scale = nullptr;
+      if (renormalized)
       {
-        t = tempGradeContainer[k];
-        c.student[i].setStudentFinalScore(t);
+        policyColumnScale(e, hasPolicies ? &c.markMask[static_cast<std::size_t>(i) * m] : nullptr,
+            exempt, weights.data(), scale.data());
+        cols.scale = scale.data();
       }
-    }
 
-    c.student[i].setCalculatedGrades(tempGradeContainer);
+      /* (mark * weight) / maxmark per column, summed per category and in total */
+      float categories[KERNEL_CATEGORIES] = { 0, 0, 0, 0, 0 };
+      float finalGrade = gradeRow(stu.studentGrades(), cols, m, tempGradeContainer.data(), categories);
+      if (renormalized) { finalGrade = std::min(finalGrade, static_cast<float>(MAX_GRADE)); }
 
-    /* Add all subgrades together for final grade */
-    float finalGrade = e.vecSummation(tempGradeContainer);
+      stu.setStudentLabScore(categories[KERNEL_LAB]);
+      stu.setStudentAssignScore(categories[KERNEL_ASSIGN]);
+      stu.setStudentMidtermScore(categories[KERNEL_MIDTERM]);
+      stu.setStudentFinalScore(categories[KERNEL_FINAL]);
+      stu.setCalculatedGrades(tempGradeContainer);
 
-    /* Use a precision stream to round grades to hundreths place */
-    std::cout << std::fixed << std::setprecision(2);
-
-    c.student[i].setStudentTotalGrade(finalGrade);
-    std::string letter = assignLetterGrade(finalGrade);
-    c.student[i].setStudentLetterGrade(letter);
-  }
-}
+      stu.setStudentTotalGrade(finalGrade);
+      stu.setStudentLetter(assignLetter(finalGrade));
 
+      /* hand the row on as soon as it is graded */
+      if (writer != nullptr && threads == 1) { writer->writeStudent(stu); }
+    }
+  };
+  parallelFor(stuSize, threads, gradeRange);
 
-float subGradeComputation(EvaluationData &e, Container &c, int i, int j)
-{
-  return (( c.student[i].studentGradesContainer(j)
-        * e.evaluationWeightContainer(j) ) / e.evaluationMaxMarkContainer(j));
+  /* threads finish out of order, the rows go out in order */
+  if (writer != nullptr && threads > 1)
+  {
+    TRACE_SCOPE("writeStudents");
+    for (const auto &stu: c.student) { writer->writeStudent(stu); }
+  }
 }
 
 
-std::string assignLetterGrade(float grade)
+LetterGrade assignLetter(float grade)
 {
-  /* Call to settings.h for definitions, macro routines and
-   * struct working together to assign grade
+  /* Call to settings.h for definitions, macro routines
+   * working together to assign grade
    * */
-  Echelon echelon;
-  if      ( IS_A_PLUS(grade)  )  { return echelon.high_A; }
-  else if ( IS_A(grade)       )  { return echelon.mid_A;  }
-  else if ( IS_A_MINUS(grade) )  { return echelon.low_A;  }
-  else if ( IS_B_PLUS(grade)  )  { return echelon.high_B; }
-  else if ( IS_B(grade)       )  { return echelon.mid_B;  }
-  else if ( IS_B_MINUS(grade) )  { return echelon.low_B;  }
-  else if ( IS_C_PLUS(grade)  )  { return echelon.high_C; }
-  else if ( IS_C(grade)       )  { return echelon.mid_C;  }
-  else if ( IS_C_MINUS(grade) )  { return echelon.low_C;  }
-  else if ( IS_D(grade)       )  { return echelon.D;      }
-  else if ( IS_F(grade)       )  { return echelon.F;      }
+  if      ( IS_A_PLUS(grade)  )  { return LETTER_A_PLUS;  }
+  else if ( IS_A(grade)       )  { return LETTER_A;       }
+  else if ( IS_A_MINUS(grade) )  { return LETTER_A_MINUS; }
+  else if ( IS_B_PLUS(grade)  )  { return LETTER_B_PLUS;  }
+  else if ( IS_B(grade)       )  { return LETTER_B;       }
+  else if ( IS_B_MINUS(grade) )  { return LETTER_B_MINUS; }
+  else if ( IS_C_PLUS(grade)  )  { return LETTER_C_PLUS;  }
+  else if ( IS_C(grade)       )  { return LETTER_C;       }
+  else if ( IS_C_MINUS(grade) )  { return LETTER_C_MINUS; }
+  else if ( IS_D(grade)       )  { return LETTER_D;       }
+  else if ( IS_F(grade)       )  { return LETTER_F;       }
 
   // Enter debug state if we return this
-  else { return "Grade went wrong"; }
+  else { return LETTER_INVALID; }
 }
 
 
-void outputStudent(const Container &c)
+std::string assignLetterGrade(float grade) { return letterGradeText(assignLetter(grade)); }
+
+
+void outputHeader(std::ostream &out)
 {
-  std::cout << std::left << std::setw(10) << "Name"
+  out << std::left << std::setw(10) << "Name"
     << std::left << std::setw(10) << "Lab"
     << std::left << std::setw(10) << "Assign"
     << std::left << std::setw(10) << "Midterm"
@@ -293,24 +618,37 @@ void outputStudent(const Container &c)
     << std::left << std::setw(10) << "Total"
     << std::left << std::setw(10) << "Letter"
     << std::endl;
+}
+
+
+void outputRow(const StudentData &s, std::ostream &out)
+{
+  out << std::left << std::setw(10) << s.studentName()
+    << std::left << std::setw(10) << s.studentLabScore()
+    << std::left << std::setw(10) << s.studentAssignScore()
+    << std::left << std::setw(10) << s.studentMidtermScore()
+    << std::left << std::setw(10) << s.studentFinalScore()
+    << std::left << std::setw(10) << s.studentTotalGrade()
+    << std::left << std::setw(10) << s.studentLetterGrade()
+    << std::endl;
+}
 
 
+void outputStudent(const Container &c, std::ostream &out)
+{
+  TRACE_SCOPE("outputStudent");
+  outputHeader(out);
+
   for (const auto &i: c.student)
   {
-    std::cout << std::left << std::setw(10) << i.studentName()
-      << std::left << std::setw(10) << i.studentLabScore()
-      << std::left << std::setw(10) << i.studentAssignScore()
-      << std::left << std::setw(10) << i.studentMidtermScore()
-      << std::left << std::setw(10) << i.studentFinalScore()
-      << std::left << std::setw(10) << i.studentTotalGrade()
-      << std::left << std::setw(10) << i.studentLetterGrade()
-      << std::endl;
+    outputRow(i, out);
   }
 }
 
 
 void outputStudent(const StudentData &s)
 {
+  TRACE_SCOPE("outputStudent");
   if (s.studentError())
   {
     std::cerr << "\n\nOffending line: " << s.lineCount()
@@ -321,57 +659,91 @@ void outputStudent(const StudentData &s)
 
   else
   {
-    std::cout << std::left << std::setw(10) << "Name"
-      << std::left << std::setw(10) << "Lab"
-      << std::left << std::setw(10) << "Assign"
-      << std::left << std::setw(10) << "Midterm"
-      << std::left << std::setw(10) << "Final"
-      << std::left << std::setw(10) << "Total"
-      << std::left << std::setw(10) << "Letter"
-      << std::endl;
-
-    std::cout << std::left << std::setw(10) << s.studentName()
-      << std::left << std::setw(10) << s.studentLabScore()
-      << std::left << std::setw(10) << s.studentAssignScore()
-      << std::left << std::setw(10) << s.studentMidtermScore()
-      << std::left << std::setw(10) << s.studentFinalScore()
-      << std::left << std::setw(10) << s.studentTotalGrade()
-      << std::left << std::setw(10) << s.studentLetterGrade()
-      << std::endl;
+    outputHeader(std::cout);
+    outputRow(s, std::cout);
   }
 }
 
 
-void outputWDR(const Container &c)
+void outputWDR(const Container &c, std::ostream &out)
 {
+  TRACE_SCOPE("outputWDR");
   for (const auto &i: c.wdr)
   {
-    std::cout << std::left << std::setw(10) << i.studentName()
-      << std::left << std::setw(10) << i.studentLabScore()
-      << std::left << std::setw(10) << i.studentAssignScore()
-      << std::left << std::setw(10) << i.studentMidtermScore()
-      << std::left << std::setw(10) << i.studentFinalScore()
-      << std::left << std::setw(10) << i.studentTotalGrade()
-      << std::left << std::setw(10) << i.studentLetterGrade()
-      << std::endl;
+    outputRow(i, out);
   }
 }
 
 
+void outputErrorEntry(const StudentData &s, std::ostream &out)
+{
+  Colors color;
+  out << color.BRed << "\nError message: " << color.Reset
+    << color.BWhite << s.errorDefinition() << color.Reset 
+    << color.BYellow << "\nOffending line: " << color.Reset 
+    << color.BWhite << s.lineCount() << color.Reset
+    << color.BYellow << "\nOffending content: " << color.Reset 
+    << color.BWhite << s.currentLineContent() << color.Reset
+    << std::endl;
+}
+
+
 void outputError(const Container &c)
 {
+  TRACE_SCOPE("outputError");
   for (const auto &i: c.error)
   {
-    Colors color;
-    std::cerr << color.BRed << "\nError message: " << color.Reset
-      << color.BWhite << i.errorDefinition() << color.Reset 
-      << color.BYellow << "\nOffending line: " << color.Reset 
-      << color.BWhite << i.lineCount() << color.Reset
-      << color.BYellow << "\nOffending content: " << color.Reset 
-      << color.BWhite << i.currentLineContent() << color.Reset
-      << std::endl;
+    outputErrorEntry(i, std::cerr);
   }
 }
 
 
-void sanitize(void) { std::system(SANITIZE); }
+void outputStats(const Container &c, int threads, std::ostream &out)
+{
+  TRACE_SCOPE("outputStats");
+  out << "Graded: " << c.student.size()
+    << "\nWithdrawn: " << c.wdr.size()
+    << "\nErrors: " << c.error.size() << "\n";
+
+  if (c.student.empty()) { return; }
+
+  std::size_t n = c.student.size();
+  std::vector<double> totals(n);
+  parallelFor(n, threads, [&](std::size_t begin, std::size_t end)
+  {
+    for (std::size_t i = begin; i < end; i++) { totals[i] = c.student[i].studentTotalGrade(); }
+  });
+  double mean = deterministicSum(totals.data(), n, threads) / n;
+
+  float low = c.student[0].studentTotalGrade();
+  float high = low;
+  std::vector<std::pair<std::string, int>> letters;
+  for (const auto &s: c.student)
+  {
+    float total = s.studentTotalGrade();
+    low = std::min(low, total);
+    high = std::max(high, total);
+
+    bool counted = false;
+    for (auto &l: letters)
+    {
+      if (l.first == s.studentLetterGrade()) { l.second++; counted = true; break; }
+    }
+    if (! (counted) ) { letters.emplace_back(s.studentLetterGrade(), 1); }
+  }
+
+  std::ios_base::fmtflags flags = out.flags();
+  std::streamsize precision = out.precision();
+  out << "Mean: " << std::defaultfloat << std::setprecision(std::numeric_limits<double>::max_digits10)
+    << mean;
+  out.flags(flags);
+  out.precision(precision);
+
+  out << "\nMin: " << low
+    << "\nMax: " << high << "\n";
+  for (const auto &l: letters)
+  {
+    out << std::left << std::setw(10) << l.first << l.second << "\n";
+  }
+}
+
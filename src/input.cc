@@ -0,0 +1,437 @@
+/* All  main documentaion is in header files
+ * for corresponding cpp files.
+ * */
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+#ifdef GRADER_ZSTD
+#include <zstd.h>
+#endif
+#include "../hdr/input.hpp"
+
+
+namespace GraderApplication
+{
+  /* what the first n (up to 4) bytes say the input is */
+  static InputCompression magicCompression(const unsigned char *magic, std::size_t n)
+  {
+    if (n >= 2 && magic[0] == 0x1f && magic[1] == 0x8b)
+    {
+      return GZIP_INPUT;
+    }
+    if (n >= 4 && magic[0] == 0x28 && magic[1] == 0xb5
+        && magic[2] == 0x2f && magic[3] == 0xfd)
+    {
+      return ZSTD_INPUT;
+    }
+    return PLAIN_INPUT;
+  }
+
+
+  InputCompression inputCompression(const std::string &file)
+  {
+    unsigned char magic[4] = { 0, 0, 0, 0 };
+    std::ifstream in(file, std::ios::binary);
+    in.read(reinterpret_cast<char *>(magic), sizeof(magic));
+    return magicCompression(magic, in.gcount());
+  }
+
+
+  /* NOTE: Documentation
+   * Blocks come out of the decompressing threads in any
+   * order and are written in index order. A producer waits
+   * while its block is too far ahead of the writer, the
+   * block being waited on is never held back so the
+   * pipeline always moves
+   * */
+  class BlockQueue
+  {
+    private:
+      std::mutex lock;
+      std::condition_variable changed;
+      std::map<std::size_t, std::string> ready;
+      std::size_t next;
+      std::size_t total;
+      std::size_t window;
+      bool failed;
+
+    public:
+      explicit BlockQueue(std::size_t _window)
+        : next(0)
+          , total(static_cast<std::size_t>(-1))
+          , window(_window)
+          , failed(false)
+      { }
+
+      bool push(std::size_t index, std::string &&block)
+      {
+        std::unique_lock<std::mutex> guard(lock);
+        changed.wait(guard, [&] { return failed || index < next + window; });
+        if (failed) { return false; }
+        ready.emplace(index, std::move(block));
+        changed.notify_all();
+        return true;
+      }
+
+      /* no block will come after count */
+      void close(std::size_t count)
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        total = count;
+        changed.notify_all();
+      }
+
+      /* the next block in order, false once all are out */
+      bool pop(std::string &block)
+      {
+        std::unique_lock<std::mutex> guard(lock);
+        changed.wait(guard, [&] { return failed || next == total || ready.count(next) > 0; });
+        if (failed || next == total) { return false; }
+        block = std::move(ready[next]);
+        ready.erase(next++);
+        changed.notify_all();
+        return true;
+      }
+
+      void fail(void)
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        failed = true;
+        changed.notify_all();
+      }
+  };
+
+
+  static bool writeAll(std::FILE *file, const std::string &block)
+  {
+    return std::fwrite(block.data(), 1, block.size(), file) == block.size();
+  }
+
+
+  MappedInput::MappedInput(const std::string &file, InputCompression compression)
+    : spool(std::tmpfile())
+      , mapped(nullptr)
+      , length(0)
+      , problem("")
+  {
+    int fd = open(file.c_str(), O_RDONLY);
+    struct stat st;
+    if (spool == nullptr || fd < 0 || fstat(fd, &st) != 0)
+    {
+      problem = "could not open input";
+      if (fd >= 0) { close(fd); }
+      return;
+    }
+
+    /* the compressed file is only read, map it whole */
+    std::size_t compressedSize = st.st_size;
+    void *source = compressedSize > 0
+      ? mmap(nullptr, compressedSize, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (source == MAP_FAILED)
+    {
+      problem = "could not map input";
+      return;
+    }
+
+    const unsigned char *bytes = static_cast<const unsigned char *>(source);
+    if (compression == GZIP_INPUT)
+    {
+      decompressGzip(bytes, compressedSize);
+    }
+    else
+    {
+      decompressZstd(bytes, compressedSize);
+    }
+    munmap(source, compressedSize);
+
+    if (problem.empty()) { mapSpool(); }
+  }
+
+
+  MappedInput::MappedInput(const char *buffer, std::size_t size)
+    : spool(nullptr)
+      , mapped(nullptr)
+      , length(0)
+      , problem("")
+  {
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(buffer);
+    InputCompression compression = magicCompression(bytes, std::min<std::size_t>(size, 4));
+    if (compression == PLAIN_INPUT)
+    {
+      /* a plain buffer is read straight from a copy */
+      copy.assign(buffer, size);
+      mapped = copy.data();
+      length = size;
+      return;
+    }
+
+    spool = std::tmpfile();
+    if (spool == nullptr)
+    {
+      problem = "could not open input";
+      return;
+    }
+    if (compression == GZIP_INPUT)
+    {
+      decompressGzip(bytes, size);
+    }
+    else
+    {
+      decompressZstd(bytes, size);
+    }
+    if (problem.empty()) { mapSpool(); }
+  }
+
+
+  MappedInput::MappedInput(std::FILE *written)
+    : spool(written)
+      , mapped(nullptr)
+      , length(0)
+      , problem("")
+  {
+    if (spool == nullptr)
+    {
+      problem = "could not open input";
+      return;
+    }
+    mapSpool();
+  }
+
+
+  MappedInput::~MappedInput(void)
+  {
+    /* only a spool is ever mapped */
+    if (mapped != nullptr && spool != nullptr) { munmap(const_cast<char *>(mapped), length); }
+    if (spool != nullptr) { std::fclose(spool); }
+  }
+
+
+  void MappedInput::mapSpool(void)
+  {
+    if (std::fflush(spool) != 0)
+    {
+      problem = "could not write the decompressed input";
+      return;
+    }
+
+    length = std::ftell(spool);
+    if (length == 0) { return; }
+
+    void *view = mmap(nullptr, length, PROT_READ, MAP_SHARED, fileno(spool), 0);
+    if (view == MAP_FAILED)
+    {
+      problem = "could not map the decompressed input";
+      length = 0;
+      return;
+    }
+    mapped = static_cast<const char *>(view);
+  }
+
+
+  void MappedInput::decompressGzip(const unsigned char *src, std::size_t srcSize)
+  {
+    BlockQueue queue(INPUT_QUEUE_DEPTH);
+    std::string inflateProblem("");
+
+    /* one member after another, gzip can not be split */
+    std::thread producer([&]
+    {
+      z_stream zs{};
+      std::size_t index = 0;
+      if (inflateInit2(&zs, 15 + 32) != Z_OK)
+      {
+        inflateProblem = "could not start gzip";
+        queue.fail();
+        return;
+      }
+
+      zs.next_in = const_cast<unsigned char *>(src);
+      zs.avail_in = srcSize;
+      int status = Z_OK;
+      while (status != Z_STREAM_END || zs.avail_in > 0)
+      {
+        if (status == Z_STREAM_END) { inflateReset(&zs); }
+
+        std::string block(INPUT_BLOCK, '\0');
+        zs.next_out = reinterpret_cast<unsigned char *>(&block[0]);
+        zs.avail_out = INPUT_BLOCK;
+        status = inflate(&zs, Z_NO_FLUSH);
+        if (status != Z_OK && status != Z_STREAM_END)
+        {
+          inflateProblem = status == Z_BUF_ERROR ? "truncated gzip data" : "corrupt gzip data";
+          break;
+        }
+
+        block.resize(INPUT_BLOCK - zs.avail_out);
+        if (! (queue.push(index++, std::move(block))) ) { break; }
+      }
+      inflateEnd(&zs);
+
+      if (inflateProblem.empty()) { queue.close(index); }
+      else { queue.fail(); }
+    });
+
+    std::string block("");
+    while (queue.pop(block))
+    {
+      if (! (writeAll(spool, block)) )
+      {
+        problem = "could not write the decompressed input";
+        queue.fail();
+        break;
+      }
+    }
+    producer.join();
+
+    if (problem.empty()) { problem = inflateProblem; }
+  }
+
+
+  void MappedInput::decompressZstd(const unsigned char *src, std::size_t srcSize)
+  {
+#ifdef GRADER_ZSTD
+    /* frame boundaries first, each frame decompresses on its own */
+    std::vector<std::pair<std::size_t, std::size_t>> frames;
+    for (std::size_t pos = 0; pos < srcSize; )
+    {
+      std::size_t frameSize = ZSTD_findFrameCompressedSize(src + pos, srcSize - pos);
+      if (ZSTD_isError(frameSize))
+      {
+        problem = "corrupt zstd data";
+        return;
+      }
+      frames.emplace_back(pos, frameSize);
+      pos += frameSize;
+    }
+
+    int workers = std::max(1u, std::min(8u, std::thread::hardware_concurrency()));
+    workers = std::min<int>(workers, std::max<std::size_t>(frames.size(), 1));
+    BlockQueue queue(static_cast<std::size_t>(workers) * INPUT_QUEUE_DEPTH);
+    queue.close(frames.size());
+    std::atomic<std::size_t> nextFrame(0);
+    std::atomic<bool> corrupt(false);
+
+    auto worker = [&]
+    {
+      ZSTD_DCtx *dctx = ZSTD_createDCtx();
+      std::size_t f;
+      while ((f = nextFrame++) < frames.size())
+      {
+        const unsigned char *frame = src + frames[f].first;
+        std::size_t frameSize = frames[f].second;
+        std::string block("");
+
+        unsigned long long contentSize = ZSTD_getFrameContentSize(frame, frameSize);
+        if (contentSize != ZSTD_CONTENTSIZE_UNKNOWN && contentSize != ZSTD_CONTENTSIZE_ERROR)
+        {
+          block.resize(contentSize);
+          std::size_t got = ZSTD_decompressDCtx(dctx, &block[0], block.size(), frame, frameSize);
+          if (ZSTD_isError(got)) { corrupt = true; }
+          else { block.resize(got); }
+        }
+        else
+        {
+          /* no size in the frame header, stream it out */
+          ZSTD_DCtx_reset(dctx, ZSTD_reset_session_only);
+          ZSTD_inBuffer in = { frame, frameSize, 0 };
+          std::size_t ret = 1;
+          while (ret != 0 && ! (corrupt) )
+          {
+            std::size_t at = block.size();
+            block.resize(at + INPUT_BLOCK);
+            ZSTD_outBuffer out = { &block[at], INPUT_BLOCK, 0 };
+            ret = ZSTD_decompressStream(dctx, &out, &in);
+            block.resize(at + out.pos);
+            if (ZSTD_isError(ret) || (ret != 0 && in.pos == in.size && out.pos == 0))
+            {
+              corrupt = true;
+            }
+          }
+        }
+
+        if (corrupt)
+        {
+          queue.fail();
+          break;
+        }
+        if (! (queue.push(f, std::move(block))) ) { break; }
+      }
+      ZSTD_freeDCtx(dctx);
+    };
+
+    std::vector<std::thread> pool;
+    for (int w = 0; w < workers; w++) { pool.emplace_back(worker); }
+
+    std::string block("");
+    while (queue.pop(block))
+    {
+      if (! (writeAll(spool, block)) )
+      {
+        problem = "could not write the decompressed input";
+        queue.fail();
+        break;
+      }
+    }
+    for (auto &t: pool) { t.join(); }
+
+    if (corrupt) { problem = "corrupt zstd data"; }
+#else
+    (void) src;
+    (void) srcSize;
+    problem = "zstd input needs a build with ZSTD=1";
+#endif
+  }
+
+
+  MemoryStreamBuf::MemoryStreamBuf(const char *data, std::size_t size)
+  {
+    char *start = const_cast<char *>(data);
+    setg(start, start, start + size);
+  }
+
+
+  MemoryStreamBuf::pos_type MemoryStreamBuf::seekoff(off_type off,
+      std::ios_base::seekdir dir, std::ios_base::openmode which)
+  {
+    if (! (which & std::ios_base::in) ) { return pos_type(off_type(-1)); }
+
+    off_type base = 0;
+    if (dir == std::ios_base::cur) { base = gptr() - eback(); }
+    else if (dir == std::ios_base::end) { base = egptr() - eback(); }
+
+    off_type target = base + off;
+    if (target < 0 || target > egptr() - eback())
+    {
+      return pos_type(off_type(-1));
+    }
+    setg(eback(), eback() + target, egptr());
+    return pos_type(target);
+  }
+
+
+  MemoryStreamBuf::pos_type MemoryStreamBuf::seekpos(pos_type pos, std::ios_base::openmode which)
+  {
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+  }
+
+
+  MemoryStream::MemoryStream(std::shared_ptr<const MappedInput> _input)
+    : std::istream(nullptr)
+      , input(std::move(_input))
+      , buffer(input->data(), input->size())
+  {
+    rdbuf(&buffer);
+    if (! (input->error().empty()) ) { setstate(std::ios_base::failbit); }
+  }
+};
@@ -0,0 +1,430 @@
+/* All  main documentaion is in header files
+ * for corresponding cpp files.
+ * */
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <queue>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+#include <sys/stat.h>
+#include "../hdr/join.hpp"
+
+
+/* The four header keywords, in the order the joined header is written */
+static const char *headerKeywords[HEADER_MAX] = { TITLE, CATEGORY, MAXMARK, WEIGHT };
+
+
+/* NOTE: Documentation
+ * A spooled field is a u32 length then the bytes,
+ * a spooled number a u32
+ * */
+static void spoolNumber(std::FILE *file, std::uint32_t n)
+{
+  std::fwrite(&n, sizeof(n), 1, file);
+}
+
+
+static void spoolText(std::FILE *file, const char *text, std::size_t length)
+{
+  spoolNumber(file, length);
+  std::fwrite(text, 1, length, file);
+}
+
+
+static bool readNumber(std::FILE *file, std::uint32_t &n)
+{
+  return std::fread(&n, sizeof(n), 1, file) == 1;
+}
+
+
+static bool readText(std::FILE *file, std::string &text)
+{
+  std::uint32_t length = 0;
+  if (! (readNumber(file, length)) ) { return false; }
+  text.resize(length);
+  return std::fread(&text[0], 1, length, file) == length;
+}
+
+
+/* the partition of an id, mixed so it does not follow the hash table buckets */
+static std::size_t partitionOf(const std::string_view &id, std::size_t parts)
+{
+  std::uint64_t h = std::hash<std::string_view>()(id);
+  return ((h * 0x9E3779B97F4A7C15ull) >> 32) % parts;
+}
+
+
+/* A partition record is file, row, id, marks, a run record
+ * file, row, the joined row and its notes, each note a
+ * file index times 2, plus 1 for a repeated id
+ * */
+struct RunHead
+{
+  std::uint32_t file;
+  std::uint32_t row;
+  std::string text;
+  std::vector<std::uint32_t> notes;
+};
+
+
+static bool readRunRecord(std::FILE *run, RunHead &head)
+{
+  std::uint32_t count = 0;
+  if (! (readNumber(run, head.file) && readNumber(run, head.row) && readText(run, head.text)
+        && readNumber(run, count)) )
+  {
+    return false;
+  }
+  head.notes.resize(count);
+  return std::fread(head.notes.data(), sizeof(std::uint32_t), count, run) == count;
+}
+
+
+GradebookJoin::GradebookJoin(const std::vector<std::string> &_files, std::ostream &_diagnostics)
+  : files(_files)
+    , diagnostics(_diagnostics)
+{ }
+
+
+GradebookJoin::~GradebookJoin(void)
+{
+  for (std::FILE *f: partitions) { if (f != nullptr) { std::fclose(f); } }
+  for (std::FILE *f: runs) { if (f != nullptr) { std::fclose(f); } }
+}
+
+
+bool GradebookJoin::partitionFile(std::uint32_t f, std::string header[], std::vector<FilePolicy> &policies)
+{
+  Colors c;
+  EvaluationData source(files[f]);
+  source.setEvaluationDiagnostics(diagnostics);
+  std::unique_ptr<std::istream> input = source.openInput();
+  if (! (input->good()) )
+  {
+    diagnostics << c.BRed << "*** File Not Found: " << c.Reset << c.BWhite << files[f]
+      << c.Reset << std::endl;
+    return false;
+  }
+
+  /* The header as loadEvaluationData reads it, four keyword lines
+   * with DROP / BEST lines among or directly after them
+   * */
+  std::string line("");
+  std::string fields[HEADER_MAX];
+  int lengths[HEADER_MAX] = { -1, -1, -1, -1 };
+  int keywordLines = 0;
+  bool studentLine = false;
+  while (std::getline(*input, line))
+  {
+    source.stripComments(line);
+    std::stringstream ss(line);
+    std::string keyword("");
+    std::string token("");
+    ss >> keyword;
+
+    if (keywordLines == HEADER_MAX)
+    {
+      /* blank lines may come before a policy, anything else is a student */
+      if (keyword.empty()) { continue; }
+      if (keyword != DROP && keyword != BEST)
+      {
+        studentLine = true;
+        break;
+      }
+    }
+
+    if (keyword == DROP || keyword == BEST)
+    {
+      std::string category("");
+      ss >> category;
+      policies.push_back({ f, category, line });
+      continue;
+    }
+    for (int k = 0; k < HEADER_MAX; k++)
+    {
+      if (keyword != headerKeywords[k]) { continue; }
+      fields[k].clear();
+      lengths[k] = 0;
+      while (ss >> token)
+      {
+        fields[k] += " " + token;
+        lengths[k]++;
+      }
+      keywordLines++;
+    }
+  }
+
+  const char *problem = nullptr;
+  if (keywordLines != HEADER_MAX || std::count(lengths, lengths + HEADER_MAX, -1) > 0)
+  {
+    problem = HeaderIncomplete().what();
+  }
+  else if (std::count(lengths, lengths + HEADER_MAX, lengths[0]) != HEADER_MAX)
+  {
+    problem = DataLength().what();
+  }
+  if (problem != nullptr)
+  {
+    diagnostics << c.BRed << "ERROR: " << c.Reset << c.BWhite << problem << c.Reset << std::endl;
+    diagnostics << c.BYellow << "Offending file: " << c.Reset << c.BWhite << files[f]
+      << c.Reset << std::endl;
+    return false;
+  }
+  for (int k = 0; k < HEADER_MAX; k++) { header[k] += fields[k]; }
+  /* fields follow headerKeywords, 1 is the CATEGORY line */
+  std::stringstream categoryLine(fields[1]);
+  for (std::string name; categoryLine >> name; ) { categories[f].push_back(name); }
+
+  /* every student row goes to the partition of its id */
+  std::uint32_t row = 0;
+  while (studentLine || std::getline(*input, line))
+  {
+    if (! (studentLine) ) { source.stripComments(line); }
+    studentLine = false;
+
+    const char *space = " \t\r\v\f\n";
+    std::size_t idStart = line.find_first_not_of(space);
+    if (idStart == std::string::npos) { continue; }
+    std::size_t idEnd = std::min(line.find_first_of(space, idStart), line.size());
+    std::size_t marksStart = std::min(line.find_first_not_of(space, idEnd), line.size());
+    std::size_t marksEnd = line.find_last_not_of(space) + 1;
+    if (marksStart > marksEnd) { marksStart = marksEnd; }
+
+    std::string_view id(line.data() + idStart, idEnd - idStart);
+    std::FILE *part = partitions[partitionOf(id, partitions.size())];
+    spoolNumber(part, f);
+    spoolNumber(part, row++);
+    spoolText(part, id.data(), id.size());
+    spoolText(part, line.data() + marksStart, marksEnd - marksStart);
+  }
+  return true;
+}
+
+
+bool GradebookJoin::checkPolicies(const std::vector<FilePolicy> &policies)
+{
+  Colors c;
+  auto has = [&](std::uint32_t f, const std::string &category)
+  {
+    return std::find(categories[f].begin(), categories[f].end(), category) != categories[f].end();
+  };
+
+  for (const auto &p: policies)
+  {
+    std::uint32_t other = 0;
+    while (other < files.size() && (other == p.file || ! (has(other, p.category))) ) { other++; }
+    bool crosses = other < files.size();
+    if (! (crosses) && has(p.file, p.category)) { continue; }
+
+    const char *problem = crosses ? PolicyCrossesFiles().what() : PolicyCategoryNotFound().what();
+    std::size_t start = std::min(p.line.find_first_not_of(" \t"), p.line.size());
+    diagnostics << c.BRed << "ERROR: " << c.Reset << c.BWhite << problem << c.Reset << std::endl;
+    diagnostics << c.BYellow << "Offending file: " << c.Reset << c.BWhite << files[p.file]
+      << c.Reset << std::endl;
+    diagnostics << c.BYellow << "Offending content: " << c.Reset << c.BWhite
+      << p.line.substr(start, p.line.find_last_not_of(" \t\r") + 1 - start) << c.Reset << std::endl;
+    if (crosses)
+    {
+      diagnostics << c.BYellow << "Also has " << p.category << ": " << c.Reset << c.BWhite
+        << files[other] << c.Reset << std::endl;
+    }
+    return false;
+  }
+  return true;
+}
+
+
+bool GradebookJoin::joinPartition(std::size_t p)
+{
+  std::FILE *part = partitions[p];
+  if (std::fflush(part) != 0) { return false; }
+  std::string buffer(std::ftell(part), '\0');
+  std::rewind(part);
+  if (std::fread(&buffer[0], 1, buffer.size(), part) != buffer.size()) { return false; }
+  std::fclose(part);
+  partitions[p] = nullptr;
+
+  /* Records are in file then row order, so the entries are
+   * created in the order their ids first appear
+   * */
+  struct Entry
+  {
+    std::uint32_t file;
+    std::uint32_t row;
+    std::string_view id;
+  };
+  const std::size_t numFiles = files.size();
+  std::vector<Entry> entries;
+  std::vector<std::string_view> marks;
+  std::unordered_map<std::uint32_t, std::vector<std::uint32_t>> repeats;
+  std::unordered_map<std::string_view, std::uint32_t> index;
+  index.reserve(buffer.size() / 32);
+
+  std::size_t at = 0;
+  auto take = [&](std::uint32_t &n) { std::memcpy(&n, buffer.data() + at, sizeof(n)); at += sizeof(n); };
+  while (at < buffer.size())
+  {
+    std::uint32_t file, row, length;
+    take(file);
+    take(row);
+    take(length);
+    std::string_view id(buffer.data() + at, length);
+    at += length;
+    take(length);
+    std::string_view rowMarks(buffer.data() + at, length);
+    at += length;
+
+    auto found = index.emplace(id, entries.size());
+    if (found.second)
+    {
+      entries.push_back({ file, row, id });
+      marks.resize(marks.size() + numFiles);
+    }
+    std::size_t e = found.first->second;
+    std::string_view &slot = marks[e * numFiles + file];
+    if (slot.data() != nullptr)
+    {
+      /* only the first row of a repeated id is joined */
+      repeats[e].push_back(file * 2 + 1);
+      continue;
+    }
+    slot = rowMarks;
+  }
+
+  std::FILE *run = std::tmpfile();
+  if (run == nullptr) { return false; }
+  runs.push_back(run);
+
+  std::string text("");
+  std::vector<std::uint32_t> notes;
+  for (std::size_t e = 0; e < entries.size(); e++)
+  {
+    text.assign(entries[e].id);
+    notes.clear();
+    auto repeat = repeats.find(e);
+    if (repeat != repeats.end()) { notes = repeat->second; }
+    for (std::size_t f = 0; f < numFiles; f++)
+    {
+      const std::string_view &m = marks[e * numFiles + f];
+      if (m.data() == nullptr) { notes.push_back(f * 2); }
+      if (! (m.empty()) )
+      {
+        text += ' ';
+        text.append(m);
+      }
+    }
+    spoolNumber(run, entries[e].file);
+    spoolNumber(run, entries[e].row);
+    spoolText(run, text.data(), text.size());
+    spoolNumber(run, notes.size());
+    std::fwrite(notes.data(), sizeof(std::uint32_t), notes.size(), run);
+  }
+  return std::fflush(run) == 0;
+}
+
+
+bool GradebookJoin::mergeRuns(std::FILE *out)
+{
+  Colors c;
+  std::vector<RunHead> heads(runs.size());
+  auto later = [&](std::size_t a, std::size_t b)
+  {
+    return heads[a].file != heads[b].file ? heads[a].file > heads[b].file : heads[a].row > heads[b].row;
+  };
+  std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(later)> order(later);
+  for (std::size_t r = 0; r < runs.size(); r++)
+  {
+    std::rewind(runs[r]);
+    if (readRunRecord(runs[r], heads[r])) { order.push(r); }
+  }
+
+  long incomplete = 0;
+  while (! (order.empty()) )
+  {
+    std::size_t r = order.top();
+    order.pop();
+    RunHead &head = heads[r];
+    head.text += '\n';
+    if (std::fwrite(head.text.data(), 1, head.text.size(), out) != head.text.size()) { return false; }
+
+    std::string id = head.text.substr(0, head.text.find_first_of(" \n"));
+    bool missing = false;
+    for (std::uint32_t note: head.notes)
+    {
+      const char *what = note % 2 ? "Repeated in, first row kept: " : "Missing from ";
+      diagnostics << c.BYellow << what << files[note / 2] << ": " << c.Reset
+        << c.BWhite << id << c.Reset << std::endl;
+      missing = missing || note % 2 == 0;
+    }
+    if (missing) { incomplete++; }
+
+    if (readRunRecord(runs[r], head)) { order.push(r); }
+  }
+
+  if (incomplete > 0)
+  {
+    diagnostics << c.BYellow << "Students not in every joined file: " << c.Reset
+      << c.BWhite << incomplete << c.Reset << std::endl;
+  }
+  return true;
+}
+
+
+std::shared_ptr<const MappedInput> GradebookJoin::join(void)
+{
+  Colors c;
+
+  /* partitions sized from the input, compressed files count as they are */
+  std::size_t totalBytes = 0;
+  for (const auto &file: files)
+  {
+    struct stat st;
+    if (stat(file.c_str(), &st) == 0) { totalBytes += st.st_size; }
+  }
+  std::size_t parts = std::min<std::size_t>(JOIN_MAX_PARTITIONS, totalBytes / JOIN_PARTITION_BYTES + 1);
+  for (std::size_t p = 0; p < parts; p++)
+  {
+    partitions.push_back(std::tmpfile());
+    if (partitions.back() == nullptr)
+    {
+      diagnostics << c.BRed << "*** could not open a join spool ***" << c.Reset << std::endl;
+      return nullptr;
+    }
+  }
+
+  std::string header[HEADER_MAX];
+  std::vector<FilePolicy> policies;
+  categories.assign(files.size(), std::vector<std::string>());
+  for (std::uint32_t f = 0; f < files.size(); f++)
+  {
+    if (! (partitionFile(f, header, policies)) ) { return nullptr; }
+  }
+  if (! (checkPolicies(policies)) ) { return nullptr; }
+
+  std::FILE *out = std::tmpfile();
+  bool written = out != nullptr;
+  for (std::size_t p = 0; written && p < parts; p++) { written = joinPartition(p); }
+  if (written)
+  {
+    std::string head("");
+    for (int k = 0; k < HEADER_MAX; k++) { head += headerKeywords[k] + header[k] + "\n"; }
+    for (const auto &p: policies) { head += p.line + "\n"; }
+    written = std::fwrite(head.data(), 1, head.size(), out) == head.size() && mergeRuns(out);
+  }
+  if (! (written) )
+  {
+    if (out != nullptr) { std::fclose(out); }
+    diagnostics << c.BRed << "*** could not write the joined gradebook ***" << c.Reset << std::endl;
+    return nullptr;
+  }
+
+  auto joined = std::make_shared<const MappedInput>(out);
+  if (! (joined->error().empty()) )
+  {
+    diagnostics << c.BRed << "*** " << joined->error() << " ***" << c.Reset << std::endl;
+    return nullptr;
+  }
+  return joined;
+}
@@ -0,0 +1,227 @@
+/* All  main documentaion is in header files
+ * for corresponding cpp files.
+ * */
+#include <sstream>
+#include <unordered_map>
+#include "../hdr/grader.hpp"
+#include "../hdr/libgrader.h"
+
+
+/* NOTE: Documentation
+ * Everything one gradebook owns. Warnings and header
+ * errors are written to diagnostics instead of std::cerr,
+ * and index maps every student id to the row searchStudent
+ * would pick
+ * */
+struct grader_book
+{
+  EvaluationData eval;
+  std::unique_ptr<Container> container;
+  std::ostringstream diagnostics;
+  std::string error;
+  std::unordered_map<std::string, std::size_t> index;
+  bool graded;
+
+  explicit grader_book(const std::string &name)
+    : eval(name)
+      , graded(false)
+  { }
+
+  grader_book(const std::string &name, std::shared_ptr<const MappedInput> input)
+    : eval(name, input)
+      , graded(false)
+  { }
+};
+
+
+/* NOTE: Documentation
+ * Header, then students, the way main loads them, with
+ * each step's LoadStatus turned into a grader_status
+ * */
+static grader_status loadBook(grader_book *book, unsigned options)
+{
+  EvaluationData &e = book->eval;
+  e.setEvaluationDiagnostics(book->diagnostics);
+  e.setEvaluationFixedPoint((options & GRADER_FIXED_POINT) != 0);
+
+  LoadStatus status = e.loadEvaluationData();
+  if (status != LOAD_OK)
+  {
+    book->error = e.evaluationError();
+    return status == LOAD_NOT_FOUND ? GRADER_NOT_FOUND : GRADER_BAD_HEADER;
+  }
+
+  book->container.reset(new Container(countStudentLines(e)));
+  Container &c = *book->container;
+  if (loadStudentContainers(e, c) != LOAD_OK)
+  {
+    book->container.reset();
+    book->error = "could not read " + e.evaluationFile();
+    return GRADER_NOT_FOUND;
+  }
+
+  /* Same precedence as searchStudent, the last match in the first
+   * section that has one, so the sections go in last to first and
+   * a later row overwrites an earlier one
+   * */
+  const StudentVector *sections[3] = { &c.student, &c.wdr, &c.error };
+  std::size_t first[3] = { 0, c.student.size(), c.student.size() + c.wdr.size() };
+  for (int s = 2; s >= 0; s--)
+  {
+    for (std::size_t i = 0; i < sections[s]->size(); i++)
+    {
+      book->index[(*sections[s])[i].studentName()] = first[s] + i;
+    }
+  }
+  return GRADER_OK;
+}
+
+
+/* NOTE: Documentation
+ * Row i of the report, graded then withdrawn then errors
+ * */
+static void fillResult(const grader_book *book, std::size_t i, grader_result *result)
+{
+  const Container &c = *book->container;
+  const StudentData *stu = nullptr;
+  if (i < c.student.size())
+  {
+    stu = &c.student[i];
+    result->section = GRADER_GRADED;
+  }
+  else if (i < c.student.size() + c.wdr.size())
+  {
+    stu = &c.wdr[i - c.student.size()];
+    result->section = GRADER_WITHDRAWN;
+  }
+  else
+  {
+    stu = &c.error[i - c.student.size() - c.wdr.size()];
+    result->section = GRADER_ERROR;
+  }
+
+  result->id = stu->studentName().c_str();
+  result->line = stu->lineCount();
+  result->lab = stu->studentLabScore();
+  result->assign = stu->studentAssignScore();
+  result->midterm = stu->studentMidtermScore();
+  result->final_exam = stu->studentFinalScore();
+  result->total = stu->studentTotalGrade();
+  result->letter = stu->studentLetterGrade().c_str();
+  result->error = stu->studentError() ? stu->errorDefinition().c_str() : nullptr;
+}
+
+
+int grader_api_version(void) { return GRADER_API_VERSION; }
+
+
+grader_status grader_open_file(const char *path, unsigned options, grader_book **book)
+{
+  if (path == nullptr || book == nullptr) { return GRADER_BAD_ARGUMENT; }
+  *book = nullptr;
+  try
+  {
+    *book = new grader_book(path);
+    return loadBook(*book, options);
+  }
+  catch (...)
+  {
+    return GRADER_FAILED;
+  }
+}
+
+
+grader_status grader_open_buffer(const char *data, size_t size, unsigned options,
+    grader_book **book)
+{
+  if ((data == nullptr && size > 0) || book == nullptr) { return GRADER_BAD_ARGUMENT; }
+  *book = nullptr;
+  try
+  {
+    auto input = std::make_shared<const MappedInput>(data != nullptr ? data : "", size);
+    *book = new grader_book("<memory>", input);
+    if (! (input->error().empty()) )
+    {
+      (*book)->error = input->error();
+      return GRADER_NOT_FOUND;
+    }
+    return loadBook(*book, options);
+  }
+  catch (...)
+  {
+    return GRADER_FAILED;
+  }
+}
+
+
+grader_status grader_grade(grader_book *book, int threads)
+{
+  if (book == nullptr || ! (book->container) || threads < 1 || threads > MAX_THREADS)
+  {
+    return GRADER_BAD_ARGUMENT;
+  }
+
+  /* scores are added up as they are set, a book is graded once */
+  if (book->graded) { return GRADER_OK; }
+  try
+  {
+    book->eval.setEvaluationThreads(threads);
+    makeGrades(book->eval, *book->container);
+    book->graded = true;
+    return GRADER_OK;
+  }
+  catch (...)
+  {
+    return GRADER_FAILED;
+  }
+}
+
+
+size_t grader_count(const grader_book *book)
+{
+  if (book == nullptr || ! (book->container) ) { return 0; }
+  const Container &c = *book->container;
+  return c.student.size() + c.wdr.size() + c.error.size();
+}
+
+
+grader_status grader_result_at(const grader_book *book, size_t index, grader_result *result)
+{
+  if (book == nullptr || result == nullptr || index >= grader_count(book))
+  {
+    return GRADER_BAD_ARGUMENT;
+  }
+  if (! (book->graded) ) { return GRADER_NOT_GRADED; }
+  fillResult(book, index, result);
+  return GRADER_OK;
+}
+
+
+grader_status grader_find(const grader_book *book, const char *id, grader_result *result)
+{
+  if (book == nullptr || id == nullptr || result == nullptr || ! (book->container) )
+  {
+    return GRADER_BAD_ARGUMENT;
+  }
+  if (! (book->graded) ) { return GRADER_NOT_GRADED; }
+  try
+  {
+    auto found = book->index.find(id);
+    if (found == book->index.end()) { return GRADER_NO_STUDENT; }
+    fillResult(book, found->second, result);
+    return GRADER_OK;
+  }
+  catch (...)
+  {
+    return GRADER_FAILED;
+  }
+}
+
+
+const char *grader_error(const grader_book *book)
+{
+  return book != nullptr ? book->error.c_str() : "";
+}
+
+
+void grader_close(grader_book *book) { delete book; }
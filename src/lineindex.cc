@@ -0,0 +1,273 @@
+/* All  main documentaion is in header files
+ * for corresponding cpp files.
+ * */
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../hdr/input.hpp"
+#include "../hdr/lineindex.hpp"
+#include "../hdr/scanner.hpp"
+
+
+namespace GraderApplication
+{
+  static const char indexMagic[4] = { 'G', 'I', 'D', 'X' };
+
+
+  /* NOTE: Documentation
+   * A hash of our own rather than std::hash, the index
+   * outlives the build that wrote it. Eight bytes a step,
+   * finished with the murmur3 mix so every bit of the
+   * input reaches the upper half the table keeps
+   * */
+  static std::uint64_t indexHash(const char *p, std::size_t n)
+  {
+    const std::uint64_t k = 0x9e3779b97f4a7c15ULL;
+    std::uint64_t h = k ^ n;
+    for (; n >= 8; p += 8, n -= 8)
+    {
+      std::uint64_t w;
+      std::memcpy(&w, p, 8);
+      h = (h ^ (w * k)) * 0xff51afd7ed558ccdULL;
+      h ^= h >> 29;
+    }
+    std::uint64_t w = 0;
+    std::memcpy(&w, p, n);
+    h = (h ^ (w * k)) * 0xc4ceb9fe1a85ec53ULL;
+
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+
+  /* A whole file mapped read only, an empty file maps to nothing */
+  struct SourceMap
+  {
+    const char *data;
+    std::size_t size;
+    struct stat info;
+
+    explicit SourceMap(const std::string &path)
+      : data(nullptr)
+        , size(0)
+    {
+      int fd = ::open(path.c_str(), O_RDONLY);
+      if (fd < 0) { return; }
+      if (fstat(fd, &info) == 0 && info.st_size > 0)
+      {
+        void *m = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (m != MAP_FAILED)
+        {
+          data = static_cast<const char *>(m);
+          size = info.st_size;
+        }
+      }
+      ::close(fd);
+    }
+
+    ~SourceMap(void)
+    {
+      if (data != nullptr) { munmap(const_cast<char *>(data), size); }
+    }
+
+    SourceMap(const SourceMap &) = delete;
+    SourceMap& operator=(const SourceMap &) = delete;
+  };
+
+
+  static std::int64_t modifiedTime(const struct stat &info)
+  {
+    return static_cast<std::int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+  }
+
+
+  std::string indexPath(const std::string &file) { return file + INDEX_SUFFIX; }
+
+
+  LineIndex::LineIndex(void)
+    : mapped(nullptr)
+      , length(0)
+      , header(nullptr)
+      , offsets(nullptr)
+      , table(nullptr)
+      , lines(nullptr)
+  { }
+
+
+  LineIndex::~LineIndex(void) { unmap(); }
+
+
+  void LineIndex::unmap(void)
+  {
+    if (mapped != nullptr) { munmap(const_cast<char *>(mapped), length); }
+    mapped = nullptr;
+    header = nullptr;
+  }
+
+
+  IndexStatus LineIndex::open(EvaluationData &e)
+  {
+    unmap();
+    if (! (e.evaluationOnDisk()) ) { return INDEX_MISSING; }
+
+    int fd = ::open(indexPath(e.evaluationFile()).c_str(), O_RDONLY);
+    if (fd < 0) { return INDEX_MISSING; }
+    struct stat info;
+    if (fstat(fd, &info) == 0 && static_cast<std::size_t>(info.st_size) >= sizeof(Header))
+    {
+      void *m = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (m != MAP_FAILED)
+      {
+        mapped = static_cast<const char *>(m);
+        length = info.st_size;
+      }
+    }
+    ::close(fd);
+    if (mapped == nullptr) { return INDEX_STALE; }
+
+    /* the layout has to add up before anything past the header is read */
+    header = reinterpret_cast<const Header *>(mapped);
+    if (std::memcmp(header->magic, indexMagic, 4) != 0 || header->version != INDEX_VERSION
+        || length != sizeof(Header) + std::uint64_t(header->numLines) * 12 + header->tableSize * 8)
+    {
+      unmap();
+      return INDEX_STALE;
+    }
+    offsets = reinterpret_cast<const std::uint64_t *>(mapped + sizeof(Header));
+    table = offsets + header->numLines;
+    lines = reinterpret_cast<const std::uint32_t *>(table + header->tableSize);
+
+    struct stat source;
+    bool fresh = stat(e.evaluationFile().c_str(), &source) == 0
+      && static_cast<std::uint64_t>(source.st_size) == header->sourceSize
+      && header->headerEnd == static_cast<std::uint64_t>(e.currentFilePosition())
+      && header->headerLines == static_cast<std::uint32_t>(e.fileLineCount());
+
+    /* a copied or touched gradebook is only rehashed when its time moved */
+    if (fresh && modifiedTime(source) != header->sourceModified)
+    {
+      SourceMap whole(e.evaluationFile());
+      fresh = whole.size == header->sourceSize
+        && indexHash(whole.data, whole.size) == header->sourceHash;
+    }
+    if (! (fresh) )
+    {
+      unmap();
+      return INDEX_STALE;
+    }
+    return INDEX_FRESH;
+  }
+
+
+  void LineIndex::find(const std::string &id, std::vector<std::size_t> &rows) const
+  {
+    std::uint64_t h = indexHash(id.data(), id.size());
+    std::uint64_t mask = header->tableSize - 1;
+    for (std::uint64_t at = h & mask; table[at] != 0; at = (at + 1) & mask)
+    {
+      if ((table[at] >> 32) == (h >> 32)) { rows.push_back((table[at] & 0xffffffffULL) - 1); }
+    }
+
+    /* a probe that wrapped around the table comes back out of order */
+    std::sort(rows.begin(), rows.end());
+  }
+
+
+  long writeLineIndex(EvaluationData &e)
+  {
+    Colors c;
+    std::ostream &diagnostics = e.evaluationDiagnostics();
+    if (! (e.evaluationOnDisk()) )
+    {
+      diagnostics << c.BRed << "*** Only a plain gradebook can be indexed: " << c.Reset
+        << c.BWhite << e.evaluationFile() << c.Reset << std::endl;
+      return -1;
+    }
+
+    SourceMap source(e.evaluationFile());
+    if (source.data == nullptr)
+    {
+      diagnostics << "*** File Not Found: " << e.evaluationFile() << std::endl;
+      return -1;
+    }
+
+    LineIndex::Header head;
+    std::memcpy(head.magic, indexMagic, 4);
+    head.version = INDEX_VERSION;
+    head.sourceSize = source.size;
+    head.sourceModified = modifiedTime(source.info);
+    head.sourceHash = indexHash(source.data, source.size);
+    head.headerEnd = e.currentFilePosition();
+    head.headerLines = e.fileLineCount();
+
+    /* the same lines and line numbers loadStudentContainers sees */
+    std::vector<std::uint64_t> offsets;
+    std::vector<std::uint32_t> lines;
+    std::vector<std::uint64_t> hashes;
+    MemoryStreamBuf buffer(source.data, source.size);
+    std::istream in(&buffer);
+    in.seekg(e.currentFilePosition());
+    BlockReader reader(in, e.currentFilePosition());
+    std::uint32_t lineNumber = head.headerLines;
+    while (reader.next())
+    {
+      lineNumber++;
+      const ScannedLine &line = reader.line();
+      if (line.start == line.end) { continue; }
+
+      const TokenSpan *tokens = reader.lineTokens();
+      const char *id = reader.data() + (line.numTokens > 0 ? tokens[0].start : line.start);
+      std::size_t idLength = line.numTokens > 0 ? tokens[0].end - tokens[0].start : 0;
+      offsets.push_back(reader.lineOffset());
+      lines.push_back(lineNumber);
+      hashes.push_back(indexHash(id, idLength));
+    }
+    head.numLines = offsets.size();
+
+    /* at most half full, so a probe ends after a slot or two */
+    std::uint64_t tableSize = 8;
+    while (tableSize < 2 * hashes.size()) { tableSize *= 2; }
+    head.tableSize = tableSize;
+    std::vector<std::uint64_t> table(tableSize, 0);
+    for (std::size_t row = 0; row < hashes.size(); row++)
+    {
+      std::uint64_t at = hashes[row] & (tableSize - 1);
+      while (table[at] != 0) { at = (at + 1) & (tableSize - 1); }
+      table[at] = (hashes[row] & 0xffffffff00000000ULL) | (row + 1);
+    }
+
+    std::string path = indexPath(e.evaluationFile());
+    std::string partial = path + ".tmp";
+    {
+      std::ofstream out(partial, std::ios::binary | std::ios::trunc);
+      out.write(reinterpret_cast<const char *>(&head), sizeof(head));
+      out.write(reinterpret_cast<const char *>(offsets.data()), offsets.size() * 8);
+      out.write(reinterpret_cast<const char *>(table.data()), table.size() * 8);
+      out.write(reinterpret_cast<const char *>(lines.data()), lines.size() * 4);
+      if (! (out.good()) )
+      {
+        std::remove(partial.c_str());
+        diagnostics << c.BRed << "*** Could not write the index: " << c.Reset
+          << c.BWhite << path << c.Reset << std::endl;
+        return -1;
+      }
+    }
+    if (std::rename(partial.c_str(), path.c_str()) != 0)
+    {
+      std::remove(partial.c_str());
+      diagnostics << c.BRed << "*** Could not write the index: " << c.Reset
+        << c.BWhite << path << c.Reset << std::endl;
+      return -1;
+    }
+    return head.numLines;
+  }
+};
@@ -0,0 +1,190 @@
+/* All  main documentaion is in header files
+ * for corresponding cpp files.
+ * */
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "../hdr/perfcount.hpp"
+#include "../hdr/settings.hpp"
+
+
+namespace GraderApplication
+{
+  static const std::uint64_t perfConfigs[PERF_EVENTS] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+  };
+
+  static const char *perfNames[PERF_EVENTS] = { "cycles", "instructions", "cache misses", "branch misses" };
+
+
+  PerfCounters::PerfCounters(void)
+    : problem("")
+      , current(nullptr)
+  {
+    for (int i = 0; i < PERF_EVENTS; i++) { fds[i] = -1; }
+
+    for (int i = 0; i < PERF_EVENTS; i++)
+    {
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = perfConfigs[i];
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.inherit = 1;
+      attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+      /* this process and every thread it starts, on any cpu */
+      fds[i] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+      if (fds[i] < 0)
+      {
+        problem = std::string(perfNames[i]) + ": " + std::strerror(errno);
+        break;
+      }
+    }
+
+    if (! (problem.empty()) )
+    {
+      for (int i = 0; i < PERF_EVENTS; i++)
+      {
+        if (fds[i] >= 0) { close(fds[i]); }
+        fds[i] = -1;
+      }
+    }
+  }
+
+
+  PerfCounters::~PerfCounters(void)
+  {
+    for (int i = 0; i < PERF_EVENTS; i++)
+    {
+      if (fds[i] >= 0) { close(fds[i]); }
+    }
+  }
+
+
+  void PerfCounters::read(Reading *now) const
+  {
+    for (int i = 0; i < PERF_EVENTS; i++)
+    {
+      now[i] = { 0, 0, 0 };
+      if (fds[i] >= 0 && ::read(fds[i], &now[i], sizeof(Reading)) != sizeof(Reading))
+      {
+        now[i] = { 0, 0, 0 };
+      }
+    }
+  }
+
+
+  void PerfCounters::lap(const char *name)
+  {
+    stop();
+    current = name;
+    started = std::chrono::steady_clock::now();
+    read(start);
+  }
+
+
+  void PerfCounters::stop(void)
+  {
+    if (current == nullptr) { return; }
+
+    Reading end[PERF_EVENTS];
+    read(end);
+    Phase phase;
+    phase.name = current;
+    phase.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    for (int i = 0; i < PERF_EVENTS; i++)
+    {
+      /* a multiplexed counter only saw part of the phase */
+      double value = end[i].value - start[i].value;
+      double enabled = end[i].enabled - start[i].enabled;
+      double running = end[i].running - start[i].running;
+      phase.scaled[i] = running < enabled;
+      phase.counts[i] = running > 0 ? value * enabled / running : 0;
+    }
+    phases.push_back(phase);
+    current = nullptr;
+  }
+
+
+  void PerfCounters::report(long students, std::ostream &out) const
+  {
+    Colors color;
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(2);
+
+    if (! (available()) )
+    {
+      out << color.BYellow << "*** Hardware counters unavailable, timing only: " << color.Reset
+        << color.BWhite << problem << color.Reset << std::endl;
+    }
+
+    out << std::left << std::setw(12) << "Phase";
+    if (! (available()) ) { out << "ms"; }
+    else
+    {
+      out << std::left << std::setw(12) << "ms"
+        << std::left << std::setw(16) << "Cycles"
+        << std::left << std::setw(16) << "Instructions"
+        << std::left << std::setw(8) << "IPC"
+        << std::left << std::setw(16) << "Cache misses"
+        << std::left << std::setw(16) << "Branch misses"
+        << std::left << std::setw(16) << "Cache/student"
+        << "Branch/student";
+    }
+    out << std::endl;
+
+    Phase total;
+    total.name = "total";
+    total.seconds = 0;
+    for (int i = 0; i < PERF_EVENTS; i++) { total.counts[i] = 0; total.scaled[i] = false; }
+    for (const auto &p: phases)
+    {
+      total.seconds += p.seconds;
+      for (int i = 0; i < PERF_EVENTS; i++)
+      {
+        total.counts[i] += p.counts[i];
+        total.scaled[i] = total.scaled[i] || p.scaled[i];
+      }
+    }
+
+    std::vector<Phase> lines(phases);
+    lines.push_back(total);
+    for (const auto &p: lines)
+    {
+      out << std::left << std::setw(12) << p.name;
+      if (! (available()) ) { out << p.seconds * 1000; }
+      else
+      {
+        out << std::left << std::setw(12) << p.seconds * 1000;
+        for (int i = 0; i < PERF_EVENTS; i++)
+        {
+          std::string count = std::to_string(std::llround(p.counts[i])) + (p.scaled[i] ? "*" : "");
+          out << std::left << std::setw(16) << count;
+          if (i == PERF_INSTRUCTIONS)
+          {
+            double ipc = p.counts[PERF_CYCLES] > 0 ? p.counts[PERF_INSTRUCTIONS] / p.counts[PERF_CYCLES] : 0;
+            out << std::left << std::setw(8) << ipc;
+          }
+        }
+        double per = students > 0 ? 1.0 / students : 0;
+        out << std::left << std::setw(16) << p.counts[PERF_CACHE_MISSES] * per
+          << p.counts[PERF_BRANCH_MISSES] * per;
+      }
+      out << std::endl;
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+  }
+};
@@ -0,0 +1,264 @@
+/* All  main documentaion is in header files
+ * for corresponding cpp files.
+ * */
+#include <iomanip>
+#include "../hdr/pipeline.hpp"
+#include "../hdr/stream.hpp"
+#include "../hdr/trace.hpp"
+
+
+/* Whole lines of the gradebook, offset is where they start in it */
+struct RawBlock
+{
+  std::string bytes;
+  std::streamoff offset;
+};
+
+
+using BlockRing = SpscRing<std::unique_ptr<RawBlock>>;
+using BatchRing = SpscRing<std::unique_ptr<Container>>;
+
+
+/* How long a stage ran and how many batches it passed on */
+struct StageTiming
+{
+  const char *name;
+  std::chrono::steady_clock::duration total;
+  long batches;
+};
+
+
+/* NOTE: Documentation
+ * Read the gradebook from the end of its header a block at
+ * a time. A block ends at its last newline, the partial
+ * line starts the next one, and a line longer than a block
+ * grows it until the line ends. A nullptr block ends the
+ * stream
+ * */
+static void readStage(std::istream &in, std::streamoff start, BlockRing &out, StageTiming &timing)
+{
+  TRACE_SCOPE("readStage");
+  auto from = std::chrono::steady_clock::now();
+  std::string carry;
+  std::streamoff offset = start;
+  bool more = true;
+  while (more)
+  {
+    std::unique_ptr<RawBlock> block(new RawBlock{ std::move(carry), offset });
+    carry.clear();
+    std::size_t have = block->bytes.size();
+    block->bytes.resize(have + PIPELINE_BLOCK);
+    in.read(&block->bytes[have], PIPELINE_BLOCK);
+    std::size_t got = in.gcount();
+    block->bytes.resize(have + got);
+
+    /* the last block keeps a last line without a newline */
+    more = got == PIPELINE_BLOCK;
+    if (more)
+    {
+      std::size_t end = block->bytes.rfind(static_cast<char>(NL));
+      if (end == std::string::npos)
+      {
+        carry = std::move(block->bytes);
+        continue;
+      }
+      carry.assign(block->bytes, end + 1, std::string::npos);
+      block->bytes.resize(end + 1);
+    }
+
+    offset += block->bytes.size();
+    if (! (block->bytes.empty()) )
+    {
+      out.push(std::move(block));
+      timing.batches++;
+    }
+  }
+  out.push(nullptr);
+  timing.total = std::chrono::steady_clock::now() - from;
+}
+
+
+/* NOTE: Documentation
+ * Scan each block and load its students, exactly as
+ * loadStudentContainers does, into Containers of up to
+ * PIPELINE_RECORDS rows. The line count and the duplicate
+ * filter are only ever touched from this thread
+ * */
+static void parseStage(EvaluationData &e, DuplicateFilter &seen, BlockRing &in, BatchRing &out,
+    StageTiming &timing)
+{
+  TRACE_SCOPE("parseStage");
+  auto from = std::chrono::steady_clock::now();
+  std::unique_ptr<Container> batch(new Container(PIPELINE_RECORDS));
+  long rows = 0;
+  for (std::unique_ptr<RawBlock> block = in.pop(); block; block = in.pop())
+  {
+    MemoryStreamBuf buffer(block->bytes.data(), block->bytes.size());
+    std::istream lines(&buffer);
+    BlockReader reader(lines, block->offset);
+    while (reader.next())
+    {
+      e.setFileLineCount(1);
+      if (reader.line().start == reader.line().end) { continue; }
+
+      StudentData stu;
+      if (! (stu.loadStudent(reader, e, seen)) ) { continue; }
+      if (stu.studentError())
+      {
+        batch->error.emplace_back(std::move(stu));
+      }
+      else if (stu.studentWDR())
+      {
+        stu.setStudentLetter(LETTER_WITHDRAWN);
+        batch->wdr.emplace_back(std::move(stu));
+      }
+      else
+      {
+        batch->student.emplace_back(std::move(stu));
+      }
+
+      if (++rows == PIPELINE_RECORDS)
+      {
+        out.push(std::move(batch));
+        timing.batches++;
+        batch.reset(new Container(PIPELINE_RECORDS));
+        rows = 0;
+      }
+    }
+  }
+  if (rows > 0)
+  {
+    out.push(std::move(batch));
+    timing.batches++;
+  }
+  out.push(nullptr);
+  timing.total = std::chrono::steady_clock::now() - from;
+}
+
+
+static void gradeStage(EvaluationData &e, BatchRing &in, BatchRing &out, StageTiming &timing)
+{
+  TRACE_SCOPE("gradeStage");
+  auto from = std::chrono::steady_clock::now();
+  for (std::unique_ptr<Container> batch = in.pop(); batch; batch = in.pop())
+  {
+    makeGrades(e, *batch, nullptr);
+    out.push(std::move(batch));
+    timing.batches++;
+  }
+  out.push(nullptr);
+  timing.total = std::chrono::steady_clock::now() - from;
+}
+
+
+/* graded rows go out at once, the rest after every graded row */
+static void writeStage(OutputWriter &writer, RowSpool &wdr, RowSpool &error, BatchRing &in,
+    StageTiming &timing)
+{
+  TRACE_SCOPE("writeStage");
+  auto from = std::chrono::steady_clock::now();
+  writer.begin();
+  for (std::unique_ptr<Container> batch = in.pop(); batch; batch = in.pop())
+  {
+    /* Use a precision stream to round grades to hundreths place */
+    if (! (batch->student.empty()) ) { std::cout << std::fixed << std::setprecision(2); }
+    for (const auto &stu: batch->student) { writer.writeStudent(stu); }
+    for (const auto &stu: batch->wdr) { wdr.spool(stu); }
+    for (const auto &stu: batch->error) { error.spool(stu); }
+    timing.batches++;
+  }
+  wdr.replay(writer, WDR_SECTION);
+  error.replay(writer, ERROR_SECTION);
+  writer.finish();
+  timing.total = std::chrono::steady_clock::now() - from;
+}
+
+
+static double milliseconds(std::chrono::steady_clock::duration d)
+{
+  return std::chrono::duration<double, std::milli>(d).count();
+}
+
+
+bool pipelineGrades(EvaluationData &e, OutputWriter &writer, std::ostream &diagnostics)
+{
+  std::unique_ptr<std::istream> input = e.openInput();
+  std::istream &inFile = *input;
+  if (! (inFile.good()) )
+  {
+    e.evaluationDiagnostics() << "*** File Not Found: " << e.evaluationFile() << std::endl;
+    return false;
+  }
+  inFile.seekg(e.currentFilePosition());
+
+  RowSpool wdr;
+  RowSpool error;
+  if (! (wdr.good() && error.good()) )
+  {
+    e.evaluationDiagnostics() << "Could not create a spool file" << std::endl;
+    return false;
+  }
+
+  DuplicateFilter seen(e.openInput(), countStudentLines(e));
+  BlockRing blocks(PIPELINE_DEPTH);
+  BatchRing parsed(PIPELINE_DEPTH);
+  BatchRing graded(PIPELINE_DEPTH);
+  StageTiming timing[4] = { { "read", { }, 0 }, { "parse", { }, 0 }, { "grade", { }, 0 },
+    { "write", { }, 0 } };
+
+  std::thread reader(readStage, std::ref(inFile), static_cast<std::streamoff>(e.currentFilePosition()),
+      std::ref(blocks), std::ref(timing[0]));
+  std::thread parser(parseStage, std::ref(e), std::ref(seen), std::ref(blocks), std::ref(parsed),
+      std::ref(timing[1]));
+  std::thread grader(gradeStage, std::ref(e), std::ref(parsed), std::ref(graded), std::ref(timing[2]));
+  writeStage(writer, wdr, error, graded, timing[3]);
+  reader.join();
+  parser.join();
+  grader.join();
+  std::cout.flush();
+
+  /* a stage is starved waiting on the queue before it, blocked on the one after */
+  std::chrono::steady_clock::duration starved[4] = { { }, blocks.starvedTime(), parsed.starvedTime(),
+    graded.starvedTime() };
+  std::chrono::steady_clock::duration blocked[4] = { blocks.blockedTime(), parsed.blockedTime(),
+    graded.blockedTime(), { } };
+
+  std::ios_base::fmtflags flags = diagnostics.flags();
+  std::streamsize precision = diagnostics.precision();
+  diagnostics << std::fixed << std::setprecision(2);
+  diagnostics << std::left << std::setw(10) << "Stage"
+    << std::left << std::setw(10) << "Batches"
+    << std::left << std::setw(12) << "Busy ms"
+    << std::left << std::setw(12) << "Starved ms"
+    << "Blocked ms" << std::endl;
+  for (int s = 0; s < 4; s++)
+  {
+    diagnostics << std::left << std::setw(10) << timing[s].name
+      << std::left << std::setw(10) << timing[s].batches
+      << std::left << std::setw(12) << milliseconds(timing[s].total - starved[s] - blocked[s])
+      << std::left << std::setw(12) << milliseconds(starved[s])
+      << milliseconds(blocked[s]) << std::endl;
+  }
+
+  const char *names[3] = { "read>parse", "parse>grade", "grade>write" };
+  std::uint64_t pushes[3] = { blocks.pushes(), parsed.pushes(), graded.pushes() };
+  std::uint64_t full[3] = { blocks.fullWaits(), parsed.fullWaits(), graded.fullWaits() };
+  std::uint64_t empty[3] = { blocks.emptyWaits(), parsed.emptyWaits(), graded.emptyWaits() };
+  double fill[3] = { blocks.meanFill(), parsed.meanFill(), graded.meanFill() };
+  diagnostics << std::left << std::setw(14) << "Queue"
+    << std::left << std::setw(8) << "Depth"
+    << std::left << std::setw(12) << "Mean fill"
+    << std::left << std::setw(12) << "Full waits"
+    << "Empty waits" << std::endl;
+  for (int q = 0; q < 3; q++)
+  {
+    diagnostics << std::left << std::setw(14) << names[q]
+      << std::left << std::setw(8) << PIPELINE_DEPTH
+      << std::left << std::setw(12) << fill[q]
+      << std::left << std::setw(12) << (std::to_string(full[q]) + "/" + std::to_string(pushes[q]))
+      << empty[q] << "/" << pushes[q] << std::endl;
+  }
+  diagnostics.flags(flags);
+  diagnostics.precision(precision);
+  return true;
+}
@@ -0,0 +1,172 @@
+/* All  main documentaion is in header files
+ * for corresponding cpp files.
+ * */
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include "../hdr/policy.hpp"
+
+
+/* Students ranked together in the single drop kernel */
+#define POLICY_BLOCK 64
+
+
+/* how many of cols the student is exempt from */
+static int exemptCount(const StudentData &stu, const std::vector<int> &cols)
+{
+  if (stu.studentExemptBits() == nullptr) { return 0; }
+  int count = 0;
+  for (int col: cols) { count += stu.studentExempt(col); }
+  return count;
+}
+
+
+void selectKeptMarks(EvaluationData &e, Container &c)
+{
+  const float never = std::numeric_limits<float>::infinity();
+
+  int n = c.student.size();
+  int m = e.evaluationDataLength();
+  c.markMask.assign(static_cast<std::size_t>(n) * m, 1);
+
+  for (int p = 0; p < e.evaluationPolicyCount(); p++)
+  {
+    int drop = e.evaluationPolicyDrop(p);
+    if (drop == 0) { continue; }
+
+    /* columns that belong to this category */
+    std::vector<int> cols;
+    std::vector<float> maxMarks;
+    for (int j = 0; j < m; j++)
+    {
+      if (e.evaluationColumnPolicy(j) == p)
+      {
+        cols.emplace_back(j);
+        maxMarks.emplace_back(e.evaluationMaxMarkContainer(j));
+      }
+    }
+    int items = cols.size();
+
+    if (drop == 1)
+    {
+      float low[POLICY_BLOCK];
+      int lowItem[POLICY_BLOCK];
+      float ratio[POLICY_BLOCK];
+
+      for (int i0 = 0; i0 < n; i0 += POLICY_BLOCK)
+      {
+        int bl = std::min(POLICY_BLOCK, n - i0);
+        for (int b = 0; b < bl; b++)
+        {
+          const StudentData &stu = c.student[i0 + b];
+          float r = stu.studentGradesContainer(cols[0]) / maxMarks[0];
+          low[b] = stu.studentExempt(cols[0]) ? never : r;
+          lowItem[b] = 0;
+        }
+
+        for (int t = 1; t < items; t++)
+        {
+          for (int b = 0; b < bl; b++)
+          {
+            const StudentData &stu = c.student[i0 + b];
+            float r = stu.studentGradesContainer(cols[t]) / maxMarks[t];
+            ratio[b] = stu.studentExempt(cols[t]) ? never : r;
+          }
+          /* branch free running minimum, first lowest mark wins a tie */
+          for (int b = 0; b < bl; b++)
+          {
+            bool lower = ratio[b] < low[b];
+            low[b] = lower ? ratio[b] : low[b];
+            lowItem[b] = lower ? t : lowItem[b];
+          }
+        }
+
+        for (int b = 0; b < bl; b++)
+        {
+          /* the last mark left after exemptions is kept */
+          if (items - exemptCount(c.student[i0 + b], cols) <= 1) { continue; }
+          c.markMask[static_cast<std::size_t>(i0 + b) * m + cols[lowItem[b]]] = 0;
+        }
+      }
+    }
+    else
+    {
+      std::vector<float> ratio(items);
+      std::vector<int> order(items);
+      for (int i = 0; i < n; i++)
+      {
+        const StudentData &stu = c.student[i];
+        int dropped = std::min(drop, items - exemptCount(stu, cols) - 1);
+        if (dropped <= 0) { continue; }
+
+        for (int t = 0; t < items; t++)
+        {
+          float r = stu.studentGradesContainer(cols[t]) / maxMarks[t];
+          ratio[t] = stu.studentExempt(cols[t]) ? never : r;
+        }
+        std::iota(order.begin(), order.end(), 0);
+
+        /* only the lowest drop marks need to be found, not ordered */
+        std::nth_element(order.begin(), order.begin() + (dropped - 1), order.end(),
+            [&ratio](int a, int b)
+            { return ratio[a] < ratio[b] || (ratio[a] == ratio[b] && a < b); });
+
+        for (int t = 0; t < dropped; t++)
+        {
+          c.markMask[static_cast<std::size_t>(i) * m + cols[order[t]]] = 0;
+        }
+      }
+    }
+  }
+}
+
+
+void policyColumnScale(EvaluationData &e, const unsigned char *mask,
+    const std::uint64_t *exempt, const float *weights, float *scale)
+{
+  int m = e.evaluationDataLength();
+  int numCategories = e.evaluationCategoryCount();
+
+  std::vector<float> categoryWeight(numCategories, 0.0);
+  std::vector<float> keptWeight(numCategories, 0.0);
+  std::vector<int> keptCount(numCategories, 0);
+  for (int j = 0; j < m; j++)
+  {
+    /* 1 for a kept mark, 0 for a dropped or exempt one, no branches */
+    std::uint32_t keep = mask != nullptr ? mask[j] : 1;
+    if (exempt != nullptr) { keep &= ~static_cast<std::uint32_t>(exempt[j >> 6] >> (j & 63)); }
+    keep &= 1;
+    scale[j] = keep;
+
+    int g = e.evaluationColumnCategory(j);
+    categoryWeight[g] += weights[j];
+    keptWeight[g] += scale[j] * weights[j];
+    keptCount[g] += keep;
+  }
+
+  /* a category with nothing left hands its weight to the rest */
+  float totalWeight = 0.0;
+  float lostWeight = 0.0;
+  for (int g = 0; g < numCategories; g++)
+  {
+    totalWeight += categoryWeight[g];
+    lostWeight += keptCount[g] == 0 ? categoryWeight[g] : 0;
+  }
+  bool spread = lostWeight > 0 && totalWeight > lostWeight;
+
+  /* keptWeight becomes the factor for the kept marks, one rounding each */
+  for (int g = 0; g < numCategories; g++)
+  {
+    if (keptWeight[g] <= 0) { keptWeight[g] = 0; }
+    else if (! (spread) ) { keptWeight[g] = categoryWeight[g] / keptWeight[g]; }
+    else
+    {
+      keptWeight[g] = (static_cast<double>(categoryWeight[g]) * totalWeight)
+        / (static_cast<double>(keptWeight[g]) * (totalWeight - lostWeight));
+    }
+  }
+  for (int j = 0; j < m; j++)
+  {
+    scale[j] *= keptWeight[e.evaluationColumnCategory(j)];
+  }
+}
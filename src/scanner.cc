@@ -0,0 +1,338 @@
+/* All  main documentaion is in header files
+ * for corresponding cpp files.
+ * */
+#include <cstdlib>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+#include "../hdr/scanner.hpp"
+#include "../hdr/settings.hpp"
+
+
+namespace GraderApplication
+{
+  /* NOTE: Documentation
+   * Bit masks of one chunk, bit i is byte i
+   * */
+  struct ChunkMasks
+  {
+    std::uint64_t newline;
+    std::uint64_t comment;
+    std::uint64_t space;
+  };
+
+
+  static void classifyScalar(const unsigned char *p, ChunkMasks &m)
+  {
+    m.newline = m.comment = m.space = 0;
+    for (int i = 0; i < SCAN_CHUNK; i++)
+    {
+      std::uint64_t bit = 1ULL << i;
+      unsigned char c = p[i];
+      if (c == NL) { m.newline |= bit; }
+      else if (c == COMM) { m.comment |= bit; }
+      else if (c == WS || c == TAB || c == CR || c == VT || c == FF) { m.space |= bit; }
+    }
+  }
+
+
+#if defined(__x86_64__)
+  /* SSE2 is part of x86-64, no check needed */
+  static void classifySse2(const unsigned char *p, ChunkMasks &m)
+  {
+    const __m128i nl = _mm_set1_epi8(NL);
+    const __m128i hash = _mm_set1_epi8(COMM);
+    const __m128i ws = _mm_set1_epi8(WS);
+    /* TAB VT FF CR are the run 0x09, 0x0b .. 0x0d, test them as a range */
+    const __m128i tab = _mm_set1_epi8(TAB);
+    const __m128i vt = _mm_set1_epi8(VT);
+    const __m128i span = _mm_set1_epi8(CR - VT);
+
+    m.newline = m.comment = m.space = 0;
+    for (int i = 0; i < SCAN_CHUNK; i += 16)
+    {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+      __m128i fromVt = _mm_sub_epi8(v, vt);
+      __m128i inRange = _mm_cmpeq_epi8(_mm_min_epu8(fromVt, span), fromVt);
+      __m128i space = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, ws), _mm_cmpeq_epi8(v, tab)), inRange);
+
+      m.newline |= static_cast<std::uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, nl)) & 0xffff) << i;
+      m.comment |= static_cast<std::uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, hash)) & 0xffff) << i;
+      m.space |= static_cast<std::uint64_t>(_mm_movemask_epi8(space) & 0xffff) << i;
+    }
+  }
+
+
+  __attribute__((target("avx2")))
+  static void classifyAvx2(const unsigned char *p, ChunkMasks &m)
+  {
+    const __m256i nl = _mm256_set1_epi8(NL);
+    const __m256i hash = _mm256_set1_epi8(COMM);
+    const __m256i ws = _mm256_set1_epi8(WS);
+    const __m256i tab = _mm256_set1_epi8(TAB);
+    const __m256i vt = _mm256_set1_epi8(VT);
+    const __m256i span = _mm256_set1_epi8(CR - VT);
+
+    m.newline = m.comment = m.space = 0;
+    for (int i = 0; i < SCAN_CHUNK; i += 32)
+    {
+      __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+      __m256i fromVt = _mm256_sub_epi8(v, vt);
+      __m256i inRange = _mm256_cmpeq_epi8(_mm256_min_epu8(fromVt, span), fromVt);
+      __m256i space = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, ws),
+            _mm256_cmpeq_epi8(v, tab)), inRange);
+
+      m.newline |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, nl)))) << i;
+      m.comment |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, hash)))) << i;
+      m.space |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(
+            _mm256_movemask_epi8(space))) << i;
+    }
+  }
+#endif
+
+
+  ScanBackend scanBackend(void)
+  {
+    static const ScanBackend chosen = []
+    {
+      ScanBackend best = SCAN_SCALAR;
+#if defined(__x86_64__)
+      best = __builtin_cpu_supports("avx2") ? SCAN_AVX2 : SCAN_SSE2;
+#endif
+      const char *forced = std::getenv("GRADER_SCAN");
+      if (forced == nullptr) { return best; }
+      if (std::strcmp(forced, "scalar") == 0) { return SCAN_SCALAR; }
+      if (std::strcmp(forced, "sse2") == 0 && best != SCAN_SCALAR) { return SCAN_SSE2; }
+      return best;
+    }();
+    return chosen;
+  }
+
+
+  const char *scanBackendName(ScanBackend backend)
+  {
+    static const char *names[] = { "scalar", "sse2", "avx2" };
+    return names[backend];
+  }
+
+
+  /* bits [from, to) set */
+  static std::uint64_t rangeMask(int from, int to)
+  {
+    std::uint64_t upTo = to >= 64 ? ~0ULL : (1ULL << to) - 1;
+    return upTo & ~((1ULL << from) - 1);
+  }
+
+
+  LineScanner::LineScanner(void)
+    : backend(scanBackend())
+  { }
+
+
+  LineScanner::LineScanner(ScanBackend _backend)
+    : backend(_backend)
+  { }
+
+
+  void LineScanner::scan(const char *data, std::size_t length)
+  {
+    lines.clear();
+    tokens.clear();
+
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+    unsigned char tail[SCAN_CHUNK];
+
+    /* carried from one chunk to the next */
+    bool inComment = false;
+    bool prevDelim = true;
+    std::uint32_t tokenStart = 0;
+    ScannedLine line = { 0, 0, 0, 0, 0 };
+    bool lineHasComment = false;
+
+    for (std::size_t base = 0; base < length; base += SCAN_CHUNK)
+    {
+      std::size_t valid = length - base;
+      const unsigned char *chunk = bytes + base;
+      if (valid < SCAN_CHUNK)
+      {
+        /* pad the last chunk with white space, masked off below */
+        std::memset(tail, WS, sizeof(tail));
+        std::memcpy(tail, chunk, valid);
+        chunk = tail;
+      }
+
+      ChunkMasks m;
+#if defined(__x86_64__)
+      if (backend == SCAN_AVX2) { classifyAvx2(chunk, m); }
+      else if (backend == SCAN_SSE2) { classifySse2(chunk, m); }
+      else { classifyScalar(chunk, m); }
+#else
+      classifyScalar(chunk, m);
+#endif
+
+      /* everything from a line's first COMM up to its newline is comment */
+      std::uint64_t commentRun = 0;
+      std::uint64_t commentStart = 0;
+      if (inComment || m.comment != 0)
+      {
+        int from = inComment ? 0 : -1;
+        std::uint64_t events = m.newline | m.comment;
+        while (events != 0)
+        {
+          int b = __builtin_ctzll(events);
+          std::uint64_t bit = 1ULL << b;
+          if (from >= 0)
+          {
+            if (m.newline & bit) { commentRun |= rangeMask(from, b); from = -1; }
+          }
+          else if (m.comment & bit)
+          {
+            from = b;
+            commentStart |= bit;
+          }
+          events &= events - 1;
+        }
+        inComment = from >= 0;
+        if (inComment) { commentRun |= rangeMask(from, 64); }
+      }
+
+      std::uint64_t delim = m.space | m.newline | commentRun;
+      std::uint64_t before = (delim << 1) | (prevDelim ? 1 : 0);
+      std::uint64_t starts = ~delim & before;
+      std::uint64_t ends = delim & ~before;
+      prevDelim = (delim >> 63) != 0;
+
+      if (valid < SCAN_CHUNK)
+      {
+        std::uint64_t keep = rangeMask(0, valid);
+        prevDelim = ((delim >> (valid - 1)) & 1) != 0;
+        starts &= keep;
+        ends &= keep;
+        m.newline &= keep;
+        commentStart &= keep;
+      }
+
+      /* walk the boundaries in order, an end before a comment before a newline */
+      std::uint64_t events = starts | ends | commentStart | m.newline;
+      while (events != 0)
+      {
+        int b = __builtin_ctzll(events);
+        std::uint64_t bit = 1ULL << b;
+        std::uint32_t at = static_cast<std::uint32_t>(base + b);
+
+        if (starts & bit)
+        {
+          tokenStart = at;
+        }
+        if (ends & bit)
+        {
+          tokens.push_back({ tokenStart, at });
+        }
+        if ((commentStart & bit) && ! (lineHasComment) )
+        {
+          line.comment = at;
+          lineHasComment = true;
+        }
+        if (m.newline & bit)
+        {
+          line.end = at;
+          if (! (lineHasComment) ) { line.comment = at; }
+          line.numTokens = tokens.size() - line.firstToken;
+          lines.push_back(line);
+
+          line = { at + 1, 0, 0, static_cast<std::uint32_t>(tokens.size()), 0 };
+          lineHasComment = false;
+        }
+        events &= events - 1;
+      }
+    }
+
+    /* a last line with no newline, as getline returns it */
+    std::uint32_t end = static_cast<std::uint32_t>(length);
+    if (! (prevDelim) && length > 0 && ! (inComment) )
+    {
+      tokens.push_back({ tokenStart, end });
+    }
+    if (line.start < end)
+    {
+      line.end = end;
+      if (! (lineHasComment) ) { line.comment = end; }
+      line.numTokens = tokens.size() - line.firstToken;
+      lines.push_back(line);
+    }
+  }
+
+
+  BlockReader::BlockReader(std::istream &_in, std::streamoff offset)
+    : in(_in)
+      , block("")
+      , carry("")
+      , blockOffset(offset)
+      , nextLine(0)
+  { }
+
+
+  bool BlockReader::refill(void)
+  {
+    blockOffset += block.size();
+    block.swap(carry);
+    carry.clear();
+
+    while (in.good())
+    {
+      std::size_t at = block.size();
+      block.resize(at + SCAN_BLOCK);
+      in.read(&block[at], SCAN_BLOCK);
+      block.resize(at + in.gcount());
+
+      std::size_t cut = block.rfind(NL);
+      if (cut != std::string::npos && cut >= at && in.good())
+      {
+        carry.assign(block, cut + 1, std::string::npos);
+        block.resize(cut + 1);
+        break;
+      }
+    }
+
+    scanner.scan(block.data(), block.size());
+    nextLine = 0;
+    return ! (scanner.lines.empty());
+  }
+
+
+  bool BlockReader::next(void)
+  {
+    if (nextLine < scanner.lines.size())
+    {
+      nextLine++;
+      return true;
+    }
+    if (! (refill()) ) { return false; }
+    nextLine++;
+    return true;
+  }
+
+
+  void dumpTokens(std::istream &in, std::ostream &out)
+  {
+    BlockReader reader(in, 0);
+    int lineNo = 0;
+    while (reader.next())
+    {
+      const ScannedLine &line = reader.line();
+      const TokenSpan *tokens = reader.lineTokens();
+      out << ++lineNo << ':';
+      for (std::uint32_t t = 0; t < line.numTokens; t++)
+      {
+        out << ' ';
+        out.write(reader.data() + tokens[t].start, tokens[t].end - tokens[t].start);
+      }
+      out << '\n';
+    }
+  }
+};
@@ -0,0 +1,235 @@
+/* All  main documentaion is in header files
+ * for corresponding cpp files.
+ * */
+#include <algorithm>
+#include <iomanip>
+#include "../hdr/search.hpp"
+#include "../hdr/trace.hpp"
+#include "../hdr/writer.hpp"
+
+
+StudentTrie::StudentTrie(const Container &c)
+{
+  entries.reserve(c.student.size() + c.wdr.size() + c.error.size());
+  const StudentVector *sections[] = { &c.student, &c.wdr, &c.error };
+  for (int s = GRADED_SECTION; s <= ERROR_SECTION; s++)
+  {
+    const StudentVector &v = *sections[s];
+    for (std::size_t i = 0; i < v.size(); i++)
+    {
+      entries.push_back({ &v[i].studentName(),
+          { static_cast<ContainerSection>(s), static_cast<int>(i) } });
+    }
+  }
+
+  /* equal ids keep the graded, withdrawn, error order */
+  std::stable_sort(entries.begin(), entries.end(),
+      [](const Entry &a, const Entry &b) { return *a.id < *b.id; });
+
+  if (! (entries.empty()) )
+  {
+    nodes.resize(1);
+    build(0, 0, entries.size(), 0);
+  }
+}
+
+
+void StudentTrie::build(std::uint32_t at, std::uint32_t lo, std::uint32_t hi, std::uint32_t depth)
+{
+  /* the range is sorted, so the first and last id bound its common prefix */
+  const std::string &first = *entries[lo].id;
+  const std::string &last = *entries[hi - 1].id;
+  std::uint32_t end = depth;
+  while (end < first.size() && end < last.size() && first[end] == last[end])
+  {
+    end++;
+  }
+
+  /* one child per distinct next character, ids ending here sort first */
+  std::vector<std::uint32_t> groups;
+  std::uint32_t i = lo;
+  while (i < hi && entries[i].id->size() == end) { i++; }
+  while (i < hi)
+  {
+    groups.push_back(i);
+    char next = (*entries[i].id)[end];
+    while (i < hi && (*entries[i].id)[end] == next) { i++; }
+  }
+  groups.push_back(hi);
+
+  std::uint32_t numChildren = groups.size() - 1;
+  std::uint32_t firstChild = nodes.size();
+  nodes[at] = { lo, hi, depth, end, firstChild, numChildren };
+
+  /* children are laid out next to each other before any is filled */
+  nodes.resize(nodes.size() + numChildren);
+  for (std::uint32_t g = 0; g < numChildren; g++)
+  {
+    build(firstChild + g, groups[g], groups[g + 1], end);
+  }
+}
+
+
+std::uint32_t StudentTrie::terminalEnd(std::uint32_t node) const
+{
+  std::uint32_t i = nodes[node].lo;
+  while (i < nodes[node].hi && entries[i].id->size() == nodes[node].end) { i++; }
+  return i;
+}
+
+
+void StudentTrie::collect(std::uint32_t lo, std::uint32_t hi, std::vector<StudentMatch> &out) const
+{
+  for (std::uint32_t i = lo; i < hi; i++)
+  {
+    out.push_back(entries[i].match);
+  }
+}
+
+
+void StudentTrie::prefixSearch(const std::string &prefix, std::vector<StudentMatch> &out) const
+{
+  if (nodes.empty()) { return; }
+
+  std::uint32_t node = 0;
+  while (true)
+  {
+    const Node &n = nodes[node];
+    const std::string &k = key(node);
+    for (std::uint32_t d = n.depth; d < n.end && d < prefix.size(); d++)
+    {
+      if (k[d] != prefix[d]) { return; }
+    }
+    if (prefix.size() <= n.end)
+    {
+      collect(n.lo, n.hi, out);
+      return;
+    }
+
+    /* follow the child that starts with the next character */
+    std::uint32_t next = n.firstChild;
+    std::uint32_t stop = n.firstChild + n.numChildren;
+    while (next < stop && key(next)[n.end] != prefix[n.end]) { next++; }
+    if (next == stop) { return; }
+    node = next;
+  }
+}
+
+
+/* NOTE: Documentation
+ * Walk the trie one character at a time from (node, d),
+ * d being how many characters of the id are consumed,
+ * against query from qi. Until the one edit is used every
+ * step may also substitute, skip a query character, or
+ * skip an id character, after that only exact steps
+ * follow, so the walk stays narrow
+ * */
+void StudentTrie::fuzzy(std::uint32_t node, std::uint32_t d, const std::string &query,
+    std::size_t qi, bool edited, std::vector<std::uint32_t> &found) const
+{
+  const Node &n = nodes[node];
+
+  if (qi < query.size() && ! (edited) )
+  {
+    fuzzy(node, d, query, qi + 1, true, found);
+  }
+
+  auto step = [&](std::uint32_t target, char ch)
+  {
+    if (qi < query.size() && ch == query[qi])
+    {
+      fuzzy(target, d + 1, query, qi + 1, edited, found);
+    }
+    else if (! (edited) && qi < query.size())
+    {
+      fuzzy(target, d + 1, query, qi + 1, true, found);
+    }
+    if (! (edited) )
+    {
+      fuzzy(target, d + 1, query, qi, true, found);
+    }
+  };
+
+  if (d < n.end)
+  {
+    step(node, key(node)[d]);
+    return;
+  }
+
+  if (qi == query.size() && terminalEnd(node) > n.lo)
+  {
+    found.push_back(node);
+  }
+  for (std::uint32_t c = n.firstChild; c < n.firstChild + n.numChildren; c++)
+  {
+    step(c, key(c)[d]);
+  }
+}
+
+
+void StudentTrie::fuzzySearch(const std::string &query, std::vector<StudentMatch> &out) const
+{
+  if (nodes.empty()) { return; }
+
+  std::vector<std::uint32_t> found;
+  fuzzy(0, 0, query, 0, false, found);
+
+  /* an id can be reached by more than one edit */
+  std::sort(found.begin(), found.end(),
+      [this](std::uint32_t a, std::uint32_t b) { return nodes[a].lo < nodes[b].lo; });
+  found.erase(std::unique(found.begin(), found.end()), found.end());
+  for (auto node: found)
+  {
+    collect(nodes[node].lo, terminalEnd(node), out);
+  }
+}
+
+
+bool isPatternSearch(const std::string &name)
+{
+  return ! (name.empty()) && (name.back() == PREFIX_MARK || name.front() == FUZZY_MARK);
+}
+
+
+bool outputSearch(const Container &c, const std::string &name)
+{
+  TRACE_SCOPE("outputSearch");
+  StudentTrie trie(c);
+  std::vector<StudentMatch> matches;
+  if (name.back() == PREFIX_MARK)
+  {
+    trie.prefixSearch(name.substr(0, name.size() - 1), matches);
+  }
+  else
+  {
+    trie.fuzzySearch(name.substr(1), matches);
+  }
+
+  if (matches.empty())
+  {
+    outputNotFound(name);
+    return false;
+  }
+
+  std::cout << std::left << std::setw(10) << "Section";
+  outputHeader(std::cout);
+  for (const auto &m: matches)
+  {
+    std::cout << std::left << std::setw(10) << sectionNames[m.section];
+    if (m.section == GRADED_SECTION)
+    {
+      outputRow(c.student[m.index], std::cout);
+    }
+    else if (m.section == WDR_SECTION)
+    {
+      outputRow(c.wdr[m.index], std::cout);
+    }
+    else
+    {
+      const StudentData &s = c.error[m.index];
+      std::cout << std::left << std::setw(10) << s.studentName()
+        << s.errorDefinition() << " (line " << s.lineCount() << ")" << std::endl;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,524 @@
+/* All  main documentaion is in header files
+ * for corresponding cpp files.
+ * */
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "../hdr/server.hpp"
+#include "../hdr/writer.hpp"
+
+
+/* Longest request line a client may send */
+#define SERVER_MAX_LINE 4096
+
+
+/* Serializes loads and the writers of each BookSlot snapshot
+ * */
+static std::mutex loadMutex;
+
+static volatile std::sig_atomic_t serverStopping = 0;
+
+static void stopServer(int) { serverStopping = 1; }
+
+
+/* NOTE: Documentation
+ * One served file. The current Gradebook is published
+ * whole on reload, readers never lock, see snapshot.hpp.
+ * The stamps are only touched by the watcher thread
+ * */
+struct BookSlot
+{
+  std::string file;
+  Snapshot<Gradebook> book;
+  long long pendingModified;
+  off_t pendingSize;
+  long long rejectedModified;
+  off_t rejectedSize;
+};
+
+using SlotVector = std::vector<std::unique_ptr<BookSlot>>;
+
+
+static bool fileStamp(const std::string &file, long long &modified, off_t &size)
+{
+  struct stat st;
+  if (stat(file.c_str(), &st) != 0)
+  {
+    return false;
+  }
+  modified = static_cast<long long>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+  size = st.st_size;
+  return true;
+}
+
+
+Gradebook::Gradebook(const std::string &_file)
+  : file(_file)
+    , eval(_file)
+    , modified(0)
+    , size(0)
+    , status(LOAD_OK)
+{
+  fileStamp(file, modified, size);
+
+  /* errorPrint has already said what is wrong with the header */
+  status = eval.loadEvaluationData();
+  if (status != LOAD_OK) { return; }
+  container.reset(new Container(countStudentLines(eval)));
+  status = loadStudentContainers(eval, *container);
+  if (status != LOAD_OK) { return; }
+  makeGrades(eval, *container);
+
+  /* Same precedence as searchStudent, the last match in the first
+   * section that has one, so the sections go in last to first and
+   * a later row overwrites an earlier one
+   * */
+  for (std::size_t i = 0; i < container->error.size(); i++)
+  {
+    index[container->error[i].studentName()] = std::make_pair(ERROR_SECTION, i);
+  }
+  for (std::size_t i = 0; i < container->wdr.size(); i++)
+  {
+    index[container->wdr[i].studentName()] = std::make_pair(WDR_SECTION, i);
+  }
+  for (std::size_t i = 0; i < container->student.size(); i++)
+  {
+    index[container->student[i].studentName()] = std::make_pair(GRADED_SECTION, i);
+  }
+}
+
+
+ThreadPool::ThreadPool(int numThreads, std::function<void(int)> _handler)
+  : stopping(false)
+    , handler(_handler)
+{
+  for (int i = 0; i < numThreads; i++)
+  {
+    workers.emplace_back(&ThreadPool::workerLoop, this);
+  }
+}
+
+
+ThreadPool::~ThreadPool(void)
+{
+  {
+    std::lock_guard<std::mutex> lock(jobsMutex);
+    stopping = true;
+  }
+  jobsReady.notify_all();
+
+  for (auto &w: workers) { w.join(); }
+
+  /* sockets that never reached a worker */
+  while (! (jobs.empty()) )
+  {
+    close(jobs.front());
+    jobs.pop();
+  }
+}
+
+
+void ThreadPool::submit(int job)
+{
+  {
+    std::lock_guard<std::mutex> lock(jobsMutex);
+    jobs.push(job);
+  }
+  jobsReady.notify_one();
+}
+
+
+void ThreadPool::workerLoop(void)
+{
+  while (true)
+  {
+    int job = 0;
+    {
+      std::unique_lock<std::mutex> lock(jobsMutex);
+      jobsReady.wait(lock, [this] { return stopping || !(jobs.empty()); });
+      if (stopping)
+      {
+        return;
+      }
+      job = jobs.front();
+      jobs.pop();
+    }
+    handler(job);
+  }
+}
+
+
+/* NOTE: Documentation
+ * Build a new version of the slots file off to the side
+ * and publish it, readers carry on with the old one until
+ * they finish. returns false if the header was rejected,
+ * the previous version stays published
+ * */
+static bool reloadBook(BookSlot &slot)
+{
+  std::lock_guard<std::mutex> lock(loadMutex);
+  std::unique_ptr<Gradebook> book(new Gradebook(slot.file));
+  if (book->status != LOAD_OK)
+  {
+    return false;
+  }
+  slot.book.publish(book.release());
+  return true;
+}
+
+
+static void watchBooks(SlotVector &slots)
+{
+  Colors color;
+  while (! (serverStopping) )
+  {
+    for (int waited = 0; waited < SERVER_POLL_MS && !(serverStopping); waited += 100)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    for (auto &slot: slots)
+    {
+      {
+        /* free the versions the readers have moved off */
+        std::lock_guard<std::mutex> lock(loadMutex);
+        slot->book.reclaim();
+      }
+
+      long long modified = 0;
+      off_t size = 0;
+      if (! (fileStamp(slot->file, modified, size)) ) { continue; }
+
+      bool unchanged = false;
+      {
+        SnapshotReader<Gradebook> book(slot->book);
+        unchanged = modified == book->modified && size == book->size;
+      }
+      if ( unchanged
+          || (modified == slot->rejectedModified && size == slot->rejectedSize) )
+      {
+        continue;
+      }
+
+      /* only reload once the file has stopped changing for a poll */
+      if (modified != slot->pendingModified || size != slot->pendingSize)
+      {
+        slot->pendingModified = modified;
+        slot->pendingSize = size;
+        continue;
+      }
+
+      if (! (reloadBook(*slot)) )
+      {
+        slot->rejectedModified = modified;
+        slot->rejectedSize = size;
+        std::cerr << color.BYellow << "Keeping previous version of: " << color.Reset
+          << color.BWhite << slot->file << color.Reset << std::endl;
+        continue;
+      }
+
+      std::cerr << color.BGreen << "Reloaded: " << color.Reset
+        << color.BWhite << slot->file << color.Reset << std::endl;
+    }
+  }
+}
+
+
+static BookSlot *findBook(SlotVector &slots, const std::string &name)
+{
+  for (auto &slot: slots)
+  {
+    std::size_t found = slot->file.find_last_of('/');
+    std::string base = (found == std::string::npos) ? slot->file : slot->file.substr(found + 1);
+    if (slot->file == name || base == name)
+    {
+      return slot.get();
+    }
+  }
+  return nullptr;
+}
+
+
+static void writeErrorEntry(const StudentData &s, std::ostream &out)
+{
+  out << "Error message: " << s.errorDefinition()
+    << "\nOffending line: " << s.lineCount()
+    << "\nOffending content: " << s.currentLineContent()
+    << "\n";
+}
+
+
+/* NOTE: Documentation
+ * Answer a single request line into out,
+ * returns false when the client asked to QUIT
+ * */
+static bool answerRequest(const std::string &line, SlotVector &slots, std::ostream &out)
+{
+  Utillity util;
+  std::stringstream ss(line);
+  std::string command("");
+  std::string bookName("");
+  std::string id("");
+  ss >> command >> bookName >> id;
+  command = util.convert_toupper(command);
+
+  out << std::fixed << std::setprecision(2);
+
+  if (command == "QUIT")
+  {
+    return false;
+  }
+
+  if (command == "LIST")
+  {
+    for (auto &slot: slots)
+    {
+      SnapshotReader<Gradebook> book(slot->book);
+      out << book->file << " " << book->container->student.size()
+        << " " << book->container->wdr.size()
+        << " " << book->container->error.size() << "\n";
+    }
+    return true;
+  }
+
+  if (command != "STUDENT" && command != "REPORT"
+      && command != "STATS" && command != "RELOAD")
+  {
+    out << "ERR unknown command: " << command << "\n";
+    return true;
+  }
+
+  BookSlot *slot = findBook(slots, bookName);
+  if (slot == nullptr)
+  {
+    out << "ERR gradebook not found: " << bookName << "\n";
+    return true;
+  }
+
+  if (command == "RELOAD")
+  {
+    if (reloadBook(*slot))
+    {
+      out << "OK reloaded " << slot->file << "\n";
+    }
+    else
+    {
+      out << "ERR header rejected, keeping previous version of " << slot->file << "\n";
+    }
+    return true;
+  }
+
+  /* the version we answer from stays valid even if a reload publishes meanwhile */
+  SnapshotReader<Gradebook> book(slot->book);
+  const Container &c = *(book->container);
+
+  if (command == "STUDENT")
+  {
+    auto found = book->index.find(id);
+    if (id.empty() || found == book->index.end())
+    {
+      out << "ERR " << StudentNotFound().what() << id << "\n";
+    }
+    else if (found->second.first == ERROR_SECTION)
+    {
+      out << "SECTION " << sectionNames[ERROR_SECTION] << "\n";
+      writeErrorEntry(c.error[found->second.second], out);
+    }
+    else
+    {
+      bool graded = found->second.first == GRADED_SECTION;
+      out << "SECTION " << sectionNames[found->second.first] << "\n";
+      outputHeader(out);
+      outputRow(graded ? c.student[found->second.second] : c.wdr[found->second.second], out);
+    }
+  }
+  else if (command == "REPORT")
+  {
+    if (c.student.size() > 0) { outputStudent(c, out); }
+    if (c.wdr.size() > 0) { outputWDR(c, out); }
+    for (const auto &s: c.error) { writeErrorEntry(s, out); }
+  }
+  else
+  {
+    outputStats(c, 1, out);
+  }
+
+  return true;
+}
+
+
+static bool sendAll(int fd, const std::string &data)
+{
+  std::size_t sent = 0;
+  while (sent < data.size())
+  {
+    ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) { continue; }
+    if (n <= 0) { return false; }
+    sent += n;
+  }
+  return true;
+}
+
+
+static void handleClient(int fd, SlotVector &slots)
+{
+  std::string buffer("");
+  char chunk[1024];
+  bool open = true;
+
+  while (open)
+  {
+    std::size_t newline = buffer.find('\n');
+    while (newline == std::string::npos)
+    {
+      ssize_t got = recv(fd, chunk, sizeof(chunk), 0);
+      if (got < 0 && errno == EINTR && !(serverStopping)) { continue; }
+      if (got <= 0 || buffer.size() > SERVER_MAX_LINE)
+      {
+        open = false;
+        break;
+      }
+      buffer.append(chunk, got);
+      newline = buffer.find('\n');
+    }
+    if (! (open) ) { break; }
+
+    std::string line = buffer.substr(0, newline);
+    buffer.erase(0, newline + 1);
+    if (!(line.empty()) && line.back() == '\r') { line.pop_back(); }
+    if (line.empty()) { continue; }
+
+    std::ostringstream response;
+    open = answerRequest(line, slots, response);
+    response << "END\n";
+    if (! (sendAll(fd, response.str())) ) { open = false; }
+  }
+}
+
+
+int runServer(const std::string &socketPath, const std::vector<std::string> &files)
+{
+  Colors color;
+
+  sockaddr_un address;
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (socketPath.size() >= sizeof(address.sun_path))
+  {
+    std::cerr << color.BRed << "*** Socket path is too long: " << color.Reset
+      << color.BWhite << socketPath << color.Reset << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+  /* Only a stale socket is ever replaced, never a file given by mistake */
+  struct stat st;
+  if (lstat(socketPath.c_str(), &st) == 0 && ! (S_ISSOCK(st.st_mode)) )
+  {
+    std::cerr << color.BRed << "*** Not a socket, refusing to replace: " << color.Reset
+      << color.BWhite << socketPath << color.Reset << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  SlotVector slots;
+  for (const auto &file: files)
+  {
+    std::unique_ptr<BookSlot> slot(new BookSlot);
+    slot->file = file;
+    std::unique_ptr<Gradebook> book(new Gradebook(file));
+    if (book->status != LOAD_OK)
+    {
+      return EXIT_FAILURE;
+    }
+    slot->book.publish(book.release());
+    slot->pendingModified = slot->rejectedModified = -1;
+    slot->pendingSize = slot->rejectedSize = -1;
+    slots.emplace_back(std::move(slot));
+  }
+
+  int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listenFd < 0)
+  {
+    perror("socket");
+    return EXIT_FAILURE;
+  }
+
+  /* A socket file nobody answers on is left over from a previous run */
+  if (connect(listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0)
+  {
+    std::cerr << color.BRed << "*** Another grader is already serving: " << color.Reset
+      << color.BWhite << socketPath << color.Reset << std::endl;
+    close(listenFd);
+    return EXIT_FAILURE;
+  }
+  close(listenFd);
+  if (lstat(socketPath.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) { unlink(socketPath.c_str()); }
+
+  listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listenFd < 0
+      || bind(listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0
+      || listen(listenFd, 64) != 0)
+  {
+    perror(socketPath.c_str());
+    return EXIT_FAILURE;
+  }
+
+  std::signal(SIGINT, stopServer);
+  std::signal(SIGTERM, stopServer);
+  std::signal(SIGPIPE, SIG_IGN);
+
+  std::cerr << color.BGreen << "Serving " << slots.size() << " gradebook(s) on: "
+    << color.Reset << color.BWhite << socketPath << color.Reset << std::endl;
+
+  /* open clients, so shutdown can wake the workers blocked on them */
+  std::mutex clientsMutex;
+  std::set<int> clients;
+
+  {
+    ThreadPool pool(SERVER_THREADS, [&](int fd)
+        {
+          {
+            std::lock_guard<std::mutex> lock(clientsMutex);
+            if (serverStopping) { close(fd); return; }
+            clients.insert(fd);
+          }
+          handleClient(fd, slots);
+          {
+            std::lock_guard<std::mutex> lock(clientsMutex);
+            clients.erase(fd);
+          }
+          close(fd);
+        });
+    std::thread watcher(watchBooks, std::ref(slots));
+
+    while (! (serverStopping) )
+    {
+      pollfd listener = { listenFd, POLLIN, 0 };
+      if (poll(&listener, 1, 250) > 0 && (listener.revents & POLLIN))
+      {
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd >= 0) { pool.submit(fd); }
+      }
+    }
+
+    close(listenFd);
+    unlink(socketPath.c_str());
+    {
+      std::lock_guard<std::mutex> lock(clientsMutex);
+      for (int fd: clients) { shutdown(fd, SHUT_RDWR); }
+    }
+    watcher.join();
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,175 @@
+/* All  main documentaion is in header files
+ * for corresponding cpp files.
+ * */
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include "../hdr/stream.hpp"
+#include "../hdr/trace.hpp"
+
+
+RowSpool::RowSpool(void)
+  : file(std::tmpfile())
+    , rows(0)
+{ }
+
+
+RowSpool::~RowSpool(void)
+{
+  if (file != nullptr) { std::fclose(file); }
+}
+
+
+bool RowSpool::good(void) const { return file != nullptr; }
+
+
+/* NOTE: Documentation
+ * A spooled string is a u32 length then the bytes
+ * */
+static void spoolString(std::FILE *file, const std::string &s)
+{
+  std::uint32_t length = s.size();
+  std::fwrite(&length, sizeof(length), 1, file);
+  std::fwrite(s.data(), 1, length, file);
+}
+
+
+static std::string readString(std::FILE *file)
+{
+  std::uint32_t length = 0;
+  std::string s("");
+  if (std::fread(&length, sizeof(length), 1, file) == 1)
+  {
+    s.resize(length);
+    if (std::fread(&s[0], 1, length, file) != length) { s.clear(); }
+  }
+  return s;
+}
+
+
+void RowSpool::spool(const StudentData &s)
+{
+  std::int32_t line = s.lineCount();
+  std::fwrite(&line, sizeof(line), 1, file);
+  spoolString(file, s.studentName());
+  spoolString(file, s.studentLetterGrade());
+  spoolString(file, s.errorDefinition());
+  spoolString(file, s.currentLineContent());
+  rows++;
+}
+
+
+void RowSpool::replay(OutputWriter &writer, ContainerSection section)
+{
+  std::rewind(file);
+  for (long r = 0; r < rows; r++)
+  {
+    std::int32_t line = 0;
+    if (std::fread(&line, sizeof(line), 1, file) != 1) { break; }
+    std::string name = readString(file);
+    std::string letter = readString(file);
+    std::string errorDef = readString(file);
+    std::string content = readString(file);
+
+    /* rebuild just what the writers read */
+    StudentData stu;
+    stu.setLineCount(line);
+    stu.setStudentName(name);
+    stu.setCurrentLineContent(content);
+    if (section == ERROR_SECTION)
+    {
+      stu.errorPreserve(errorDef);
+      writer.writeError(stu);
+    }
+    else
+    {
+      stu.setStudentWDR(true);
+      stu.setStudentLetterGrade(letter);
+      writer.writeWDR(stu);
+    }
+  }
+}
+
+
+/* NOTE: Documentation
+ * Grade and write out the students held in the window,
+ * then empty it for the next one
+ * */
+static void gradeWindow(EvaluationData &e, Container &c, OutputWriter &writer)
+{
+  if (c.student.empty()) { return; }
+
+  /* Use a precision stream to round grades to hundreths place */
+  std::cout << std::fixed << std::setprecision(2);
+  makeGrades(e, c, &writer);
+  c.student.clear();
+}
+
+
+bool streamGrades(EvaluationData &e, OutputWriter &writer, int window)
+{
+  TRACE_SCOPE("streamGrades");
+  std::unique_ptr<std::istream> input = e.openInput();
+  std::istream &inFile = *input;
+  if (! (inFile.good()) )
+  {
+    e.evaluationDiagnostics() << "*** File Not Found: " << e.evaluationFile() << std::endl;
+    return false;
+  }
+  inFile.seekg(e.currentFilePosition());
+
+  RowSpool wdr;
+  RowSpool error;
+  if (! (wdr.good() && error.good()) )
+  {
+    e.evaluationDiagnostics() << "Could not create a spool file" << std::endl;
+    return false;
+  }
+
+  /* sizing the filter costs one quick pass over the file */
+  DuplicateFilter seen(e.openInput(), countStudentLines(e));
+  Container c(window);
+
+  writer.begin();
+
+  BlockReader reader(inFile, e.currentFilePosition());
+  while (reader.next())
+  {
+    e.setFileLineCount(1);
+    if (reader.line().start == reader.line().end)
+    {
+      continue;
+    }
+
+    /* A duplicate line is dropped, as loadStudentContainers does */
+    StudentData stu;
+    if (! (stu.loadStudent(reader, e, seen)) )
+    {
+      continue;
+    }
+
+    if (stu.studentError())
+    {
+      error.spool(stu);
+    }
+    else if (stu.studentWDR())
+    {
+      stu.setStudentLetter(LETTER_WITHDRAWN);
+      wdr.spool(stu);
+    }
+    else
+    {
+      c.student.emplace_back(std::move(stu));
+      if (static_cast<int>(c.student.size()) == window)
+      {
+        gradeWindow(e, c, writer);
+      }
+    }
+  }
+  gradeWindow(e, c, writer);
+
+  wdr.replay(writer, WDR_SECTION);
+  error.replay(writer, ERROR_SECTION);
+  writer.finish();
+  return true;
+}
@@ -4,184 +4,118 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#if defined(__x86_64__)
+#include <emmintrin.h>
+#endif
 #include "../hdr/student.hpp"
 
 
 namespace GraderApplication
 {
+  /* bits of StudentData::status */
+  static const std::uint8_t STATUS_WDR = 1;
+  static const std::uint8_t STATUS_ERROR = 2;
+
+
+  /* what a row without cold text reads back */
+  static const std::string noText("");
+
+
+  const std::string &letterGradeText(LetterGrade letter)
+  {
+    static const Echelon e;
+    static const std::string names[LETTER_COUNT] = {
+      "",
+      e.high_A, e.mid_A, e.low_A,
+      e.high_B, e.mid_B, e.low_B,
+      e.high_C, e.mid_C, e.low_C,
+      e.D, e.F,
+      "WITHDRAWN",
+      "Grade went wrong"
+    };
+    return names[letter];
+  }
+
+
   StudentData::StudentData(void)
-    : name ("")
-      , studentDataLen(0)
-      , labScore (0.0)
+    : labScore (0.0)
       , assignScore (0.0)
       , midtermScore (0.0)
       , finalScore (0.0)
       , totalGrade (0.0)
-      , letterGrade ("")
-      , isWDR (false)
-      , isError (false)
-      , errorDef ("")
       , mlineCount(0)
+      , studentDataLen(0)
+      , letter(LETTER_NONE)
+      , status(0)
+      , name ("")
+  { }
 
-  {
-    /* Initialize the vectors */
-    gradesContainer.reserve(1);
-    calculatedGradesContainer.reserve(1);
-  }
 
+  StudentData::~StudentData(void) = default;
 
-  StudentData::~StudentData(void)
-  {
-    gradesContainer.clear();
-    calculatedGradesContainer.clear();
-  }
 
+  StudentData::StudentData(StudentData &&src) noexcept = default;
 
-  StudentData::StudentData(StudentData &&src) noexcept 
-    : Utillity(src)
-      , name(src.name)
-      , gradesContainer(std::move(src).gradesContainer)
-      , calculatedGradesContainer(std::move(src).calculatedGradesContainer)
-      , studentDataLen(src.studentDataLen)
-      , labScore(src.labScore)
-      , assignScore(src.assignScore)
-      , midtermScore(src.midtermScore)
-      , finalScore(src.finalScore)
-      , totalGrade(src.totalGrade)
-      , letterGrade(src.letterGrade)
-      , isWDR(src.isWDR)
-      , isError(src.isError)
-      , errorDef(src.errorDef)
-      , mlineCount(src.mlineCount)
 
-    {
-      /* Curent line is from derived class*/
-      currentLine = src.currentLine;
-      /* Reset the original object b
-       * ecause ownership has moved */
-      src.currentLine = "";
-      src.name = "";
-      src.gradesContainer.clear();
-      src.calculatedGradesContainer.clear();
-      src.studentDataLen = 0;
-      src.labScore = 0.0;
-      src.assignScore = 0.0;
-      src.midtermScore = 0.0;
-      src.finalScore = 0.0;
-      src.totalGrade = 0.0;
-      src.letterGrade = 0.0;
-      src.isWDR = false;
-      src.isError = false;
-      src.errorDef = "";
-      src.mlineCount = 0;
-    }
+  StudentData& StudentData::operator=(StudentData&& src) noexcept = default;
 
 
-  StudentData::StudentData(const StudentData &src) 
+  StudentData::StudentData(const StudentData &src)
     : Utillity(src)
-      , name(src.name)
-      , gradesContainer(src.gradesContainer)
-      , calculatedGradesContainer(src.calculatedGradesContainer)
-      , studentDataLen(src.studentDataLen)
       , labScore(src.labScore)
       , assignScore(src.assignScore)
       , midtermScore(src.midtermScore)
       , finalScore(src.finalScore)
       , totalGrade(src.totalGrade)
-      , letterGrade(src.letterGrade)
-      , isWDR(src.isWDR)
-      , isError(src.isError)
-      , errorDef(src.errorDef)
       , mlineCount(src.mlineCount)
-
-  {
-    currentLine = src.currentLine;
-  }
+      , studentDataLen(src.studentDataLen)
+      , letter(src.letter)
+      , status(src.status)
+      , name(src.name)
+      , gradesContainer(src.gradesContainer)
+      , fixedGradesContainer(src.fixedGradesContainer)
+      , exemptBits(src.exemptBits)
+      , calculatedGradesContainer(src.calculatedGradesContainer)
+      , text(src.text ? new StudentText(*src.text) : nullptr)
+  { }
 
 
   StudentData& StudentData::operator=(const StudentData &src)
   {
-    /* pessimistic check for self assignment */
-    if (this == &src)
+    /* copy into a temporary then move it in, so a copy
+     * that throws leaves this one as it was
+     * */
+    if (this != &src)
     {
-      return *this;
+      StudentData copy(src);
+      *this = std::move(copy);
     }
-
-    currentLine = src.currentLine;
-    name = src.name;
-    gradesContainer = src.gradesContainer;
-    calculatedGradesContainer = src.calculatedGradesContainer;
-    studentDataLen = src.studentDataLen;
-    labScore = src.labScore;
-    assignScore = src.labScore;
-    midtermScore = src.midtermScore;
-    finalScore = src.finalScore;
-    totalGrade = src.totalGrade;
-    letterGrade = src.letterGrade;
-    isWDR = src.isWDR;
-    isError = src.isWDR;
-    errorDef = src.errorDef;
-    mlineCount = src.mlineCount;
-
     return *this;
   }
 
 
-  StudentData& StudentData::operator=(StudentData&& src) noexcept
+  StudentText &StudentData::studentText(void)
   {
-    /* pessimistic check for self assignment */
-    if (this == &src)
-    {
-      return *this;
-    }
-    /* Init move */
-    currentLine = src.currentLine;
-    name = src.name;
-    gradesContainer = std::move(src).gradesContainer;
-    calculatedGradesContainer = std::move(src).calculatedGradesContainer;
-    studentDataLen = src.studentDataLen;
-    labScore = src.labScore;
-    assignScore = src.labScore;
-    midtermScore = src.midtermScore;
-    finalScore = src.finalScore;
-    totalGrade = src.totalGrade;
-    letterGrade = src.letterGrade;
-    isWDR = src.isWDR;
-    isError = src.isWDR;
-    errorDef = src.errorDef;
-    mlineCount = src.mlineCount;
-
-    /* Reset the original object because ownership has moved */
-    src.name = "";
-    src.gradesContainer.clear();
-    src.calculatedGradesContainer.clear();
-    src.studentDataLen = 0;
-    src.labScore = 0.0;
-    src.assignScore = 0.0;
-    src.midtermScore = 0.0;
-    src.finalScore = 0.0;
-    src.totalGrade = 0.0;
-    src.letterGrade = 0.0;
-    src.isWDR = false;
-    src.isError = false;
-    src.errorDef = "";
-    src.mlineCount = 0;
-
-    return *this;
+    if (! (this->text) ) { this->text.reset(new StudentText); }
+    return *this->text;
   }
 
 
   void StudentData::errorPreserve(std::string &e)
   {
-    /* The offending line data will have already been set
-     * in the loadStudent method with currentLine
+    /* loadStudent keeps the offending line once
+     * the whole row has been parsed
      * */
     this->setStudentError(true);
     this->setErrorDefinition(e);
   }
 
 
-  std::string StudentData::studentName(void) const { return this->name; }
+  const std::string &StudentData::studentName(void) const { return this->name; }
 
 
   void StudentData::setStudentName(std::string &_name)
@@ -205,43 +139,173 @@ namespace GraderApplication
   }
 
 
-  float StudentData::studentGradesContainer(int &itr) { return this->gradesContainer[itr]; }
+  float StudentData::studentGradesContainer(int itr) const { return this->gradesContainer[itr]; }
+
+
+  const float *StudentData::studentGrades(void) const { return this->gradesContainer.data(); }
+
 
+  std::int64_t StudentData::studentFixedGrade(int itr) const { return this->fixedGradesContainer[itr]; }
 
-  void StudentData::setStudentGradesContainer(std::string &_grade, EvaluationData &eval)
+
+  bool StudentData::studentExempt(int itr) const
   {
-    try
+    std::size_t word = itr / 64;
+    return word < this->exemptBits.size() && ((this->exemptBits[word] >> (itr % 64)) & 1);
+  }
+
+
+  const std::uint64_t *StudentData::studentExemptBits(void) const
+  {
+    return this->exemptBits.empty() ? nullptr : this->exemptBits.data();
+  }
+
+
+  /* digits and '.' only, as isDigits */
+  static bool isMarkToken(const char *p, std::size_t n)
+  {
+    for (std::size_t i = 0; i < n; i++)
     {
-      /* Check if string is infact a digit */
-      if (this->isDigits(_grade))
+      if ((p[i] < '0' || p[i] > '9') && p[i] != '.') { return false; }
+    }
+    return true;
+  }
+
+
+  /* Converts as stringTofloat would, without printing,
+   * a failure is reported later only if it was reached
+   * */
+  static bool markToFloat(const char *p, std::size_t n, float &mark)
+  {
+    char text[64];
+    std::string longer("");
+    const char *s = text;
+    if (n < sizeof(text))
+    {
+      std::memcpy(text, p, n);
+      text[n] = '\0';
+    }
+    else
+    {
+      longer.assign(p, n);
+      s = longer.c_str();
+    }
+
+    char *end = nullptr;
+    mark = std::strtof(s, &end);
+    if (end == s)
+    {
+      mark = 0;
+      return false;
+    }
+    if (mark == std::numeric_limits<float>::infinity())
+    {
+      mark = std::numeric_limits<float>::max();
+      return false;
+    }
+    return true;
+  }
+
+
+  /* index of the first mark over its max, or n */
+  static int firstMarkAboveMax(const float *marks, const float *maxMarks, int n)
+  {
+    int i = 0;
+#if defined(__x86_64__)
+    for (; i + 4 <= n; i += 4)
+    {
+      __m128i over = _mm_castps_si128(_mm_cmpgt_ps(_mm_loadu_ps(marks + i), _mm_loadu_ps(maxMarks + i)));
+      int mask = _mm_movemask_ps(_mm_castsi128_ps(over));
+      if (mask != 0) { return i + __builtin_ctz(mask); }
+    }
+#endif
+    for (; i < n; i++)
+    {
+      if (marks[i] > maxMarks[i]) { return i; }
+    }
+    return n;
+  }
+
+
+  void StudentData::setStudentGradesContainer(const char *data, const TokenSpan *marks,
+      std::uint32_t numMarks, EvaluationData &eval)
+  {
+    /* One pass over the tokens: convert every mark up to the
+     * first token that is neither a number nor WDR, nothing
+     * after that one was ever looked at
+     * */
+    std::uint32_t badToken = numMarks;
+    int wdrAt = -1;
+    std::vector<int> unconverted;
+    this->gradesContainer.reserve(numMarks);
+    for (std::uint32_t t = 0; t < numMarks; t++)
+    {
+      const char *p = data + marks[t].start;
+      std::size_t n = marks[t].end - marks[t].start;
+      if (isMarkToken(p, n))
       {
-        float temp = stringTofloat(_grade);
-        this->gradesContainer.emplace_back(temp);
-        /* Check if a mark is larger than max mark */
-        int size = this->gradesContainer.size();
-        for (int i = 0; i < size; i++ )
-        {
-          if (this->gradesContainer[i] > eval.evaluationMaxMarkContainer(i)
-              && !(this->studentWDR()))
-          {
-            throw StudentMarkExceedsMaxMark();
-          }
-        }
+        float mark = 0;
+        if (! (markToFloat(p, n, mark)) ) { unconverted.push_back(this->gradesContainer.size()); }
+        this->gradesContainer.emplace_back(mark);
+        if (eval.evaluationFixedPoint()) { this->fixedGradesContainer.emplace_back(stringToFixed(p, n)); }
+        continue;
       }
 
-      else {
-        /* if it is not a digit, convert to uppercase and
-         * and check if it is WDR, if not throw error
-         * */
-        std::string n_grade = convert_toupper(_grade);
-        if (n_grade == WDRN)
-        {
-          this->setStudentWDR(true);
-        }
-        else
-        {
-          throw FailStringFloatConversion();
-        }
+      std::string grade(p, n);
+      grade = convert_toupper(grade);
+      if (grade == EXEMPT || grade == EXEMPT_SHORT)
+      {
+        /* an exempt column is a 0 that grading masks out */
+        std::size_t column = this->gradesContainer.size();
+        this->exemptBits.resize(std::max(this->exemptBits.size(), column / 64 + 1), 0);
+        this->exemptBits[column / 64] |= static_cast<std::uint64_t>(1) << (column % 64);
+        this->gradesContainer.emplace_back(0);
+        if (eval.evaluationFixedPoint()) { this->fixedGradesContainer.emplace_back(0); }
+        continue;
+      }
+      if (grade != WDRN)
+      {
+        badToken = t;
+        break;
+      }
+      if (wdrAt < 0) { wdrAt = this->gradesContainer.size(); }
+    }
+
+    /* Marks after a WDR are never checked against the max,
+     * and before it a mark's column is its token position
+     * */
+    const std::vector<float> &maxMarks = eval.evaluationMaxMarks();
+    int checked = wdrAt < 0 ? this->gradesContainer.size() : wdrAt;
+    checked = std::min<int>(checked, maxMarks.size());
+    int over = firstMarkAboveMax(this->gradesContainer.data(), maxMarks.data(), checked);
+
+    /* the marks a mark by mark check would have read */
+    if (over < checked)
+    {
+      this->gradesContainer.resize(over + 1);
+      if (eval.evaluationFixedPoint()) { this->fixedGradesContainer.resize(over + 1); }
+    }
+    for (int i: unconverted)
+    {
+      if (i < static_cast<int>(this->gradesContainer.size()))
+      {
+        eval.evaluationDiagnostics() << StreamConversionFailure().what() << std::endl;
+      }
+    }
+
+    try
+    {
+      if (over < checked)
+      {
+        throw StudentMarkExceedsMaxMark();
+      }
+      if (wdrAt >= 0)
+      {
+        this->setStudentWDR(true);
+      }
+      if (badToken < numMarks)
+      {
+        throw FailStringFloatConversion();
       }
     }
     catch (FailStringFloatConversion &e)
@@ -262,10 +326,7 @@ namespace GraderApplication
 
   void StudentData::setCalculatedGrades(std::vector<float> &calcMarks)
   {
-    for (std::size_t i = 0; i < calcMarks.size(); ++i)
-    {
-      this->calculatedGradesContainer.emplace_back(calcMarks[i]);
-    }
+    this->calculatedGradesContainer.assign(calcMarks.begin(), calcMarks.end());
   }
 
 
@@ -299,68 +360,48 @@ namespace GraderApplication
 
   float StudentData::studentLabScore(void) const { return this->labScore; }
 
-  void StudentData::setStudentLabScore(float score)
+  bool StudentData::setStudentLabScore(float score)
   {
     /* bound check */
-    if (score < 0)
-    {
-      std::cerr << "Score: " << score << " is out of bounds" << std::endl;
-    }
-    else
-    {
-      this->labScore += score;
-    }
+    if (score < 0) { return false; }
+    this->labScore += score;
+    return true;
   }
 
 
   float StudentData::studentAssignScore(void) const { return this->assignScore; }
 
 
-  void StudentData::setStudentAssignScore(float score)
+  bool StudentData::setStudentAssignScore(float score)
   {
     /* bound check */
-    if (score < 0)
-    {
-      std::cerr << "Score: " << score << " is out of bounds" << std::endl;
-    }
-    else
-    {
-      this->assignScore += score;
-    }
+    if (score < 0) { return false; }
+    this->assignScore += score;
+    return true;
   }
 
 
   float StudentData::studentMidtermScore(void) const { return this->midtermScore; }
 
 
-  void StudentData::setStudentMidtermScore(float score)
+  bool StudentData::setStudentMidtermScore(float score)
   {
     /* bound check */
-    if (score < 0)
-    {
-      std::cerr << "Score: " << score << " is out of bounds" << std::endl;
-    }
-    else
-    {
-      this->midtermScore += score;
-    }
+    if (score < 0) { return false; }
+    this->midtermScore += score;
+    return true;
   }
 
 
   float StudentData::studentFinalScore(void) const { return this->finalScore; }
 
 
-  void StudentData::setStudentFinalScore(float score)
+  bool StudentData::setStudentFinalScore(float score)
   {
     /* bound check */
-    if (score < 0)
-    {
-      std::cerr << "Score: " << score << " is out of bounds" << std::endl;
-    }
-    else
-    {
-      this->finalScore += score;
-    }
+    if (score < 0) { return false; }
+    this->finalScore += score;
+    return true;
   }
 
 
@@ -370,36 +411,72 @@ namespace GraderApplication
   void StudentData::setStudentTotalGrade(const float _totalGrade) { this->totalGrade += _totalGrade; }
 
 
-  std::string StudentData::studentLetterGrade(void) const { return this->letterGrade; }
+  const std::string &StudentData::studentLetterGrade(void) const { return letterGradeText(this->letter); }
+
+
+  void StudentData::setStudentLetterGrade(const std::string &_letterGrade)
+  {
+    this->letter = LETTER_NONE;
+    for (int l = LETTER_NONE; l < LETTER_COUNT; l++)
+    {
+      if (letterGradeText(static_cast<LetterGrade>(l)) == _letterGrade)
+      {
+        this->letter = static_cast<LetterGrade>(l);
+        break;
+      }
+    }
+  }
+
+
+  LetterGrade StudentData::studentLetter(void) const { return this->letter; }
 
 
-  void StudentData::setStudentLetterGrade(const std::string &_letterGrade) { this->letterGrade = _letterGrade; }
+  void StudentData::setStudentLetter(LetterGrade _letter) { this->letter = _letter; }
 
 
-  bool StudentData::studentWDR(void) const { return this->isWDR; }
+  bool StudentData::studentWDR(void) const { return (this->status & STATUS_WDR) != 0; }
 
 
-  void StudentData::setStudentWDR(bool _isWDR) { this->isWDR = _isWDR; }
+  void StudentData::setStudentWDR(bool _isWDR)
+  {
+    this->status = _isWDR ? (this->status | STATUS_WDR) : (this->status & ~STATUS_WDR);
+  }
 
 
-  bool StudentData::studentError(void) const { return this->isError; }
+  bool StudentData::studentError(void) const { return (this->status & STATUS_ERROR) != 0; }
 
 
-  void StudentData::setStudentError(bool _isError) { this->isError = _isError; }
+  void StudentData::setStudentError(bool _isError)
+  {
+    this->status = _isError ? (this->status | STATUS_ERROR) : (this->status & ~STATUS_ERROR);
+  }
 
 
-  std::string StudentData::errorDefinition(void) const { return this->errorDef; }
+  const std::string &StudentData::errorDefinition(void) const
+  {
+    return this->text ? this->text->errorDef : noText;
+  }
 
 
-  void StudentData::setErrorDefinition(const std::string &e)
+  bool StudentData::setErrorDefinition(const std::string &e)
   {
-    if (! (e.empty()) )
-    {
-      this->errorDef = e;
-    }
-    else
+    if (e.empty()) { return false; }
+    this->studentText().errorDef = e;
+    return true;
+  }
+
+
+  const std::string &StudentData::currentLineContent(void) const
+  {
+    return this->text ? this->text->line : noText;
+  }
+
+
+  void StudentData::setCurrentLineContent(const std::string &_currentLine)
+  {
+    if (!(_currentLine.empty()))
     {
-      std::cerr << "\nError Definition is empty!\n" << std::endl;
+      this->studentText().line = _currentLine;
     }
   }
 
@@ -407,177 +484,82 @@ namespace GraderApplication
   int StudentData::lineCount(void) const { return this->mlineCount; }
 
 
-  void StudentData::setLineCount(int _count)
+  bool StudentData::setLineCount(int _count)
   {
-    if (_count > 0)
-    {
-      this->mlineCount = _count;
-    }
-    else
-    {
-      std::cerr << "\nLine count is less than 1" << std::endl;
-    }
+    if (_count < 1) { return false; }
+    this->mlineCount = _count;
+    return true;
   }
 
 
-  bool StudentData::loadStudents(EvaluationData &eval)
+  bool StudentData::loadStudent(const BlockReader &reader, EvaluationData &eval, DuplicateFilter &seen)
   {
+    const ScannedLine &line = reader.line();
+    const char *data = reader.data();
+    this->setLineCount(eval.fileLineCount());
+
     try
     {
-      std::ifstream datafile(eval.evaluationFile());
-      if ( datafile.is_open() )
+      /* the duplicate check is on the comment stripped line */
+      std::string stripped(data + line.start, line.comment - line.start);
+      if (seen.testAndInsert(stripped, reader.lineOffset()))
       {
-        datafile.seekg(eval.currentFilePosition());
-        std::string line("");
-        while ( std::getline(datafile, line))
-        {
-          // increment line count
-          eval.setFileLineCount(1);
-          this->setLineCount(eval.fileLineCount());
-
-          /* if the line is empty skip it,
-           * by immediatley restarting the
-           * control loop with the continue keyword
-           * */
-          if (line.empty())
-          {
-            continue;
-          }
-
-          this->setCurrentLineContent(line);
-          this->stripComments(line);
-
-          if (! (this->isStudentProcessed(line)) )
-          {
-            this->processStudent(line);
-
-            std::string sId("");
-            std::string sMarks("");
-
-            std::stringstream ss(line);
-            ss >> sId;
-            this->setStudentName(sId);
-            /* After trying to set the name, if it fails
-             * due to nonNumeric, we need to test that here
-             * so we can end this function and not read in the
-             * grades for the failed id.
-             * If the name setter failed it would have reported
-             * to errorPreserve which would have switched
-             * the isError variable to true, check for that here
-             * */
-
-            if (this->studentError())
-            {
-              eval.setCurrentFilePosition(datafile);
-              datafile.close();
-              return true;
-            }
-            else
-            {
-              int i = 0;
-              while (ss >> sMarks)
-              {
-                this->setStudentGradesContainer(sMarks, eval);
-                if (! (this->studentError()) )
-                {
-                  i++;
-                }
-                else
-                {
-                  /* Setting the grades failed */
-                  eval.setCurrentFilePosition(datafile);
-                  datafile.close();
-                  return true;
-                }
-              }
-
-              /* Set datalength checks if the length is the
-               * same as the evaluation data length */
-              this->setStudentDataLength(i, eval.evaluationDataLength());
-              // only process one line at a time, update file position
-              eval.setCurrentFilePosition(datafile);
-              datafile.close();
-              return true;
-            }
-          }
-          /* A duplicate student was found,
-           * throw for error preserving purposes
-           * */
-          eval.setCurrentFilePosition(datafile);
-          throw DuplicateFound();
-
-        }
-      }
-      else
-      {
-        throw std::logic_error("*** File Not Found: ");
+        /* A duplicate student was found,
+         * throw for error preserving purposes
+         * */
+        throw DuplicateFound();
       }
     }
-    catch (std::logic_error &e)
-    {
-      std::cerr << e.what() << eval.evaluationFile() << std::endl;
-      exit(EXIT_FAILURE);
-    }
     catch (DuplicateFound &e)
     {
       std::string onError(e.what());
       this->errorPreserve(onError);
+      return false;
     }
-    return false;
-  }
 
+    this->parseStudentTokens(data, reader.lineTokens(), line.numTokens, eval);
 
-  bool StudentData::isStudentProcessed(const std::string &lineToCompare)
-  {
-    bool isProcessed = false;
-    std::string tempLine("");
-    // test if the file exists
-    if ( this->testForFileExistence(TEMPFILE) )
+    /* only the rows reported with their text keep it */
+    if (this->studentError() || this->studentWDR())
     {
-      std::ifstream tempFile(TEMPFILE);
-      while ( std::getline(tempFile, tempLine) )
-      {
-        if ( lineToCompare == tempLine )
-        {
-          tempFile.close();
-          isProcessed = true;
-          return isProcessed;
-        }
-      }
+      this->setCurrentLineContent(std::string(data + line.start, line.end - line.start));
     }
-    // the file did not exist, which means
-    // this is the first student we are reading infile
-    return isProcessed;
+    return true;
   }
 
 
-  bool StudentData::testForFileExistence(const std::string &file)
+  void StudentData::parseStudentTokens(const char *data, const TokenSpan *tokens,
+      std::uint32_t numTokens, EvaluationData &eval)
   {
-    /* Test if grader has already created or temp file */
-    std::ifstream infile(file);
-    if ( infile.good() )
+    std::string sId("");
+    if (numTokens > 0)
     {
-      infile.close();
-      return true;
+      sId.assign(data + tokens[0].start, tokens[0].end - tokens[0].start);
     }
-    return false;
-  }
-
-
-  void StudentData::processStudent(const std::string &process)
-  {
-    /* only append to the file, dont trample over old data */
-    std::ofstream outFile(TEMPFILE, std::fstream::app);
-    if ( outFile.good() )
+    this->setStudentName(sId);
+    /* After trying to set the name, if it fails
+     * due to nonNumeric, we need to test that here
+     * so we can end this function and not read in the
+     * grades for the failed id.
+     * If the name setter failed it would have reported
+     * to errorPreserve which would have switched
+     * the error bit on, check for that here
+     * */
+    if (this->studentError())
     {
-      // write only the student id, which should be the first
-      // index of the line
-      outFile << process << std::endl;
-      outFile.close();
+      return;
     }
-    else
+
+    std::uint32_t numMarks = numTokens > 0 ? numTokens - 1 : 0;
+    this->setStudentGradesContainer(data, tokens + 1, numMarks, eval);
+    if (this->studentError())
     {
-      std::cerr << "Debug MSG: Could not open file to process student" << std::endl;
+      /* Setting the grades failed */
+      return;
     }
+
+    /* Set datalength checks if the length is the
+     * same as the evaluation data length, WDR counts */
+    this->setStudentDataLength(numMarks, eval.evaluationDataLength());
   }
 };
@@ -0,0 +1,143 @@
+/* All  main documentaion is in header files
+ * for corresponding cpp files.
+ * */
+#include "../hdr/trace.hpp"
+
+#if DEBUG
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+namespace GraderApplication
+{
+  /* a span, or a counter sample when phase is 'C' */
+  struct TraceEvent
+  {
+    const char *name;
+    char phase;
+    std::int64_t start;
+    std::int64_t value;
+  };
+
+
+  struct TraceBuffer
+  {
+    int tid;
+    std::vector<TraceEvent> events;
+  };
+
+
+  /* NOTE: Documentation
+   * Every thread's buffer is owned here, so the events of
+   * a thread that has finished are still written. The file
+   * is written when the state is destroyed at exit
+   * */
+  struct TraceState
+  {
+    const char *path;
+    std::chrono::steady_clock::time_point origin;
+    std::mutex lock;
+    std::vector<std::unique_ptr<TraceBuffer>> buffers;
+
+    TraceState(void)
+      : path(std::getenv(TRACE_ENV))
+        , origin(std::chrono::steady_clock::now())
+    { }
+
+    ~TraceState(void) { write(); }
+
+    void write(void);
+  };
+
+
+  static TraceState &traceState(void)
+  {
+    static TraceState state;
+    return state;
+  }
+
+
+  /* the calling thread's buffer, made on its first event */
+  static TraceBuffer &traceBuffer(void)
+  {
+    static thread_local TraceBuffer *local = nullptr;
+    if (local == nullptr)
+    {
+      TraceState &state = traceState();
+      std::lock_guard<std::mutex> hold(state.lock);
+      state.buffers.emplace_back(new TraceBuffer{ static_cast<int>(state.buffers.size()), { } });
+      local = state.buffers.back().get();
+      local->events.reserve(1024);
+    }
+    return *local;
+  }
+
+
+  bool TraceLog::enabled(void)
+  {
+    static const bool on = traceState().path != nullptr && *traceState().path != '\0';
+    return on;
+  }
+
+
+  std::int64_t TraceLog::now(void)
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - traceState().origin).count();
+  }
+
+
+  void TraceLog::span(const char *name, std::int64_t start, std::int64_t end)
+  {
+    traceBuffer().events.push_back({ name, 'X', start, end - start });
+  }
+
+
+  void TraceLog::counter(const char *name, std::int64_t value)
+  {
+    traceBuffer().events.push_back({ name, 'C', now(), value });
+  }
+
+
+  void TraceState::write(void)
+  {
+    if (path == nullptr || *path == '\0') { return; }
+    std::FILE *out = std::fopen(path, "w");
+    if (out == nullptr)
+    {
+      std::fprintf(stderr, "*** Could not write the trace: %s\n", path);
+      return;
+    }
+
+    /* times are in microseconds, a track is named after its thread */
+    const char *separator = "";
+    std::fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    for (const auto &buffer: buffers)
+    {
+      std::fprintf(out, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+          "\"args\":{\"name\":\"thread %d\"}}", separator, buffer->tid, buffer->tid);
+      separator = ",";
+      for (const auto &e: buffer->events)
+      {
+        if (e.phase == 'X')
+        {
+          std::fprintf(out, ",\n{\"name\":\"%s\",\"cat\":\"grader\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+              "\"ts\":%.3f,\"dur\":%.3f}", e.name, buffer->tid, e.start / 1000.0, e.value / 1000.0);
+        }
+        else
+        {
+          std::fprintf(out, ",\n{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,"
+              "\"args\":{\"value\":%lld}}", e.name, buffer->tid, e.start / 1000.0,
+              static_cast<long long>(e.value));
+        }
+      }
+    }
+    std::fprintf(out, "\n]}\n");
+    std::fclose(out);
+  }
+};
+
+#endif
@@ -1,74 +1,11 @@
 #include <algorithm>
-#include <iostream>
-#include <numeric>
 #include <sstream>
+#include "../hdr/reduce.hpp"
 #include "../hdr/utillity.hpp"
 
 namespace GraderApplication
 {
 
-  Utillity::Utillity(void)
-    : currentLine("")
-  { }
-
-
-  Utillity::Utillity(Utillity &&src) noexcept
-    : currentLine(src.currentLine)
-    {
-      /* Ownership has changed, reset original object */
-      src.currentLine = "";
-    }
-
-
-  Utillity::Utillity(const Utillity &src)
-    : currentLine(src.currentLine)
-  { }
-
-
-  Utillity& Utillity::operator=(Utillity &&src) noexcept
-  {
-    /* Pessimistic self assignment check */
-    if (this == &src)
-    {
-      return *this;
-    }
-
-    /* Move the member */
-    currentLine = src.currentLine;
-
-    /* reset old object, ownership has chaged */
-    src.currentLine = "";
-
-    return *this;
-  }
-
-
-  Utillity& Utillity::operator=(const Utillity &src)
-  {
-    /* Pessimistic self assignment check */
-    if (this == &src)
-    {
-      return *this;
-    }
-
-    currentLine = src.currentLine;
-
-    return *this;
-  }
-
-
-  std::string Utillity::currentLineContent(void) const { return this->currentLine; }
-
-
-  void Utillity::setCurrentLineContent(const std::string &_currentLine)
-  {
-    if (!(_currentLine.empty()))
-    {
-      this->currentLine = _currentLine;
-    }
-  }
-
-
   void Utillity::stripComments(std::string &line)
   {
     std::size_t found = line.find(COMM);
@@ -85,31 +22,46 @@ namespace GraderApplication
   }
 
 
-  float Utillity::stringTofloat(const std::string &s)
+  bool Utillity::stringTofloat(const std::string &s, float &value)
   {
-    float tempconvert = 0;
     std::stringstream streamVar(s);
-    try
+    streamVar >> value;
+    if (streamVar.fail())
     {
-      streamVar >> tempconvert;
-      if (streamVar.fail())
-      {
-        throw StreamConversionFailure();
-      }
+      value = 0;
+      return false;
     }
-    catch (StreamConversionFailure &e)
+    return true;
+  }
+
+
+  std::int64_t Utillity::stringToFixed(const char *s, std::size_t n)
+  {
+    /* anything past this many thousandths is not a mark */
+    const std::int64_t limit = static_cast<std::int64_t>(1) << 52;
+    std::int64_t whole = 0;
+    std::int64_t fraction = 0;
+    std::size_t i = 0;
+
+    for (; i < n && s[i] != '.'; i++)
     {
-      std::cerr << e.what() << std::endl;
+      whole = std::min(whole * 10 + (s[i] - '0'), limit);
     }
-    // will only return upon success
-    return tempconvert;
+    /* three decimals, then the fourth rounds */
+    int digits = 0;
+    for (i++; i < n && s[i] != '.' && digits < 4; i++, digits++)
+    {
+      fraction = fraction * 10 + (s[i] - '0');
+    }
+    for (; digits < 4; digits++) { fraction *= 10; }
+
+    return std::min(whole * FIXED_SCALE + (fraction + 5) / 10, limit);
   }
 
 
   float Utillity::vecSummation(std::vector<float> &s)
   {
-    float tempFinalGrade = 0;
-    return accumulate(s.begin(), s.end(), tempFinalGrade);
+    return deterministicSum(s.data(), s.size());
   }
 
 
@@ -0,0 +1,350 @@
+/* All  main documentaion is in header files
+ * for corresponding cpp files.
+ * */
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include "../hdr/whatif.hpp"
+
+
+/* Number of scenarios the kernel keeps in flight per student,
+ * small enough that the accumulators stay in L1
+ * */
+#define WHATIF_BLOCK 256
+
+/* Echelon has 11 grades that can be earned, WDR is never computed */
+#define NUM_LETTERS 11
+
+
+WhatIfScenarios::WhatIfScenarios(void)
+  : numScenarios(0)
+{ }
+
+
+/* NOTE: Documentation
+ * Same ranges as assignLetterGrade, but returns a position
+ * in the Echelon order so distributions can be counted
+ * without building a string per student per scenario
+ * */
+static int letterIndex(float grade)
+{
+  if      ( IS_A_PLUS(grade)  )  { return 0;  }
+  else if ( IS_A(grade)       )  { return 1;  }
+  else if ( IS_A_MINUS(grade) )  { return 2;  }
+  else if ( IS_B_PLUS(grade)  )  { return 3;  }
+  else if ( IS_B(grade)       )  { return 4;  }
+  else if ( IS_B_MINUS(grade) )  { return 5;  }
+  else if ( IS_C_PLUS(grade)  )  { return 6;  }
+  else if ( IS_C(grade)       )  { return 7;  }
+  else if ( IS_C_MINUS(grade) )  { return 8;  }
+  else if ( IS_D(grade)       )  { return 9;  }
+  else                           { return 10; }
+}
+
+
+static const char *letterName(int idx)
+{
+  Echelon echelon;
+  const char *names[NUM_LETTERS] = {
+    echelon.high_A, echelon.mid_A, echelon.low_A,
+    echelon.high_B, echelon.mid_B, echelon.low_B,
+    echelon.high_C, echelon.mid_C, echelon.low_C,
+    echelon.D, echelon.F
+  };
+  return names[idx];
+}
+
+
+static void outputDistribution(const std::vector<int> &counts)
+{
+  for (int l = 0; l < NUM_LETTERS; l++)
+  {
+    std::cout << std::left << std::setw(4) << letterName(l)
+      << std::left << std::setw(6) << counts[l];
+  }
+  std::cout << std::endl;
+}
+
+
+int loadWhatIfScenarios(EvaluationData &e, const std::string &file, WhatIfScenarios &w)
+{
+  std::ifstream inFile(file);
+  if (! (inFile.good()) )
+  {
+    Colors c;
+    std::cerr << c.BRed << "*** File Not Found: " << c.Reset << c.BWhite
+      << file << c.Reset << std::endl;
+    return 0;
+  }
+
+  int width = e.evaluationDataLength();
+  std::vector<std::vector<float>> rows;
+  std::string line("");
+  int lineCount = 0;
+
+  while (std::getline(inFile, line))
+  {
+    lineCount++;
+    std::string content(line);
+    e.stripComments(line);
+
+    std::stringstream ss(line);
+    std::string sTemp("");
+    std::vector<float> row;
+    row.reserve(width);
+    const char *fault = nullptr;
+
+    while (ss >> sTemp)
+    {
+      if (row.empty() && sTemp == WEIGHT) { continue; }
+
+      float mark = 0;
+      if (! (e.isDigits(sTemp) && e.stringTofloat(sTemp, mark)) )
+      {
+        fault = FailStringFloatConversion().what();
+        break;
+      }
+      row.emplace_back(mark);
+    }
+
+    /* nothing but a comment or the keyword on its own */
+    if (row.empty() && fault == nullptr) { continue; }
+
+    if (fault == nullptr && static_cast<int>(row.size()) != width)
+    {
+      fault = DataLength().what();
+    }
+    if (fault == nullptr && e.vecSummation(row) != 100)
+    {
+      fault = WeightSummation().what();
+    }
+
+    if (fault != nullptr)
+    {
+      Colors c;
+      std::cerr << c.BRed << "\nError message: " << c.Reset
+        << c.BWhite << fault << c.Reset
+        << c.BYellow << "\nOffending line: " << c.Reset
+        << c.BWhite << lineCount << c.Reset
+        << c.BYellow << "\nOffending content: " << c.Reset
+        << c.BWhite << content << c.Reset << std::endl;
+      continue;
+    }
+
+    rows.emplace_back(std::move(row));
+    w.labels.emplace_back(content);
+  }
+  inFile.close();
+
+  /* transpose into the column major layout the kernel wants */
+  int k = rows.size();
+  w.numScenarios = k;
+  w.weights.assign(static_cast<std::size_t>(width) * k, 0.0);
+  for (int s = 0; s < k; s++)
+  {
+    for (int j = 0; j < width; j++)
+    {
+      w.weights[j * k + s] = rows[s][j];
+    }
+  }
+
+  return k;
+}
+
+
+void computeWhatIfTotals(EvaluationData &e, const Container &c,
+    const WhatIfScenarios &w, std::vector<float> &totals)
+{
+  int n = c.student.size();
+  int m = e.evaluationDataLength();
+  int k = w.numScenarios;
+  totals.assign(static_cast<std::size_t>(n) * k, 0.0);
+
+  std::vector<float> maxMarks(m);
+  std::vector<int> group(m);
+  for (int j = 0; j < m; j++)
+  {
+    maxMarks[j] = e.evaluationMaxMarkContainer(j);
+    group[j] = e.evaluationColumnCategory(j);
+  }
+
+  /* DROP / BEST and EX renormalization depends on the scenario
+   * weights, so the per category factor is worked out per
+   * scenario, the marks that were dropped come from makeGrades'
+   * markMask and the exempt ones from the students bitmask
+   * */
+  int numPolicies = e.evaluationPolicyCount();
+  int numCategories = e.evaluationCategoryCount();
+  std::vector<float> categoryWeight(static_cast<std::size_t>(numCategories) * WHATIF_BLOCK);
+  std::vector<float> keptWeight(static_cast<std::size_t>(numCategories) * WHATIF_BLOCK);
+  std::vector<int> keptCount(numCategories);
+  std::vector<float> keep(m);
+  std::vector<float> factor(static_cast<std::size_t>(m) * WHATIF_BLOCK);
+
+  std::vector<float> marks(m);
+  float acc[WHATIF_BLOCK];
+
+  for (int sb = 0; sb < k; sb += WHATIF_BLOCK)
+  {
+    int bl = std::min(WHATIF_BLOCK, k - sb);
+    for (int i = 0; i < n; i++)
+    {
+      for (int j = 0; j < m; j++) { marks[j] = c.student[i].studentGradesContainer(j); }
+      const unsigned char *mask = numPolicies > 0
+        ? &c.markMask[static_cast<std::size_t>(i) * m] : nullptr;
+      const std::uint64_t *exempt = c.student[i].studentExemptBits();
+      bool renormalize = mask != nullptr || exempt != nullptr;
+
+      if (renormalize)
+      {
+        std::fill(categoryWeight.begin(), categoryWeight.end(), 0.0);
+        std::fill(keptWeight.begin(), keptWeight.end(), 0.0);
+        std::fill(keptCount.begin(), keptCount.end(), 0);
+        for (int j = 0; j < m; j++)
+        {
+          /* 1 for a kept mark, 0 for a dropped or exempt one */
+          std::uint32_t kept = mask != nullptr ? mask[j] : 1;
+          if (exempt != nullptr) { kept &= ~static_cast<std::uint32_t>(exempt[j >> 6] >> (j & 63)); }
+          keep[j] = kept & 1;
+          keptCount[group[j]] += kept & 1;
+
+          float *cw = &categoryWeight[group[j] * WHATIF_BLOCK];
+          float *kw = &keptWeight[group[j] * WHATIF_BLOCK];
+          const float *wRow = &w.weights[static_cast<std::size_t>(j) * k + sb];
+          for (int s = 0; s < bl; s++)
+          {
+            cw[s] += wRow[s];
+            kw[s] += keep[j] * wRow[s];
+          }
+        }
+
+        /* a category with nothing left hands its weight to the rest */
+        double total[WHATIF_BLOCK];
+        double kept[WHATIF_BLOCK];
+        for (int s = 0; s < bl; s++)
+        {
+          float all = 0.0;
+          float lost = 0.0;
+          for (int g = 0; g < numCategories; g++)
+          {
+            all += categoryWeight[g * WHATIF_BLOCK + s];
+            lost += keptCount[g] == 0 ? categoryWeight[g * WHATIF_BLOCK + s] : 0;
+          }
+          bool spread = lost > 0 && all > lost;
+          total[s] = spread ? all : 1.0;
+          kept[s] = spread ? all - lost : 1.0;
+        }
+
+        /* keptWeight becomes the scale for the kept marks, one rounding each */
+        for (int g = 0; g < numCategories; g++)
+        {
+          float *cw = &categoryWeight[g * WHATIF_BLOCK];
+          float *kw = &keptWeight[g * WHATIF_BLOCK];
+          for (int s = 0; s < bl; s++)
+          {
+            if (kw[s] <= 0) { kw[s] = 0; }
+            else if (total[s] == kept[s]) { kw[s] = cw[s] / kw[s]; }
+            else { kw[s] = (cw[s] * total[s]) / (kw[s] * kept[s]); }
+          }
+        }
+        for (int j = 0; j < m; j++)
+        {
+          const float *kw = &keptWeight[group[j] * WHATIF_BLOCK];
+          float *f = &factor[static_cast<std::size_t>(j) * WHATIF_BLOCK];
+          for (int s = 0; s < bl; s++) { f[s] = keep[j] * kw[s]; }
+        }
+      }
+
+      for (int s = 0; s < bl; s++) { acc[s] = 0.0; }
+
+      /* Same (mark * weight) / maxmark per column, summed left to right,
+       * as makeGrades so an unchanged WEIGHT line grades identically.
+       * The inner loop runs across scenarios and vectorizes, a
+       * dropped or exempt mark is multiplied by a 0 factor
+       * */
+      for (int j = 0; j < m; j++)
+      {
+        const float mark = marks[j];
+        const float mm = maxMarks[j];
+        const float *wRow = &w.weights[static_cast<std::size_t>(j) * k + sb];
+        if (! (renormalize) )
+        {
+          for (int s = 0; s < bl; s++)
+          {
+            acc[s] += (mark * wRow[s]) / mm;
+          }
+        }
+        else
+        {
+          const float *f = &factor[static_cast<std::size_t>(j) * WHATIF_BLOCK];
+          for (int s = 0; s < bl; s++)
+          {
+            acc[s] += ((mark * wRow[s]) / mm) * f[s];
+          }
+        }
+      }
+
+      /* rounding in the renormalization must not push full marks past the top */
+      if (renormalize)
+      {
+        for (int s = 0; s < bl; s++) { acc[s] = std::min(acc[s], static_cast<float>(MAX_GRADE)); }
+      }
+
+      float *out = &totals[static_cast<std::size_t>(i) * k + sb];
+      for (int s = 0; s < bl; s++) { out[s] = acc[s]; }
+    }
+  }
+}
+
+
+void outputWhatIf(const Container &c, const WhatIfScenarios &w,
+    const std::vector<float> &totals)
+{
+  int n = c.student.size();
+  int k = w.numScenarios;
+
+  std::vector<int> baseLetter(n);
+  std::vector<int> counts(NUM_LETTERS, 0);
+  for (int i = 0; i < n; i++)
+  {
+    baseLetter[i] = letterIndex(c.student[i].studentTotalGrade());
+    counts[baseLetter[i]]++;
+  }
+
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "Baseline" << std::endl;
+  outputDistribution(counts);
+
+  for (int s = 0; s < k; s++)
+  {
+    std::fill(counts.begin(), counts.end(), 0);
+    int changed = 0;
+    for (int i = 0; i < n; i++)
+    {
+      int l = letterIndex(totals[static_cast<std::size_t>(i) * k + s]);
+      counts[l]++;
+      if (l != baseLetter[i]) { changed++; }
+    }
+
+    std::cout << "\nScenario " << s + 1 << ": " << w.labels[s] << std::endl;
+    outputDistribution(counts);
+    std::cout << "Letter changes: " << changed << std::endl;
+
+    for (int i = 0; i < n && changed > 0; i++)
+    {
+      float total = totals[static_cast<std::size_t>(i) * k + s];
+      int l = letterIndex(total);
+      if (l != baseLetter[i])
+      {
+        std::cout << std::left << std::setw(10) << c.student[i].studentName()
+          << std::left << std::setw(10) << c.student[i].studentTotalGrade()
+          << std::left << std::setw(10) << letterName(baseLetter[i])
+          << std::left << std::setw(4) << "->"
+          << std::left << std::setw(10) << total
+          << std::left << std::setw(10) << letterName(l)
+          << std::endl;
+      }
+    }
+  }
+}
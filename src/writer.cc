@@ -0,0 +1,355 @@
+/* All  main documentaion is in header files
+ * for corresponding cpp files.
+ * */
+#include <charconv>
+#include <cstring>
+#include "../hdr/writer.hpp"
+
+
+const char *const sectionNames[] = { "graded", "wdr", "error" };
+
+
+static void writeFixed(std::ostream &out, float value)
+{
+  char buffer[48];
+  auto result = std::to_chars(buffer, buffer + sizeof(buffer), value,
+      std::chars_format::fixed, 2);
+  out.write(buffer, result.ptr - buffer);
+}
+
+
+static void writeInt(std::ostream &out, long value)
+{
+  char buffer[24];
+  auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  out.write(buffer, result.ptr - buffer);
+}
+
+
+static void writeCsvField(std::ostream &out, const std::string &field)
+{
+  if (field.find_first_of(",\"\r\n") == std::string::npos)
+  {
+    out.write(field.data(), field.size());
+    return;
+  }
+
+  /* quote, and double every quote inside */
+  out.put('"');
+  std::size_t start = 0;
+  for (std::size_t i = 0; i < field.size(); i++)
+  {
+    if (field[i] == '"')
+    {
+      out.write(field.data() + start, i + 1 - start);
+      out.put('"');
+      start = i + 1;
+    }
+  }
+  out.write(field.data() + start, field.size() - start);
+  out.put('"');
+}
+
+
+static void writeJsonString(std::ostream &out, const std::string &s)
+{
+  out.put('"');
+  std::size_t start = 0;
+  for (std::size_t i = 0; i < s.size(); i++)
+  {
+    unsigned char ch = s[i];
+    if (ch != '"' && ch != '\\' && ch >= 0x20)
+    {
+      continue;
+    }
+
+    out.write(s.data() + start, i - start);
+    start = i + 1;
+    switch (ch)
+    {
+      case '"':  out.write("\\\"", 2); break;
+      case '\\': out.write("\\\\", 2); break;
+      case '\t': out.write("\\t", 2);  break;
+      case '\r': out.write("\\r", 2);  break;
+      case '\n': out.write("\\n", 2);  break;
+      default:
+        {
+          char hex[7];
+          std::snprintf(hex, sizeof(hex), "\\u%04x", ch);
+          out.write(hex, 6);
+        }
+    }
+  }
+  out.write(s.data() + start, s.size() - start);
+  out.put('"');
+}
+
+
+/* NOTE: Documentation
+ * Position of a letter grade in the Echelon order,
+ * 11 for withdrawn and 255 when there is none. A+ to
+ * WITHDRAWN follow LETTER_NONE in LetterGrade, so it is
+ * one less than the enum
+ * */
+static std::uint8_t letterCode(LetterGrade letter)
+{
+  if (letter >= LETTER_A_PLUS && letter <= LETTER_WITHDRAWN) { return letter - LETTER_A_PLUS; }
+  return 255;
+}
+
+
+OutputWriter::OutputWriter(std::ostream &_out, std::ostream &_err)
+  : out(_out)
+    , err(_err)
+{ }
+
+
+OutputWriter::~OutputWriter(void) { }
+
+
+void OutputWriter::begin(void) { }
+
+
+void OutputWriter::finish(void) { out.flush(); }
+
+
+TableWriter::TableWriter(std::ostream &_out, std::ostream &_err)
+  : OutputWriter(_out, _err)
+    , headerDone(false)
+{ }
+
+
+void TableWriter::writeStudent(const StudentData &s)
+{
+  if (! (headerDone) )
+  {
+    outputHeader(out);
+    headerDone = true;
+  }
+  outputRow(s, out);
+}
+
+
+void TableWriter::writeWDR(const StudentData &s) { outputRow(s, out); }
+
+
+void TableWriter::writeError(const StudentData &s) { outputErrorEntry(s, err); }
+
+
+CsvWriter::CsvWriter(std::ostream &_out, std::ostream &_err)
+  : OutputWriter(_out, _err)
+{ }
+
+
+void CsvWriter::begin(void)
+{
+  out << "section,name,line,lab,assign,midterm,final,total,letter,error,content\n";
+}
+
+
+void CsvWriter::writeRow(const char *section, const StudentData &s)
+{
+  out << section;
+  out.put(',');
+  writeCsvField(out, s.studentName());
+  out.put(',');
+  writeInt(out, s.lineCount());
+
+  /* errors have no scores, only the message and the line */
+  bool isError = s.studentError();
+  const float scores[] = {
+    s.studentLabScore(), s.studentAssignScore(), s.studentMidtermScore(),
+    s.studentFinalScore(), s.studentTotalGrade()
+  };
+  for (float score: scores)
+  {
+    out.put(',');
+    if (! (isError) ) { writeFixed(out, score); }
+  }
+
+  out.put(',');
+  writeCsvField(out, s.studentLetterGrade());
+  out.put(',');
+  writeCsvField(out, s.errorDefinition());
+  out.put(',');
+  if (isError) { writeCsvField(out, s.currentLineContent()); }
+  out.put('\n');
+}
+
+
+void CsvWriter::writeStudent(const StudentData &s) { writeRow(sectionNames[GRADED_SECTION], s); }
+
+
+void CsvWriter::writeWDR(const StudentData &s) { writeRow(sectionNames[WDR_SECTION], s); }
+
+
+void CsvWriter::writeError(const StudentData &s) { writeRow(sectionNames[ERROR_SECTION], s); }
+
+
+JsonLinesWriter::JsonLinesWriter(std::ostream &_out, std::ostream &_err)
+  : OutputWriter(_out, _err)
+{ }
+
+
+void JsonLinesWriter::writeRow(const char *section, const StudentData &s)
+{
+  out << "{\"section\":\"" << section << "\",\"name\":";
+  writeJsonString(out, s.studentName());
+  out << ",\"line\":";
+  writeInt(out, s.lineCount());
+
+  if (s.studentError())
+  {
+    out << ",\"error\":";
+    writeJsonString(out, s.errorDefinition());
+    out << ",\"content\":";
+    writeJsonString(out, s.currentLineContent());
+  }
+  else
+  {
+    out << ",\"lab\":";
+    writeFixed(out, s.studentLabScore());
+    out << ",\"assign\":";
+    writeFixed(out, s.studentAssignScore());
+    out << ",\"midterm\":";
+    writeFixed(out, s.studentMidtermScore());
+    out << ",\"final\":";
+    writeFixed(out, s.studentFinalScore());
+    out << ",\"total\":";
+    writeFixed(out, s.studentTotalGrade());
+    out << ",\"letter\":";
+    writeJsonString(out, s.studentLetterGrade());
+  }
+  out << "}\n";
+}
+
+
+void JsonLinesWriter::writeStudent(const StudentData &s) { writeRow(sectionNames[GRADED_SECTION], s); }
+
+
+void JsonLinesWriter::writeWDR(const StudentData &s) { writeRow(sectionNames[WDR_SECTION], s); }
+
+
+void JsonLinesWriter::writeError(const StudentData &s) { writeRow(sectionNames[ERROR_SECTION], s); }
+
+
+ColumnarWriter::ColumnarWriter(std::ostream &_out, std::ostream &_err)
+  : OutputWriter(_out, _err)
+{
+  for (auto &o: offsets) { o.assign(1, 0); }
+}
+
+
+/* NOTE: Documentation
+ * Append values to a byte buffer in little endian
+ * order whatever the host is
+ * */
+static void putU32(std::string &buffer, std::uint32_t v)
+{
+  char bytes[4] = {
+    static_cast<char>(v & 0xff), static_cast<char>((v >> 8) & 0xff),
+    static_cast<char>((v >> 16) & 0xff), static_cast<char>((v >> 24) & 0xff)
+  };
+  buffer.append(bytes, 4);
+}
+
+
+static void putF32(std::string &buffer, float f)
+{
+  std::uint32_t v = 0;
+  std::memcpy(&v, &f, sizeof(v));
+  putU32(buffer, v);
+}
+
+
+void ColumnarWriter::begin(void)
+{
+  /* magic and version 1 */
+  out.write("GRDC\x01\x00", 6);
+}
+
+
+void ColumnarWriter::addRow(std::uint8_t _section, const StudentData &s)
+{
+  section.push_back(_section);
+  line.push_back(s.lineCount());
+  scores[0].push_back(s.studentLabScore());
+  scores[1].push_back(s.studentAssignScore());
+  scores[2].push_back(s.studentMidtermScore());
+  scores[3].push_back(s.studentFinalScore());
+  scores[4].push_back(s.studentTotalGrade());
+  letter.push_back(letterCode(s.studentLetter()));
+
+  const std::string *fields[3] = { &s.studentName(), &s.errorDefinition(), nullptr };
+  if (s.studentError()) { fields[2] = &s.currentLineContent(); }
+  for (int t = 0; t < 3; t++)
+  {
+    if (fields[t] != nullptr) { text[t].append(*fields[t]); }
+    offsets[t].push_back(text[t].size());
+  }
+
+  if (section.size() == COLUMNAR_GROUP) { flushGroup(); }
+}
+
+
+void ColumnarWriter::flushGroup(void)
+{
+  std::uint32_t rows = section.size();
+  if (rows == 0) { return; }
+
+  std::string group;
+  group.reserve(rows * 40);
+  putU32(group, rows);
+  group.append(reinterpret_cast<const char *>(section.data()), rows);
+  for (auto v: line) { putU32(group, v); }
+  for (auto &column: scores)
+  {
+    for (float f: column) { putF32(group, f); }
+  }
+  group.append(reinterpret_cast<const char *>(letter.data()), rows);
+  for (int t = 0; t < 3; t++)
+  {
+    for (auto v: offsets[t]) { putU32(group, v); }
+    group.append(text[t]);
+  }
+  out.write(group.data(), group.size());
+
+  section.clear();
+  line.clear();
+  for (auto &column: scores) { column.clear(); }
+  letter.clear();
+  for (int t = 0; t < 3; t++)
+  {
+    offsets[t].assign(1, 0);
+    text[t].clear();
+  }
+}
+
+
+void ColumnarWriter::writeStudent(const StudentData &s) { addRow(GRADED_SECTION, s); }
+
+
+void ColumnarWriter::writeWDR(const StudentData &s) { addRow(WDR_SECTION, s); }
+
+
+void ColumnarWriter::writeError(const StudentData &s) { addRow(ERROR_SECTION, s); }
+
+
+void ColumnarWriter::finish(void)
+{
+  flushGroup();
+  std::string end;
+  putU32(end, 0);
+  out.write(end.data(), end.size());
+  out.flush();
+}
+
+
+OutputWriter *makeWriter(const std::string &format, std::ostream &out, std::ostream &err)
+{
+  if (format == "table")    { return new TableWriter(out, err); }
+  if (format == "csv")      { return new CsvWriter(out, err); }
+  if (format == "jsonl")    { return new JsonLinesWriter(out, err); }
+  if (format == "columnar") { return new ColumnarWriter(out, err); }
+  return nullptr;
+}